@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <shellapi.h>
@@ -15,6 +16,7 @@
 
 #include <nlohmann/json.hpp>
 #include "notification.h"
+#include "profiler.h"
 
 #include "version.h"
 #include "bakkesmod/wrappers/GuiManagerWrapper.h"
@@ -68,276 +70,202 @@ static bool DownloadToFile(const std::wstring& url, const std::filesystem::path&
     return true;
 }
 
-static std::string FormatTimeSeconds(int seconds)
-{
-    if (seconds <= 0) return "0:00";
-    const int minutes = seconds / 60;
-    const int secs = seconds % 60;
+// ------------------------------------------------------------
+// RocketRhythm
+// ------------------------------------------------------------
 
-    char buf[16]{};
-    snprintf(buf, sizeof(buf), "%d:%02d", minutes, secs);
-    return std::string(buf);
-}
+RocketRhythm::RocketRhythm() = default;
 
-static bool IsValidImageFile(const std::string& path)
-{
-    try
-    {
-        std::ifstream f(path, std::ios::binary);
-        if (!f.is_open()) return false;
-        f.seekg(0, std::ios::end);
-        return f.tellg() > 100;
-    }
-    catch (...)
-    {
-        return false;
-    }
-}
+RocketRhythm::~RocketRhythm() = default;
 
-static nlohmann::json ImVec4ToJson(const ImVec4& c)
+void RocketRhythm::onLoad()
 {
-    return nlohmann::json::array({ c.x, c.y, c.z, c.w });
-}
+    _globalCvarManager = cvarManager;
 
-static bool JsonToImVec4(const nlohmann::json& j, ImVec4& out)
-{
-    if (!j.is_array() || j.size() != 4) return false;
-    for (int i = 0; i < 4; ++i)
-        if (!j[i].is_number()) return false;
-
-    out.x = j[0].get<float>();
-    out.y = j[1].get<float>();
-    out.z = j[2].get<float>();
-    out.w = j[3].get<float>();
-    return true;
-}
+    mMedia = CreateMediaController(gameWrapper->GetDataFolder().string());
+    mOverlay.SetDpiScaleSource([this] { return GetDpiScaleFactor(); });
 
-template <typename T>
-static void AssignIfNumberOrBool(const nlohmann::json& obj, const char* key, T& target)
-{
-    auto it = obj.find(key);
-    if (it == obj.end()) return;
+    mEnabled = std::make_shared<bool>(true);
+    mUiScaleCvar = std::make_shared<float>(1.0f);
 
-    if constexpr (std::is_same_v<T, bool>)
-    {
-        if (it->is_boolean()) target = it->get<bool>();
-    }
-    else
+    cvarManager->registerCvar("rr_enabled", "1", "Enable RocketRhythm").bindTo(mEnabled);
+    auto uiScale = cvarManager->registerCvar("rr_uiscale", "1.0", "UI Scale factor", true, true, 0.5f, true, 2.0f);
+    uiScale.bindTo(mUiScaleCvar);
+    uiScale.addOnValueChanged([this](std::string, CVarWrapper cvar)
     {
-        if (it->is_number())
+        mWindowStyle.uiScale = cvar.getFloatValue();
+        InvalidateLayoutMetrics();
+    });
+
+    cvarManager->registerCvar("rr_media_settle_ms", "40", "Media event debounce window (ms)", true, true, 0.0f, true, 500.0f)
+        .addOnValueChanged([this](std::string, CVarWrapper) { ApplyMediaRefreshWindows(); });
+    cvarManager->registerCvar("rr_media_max_latency_ms", "150", "Max delay of a debounced media event (ms)", true, true, 0.0f, true, 2000.0f)
+        .addOnValueChanged([this](std::string, CVarWrapper) { ApplyMediaRefreshWindows(); });
+    ApplyMediaRefreshWindows();
+
+    cvarManager->registerCvar("rr_art_cache_mb", "256", "Album art disk cache budget (MB)", true, true, 8.0f, true, 8192.0f)
+        .addOnValueChanged([this](std::string, CVarWrapper) { ApplyAlbumCacheBudget(); });
+    cvarManager->registerCvar("rr_art_cache_entries", "2000", "Album art disk cache entry limit", true, true, 16.0f, true, 100000.0f)
+        .addOnValueChanged([this](std::string, CVarWrapper) { ApplyAlbumCacheBudget(); });
+    ApplyAlbumCacheBudget();
+
+    cvarManager->registerCvar("rr_profile", "0", "Show per-frame profiler stats on the settings page", true, true, 0.0f, true, 1.0f)
+        .addOnValueChanged([](std::string, CVarWrapper cvar)
         {
-            const double v = it->get<double>();
-            target = static_cast<T>(v);
-        }
-    }
+            const bool enabled = cvar.getBoolValue();
+            if (enabled && !Profiler::IsEnabled()) Profiler::Reset();
+            Profiler::SetEnabled(enabled);
+        });
+
+    cvarManager->registerNotifier("rr_trace_start", [this](std::vector<std::string> args) { StartTrace(args); },
+        "Start a Chrome trace capture (optional: max events)", PERMISSION_ALL);
+    cvarManager->registerNotifier("rr_trace_stop", [this](std::vector<std::string>) { StopTrace(); },
+        "Stop the trace capture and write it to the RocketRhythm/traces folder", PERMISSION_ALL);
+    cvarManager->registerNotifier("rr_media_record_start", [this](std::vector<std::string>) { StartMediaRecording(); },
+        "Record media events/states to the RocketRhythm/recordings folder", PERMISSION_ALL);
+    cvarManager->registerNotifier("rr_media_record_stop", [this](std::vector<std::string>) { StopMediaRecording(); },
+        "Stop the media recording", PERMISSION_ALL);
+
+    LoadConfig();
+
+    gameWrapper->RegisterDrawable([this](const CanvasWrapper& canvas) { RenderCanvas(canvas); });
+
+    LOG("{} v{} loaded!", kPluginNameStr, plugin_version);
 }
 
-static void DrawPingPongMarqueeText(
-    const char* text,
-    const ImVec4& color,
-    float availableWidth,
-    float speedPxPerSec,
-    float waitTimeSec,
-    ImFont* font = nullptr
-)
+void RocketRhythm::onUnload()
 {
-    if (!text || !*text)
-    {
-        ImGui::Dummy(ImVec2(availableWidth, ImGui::GetTextLineHeight()));
-        return;
-    }
+    SaveConfig();
 
-    ImDrawList* dl = ImGui::GetWindowDrawList();
-    const ImVec2 pos = ImGui::GetCursorScreenPos();
-    const float lineH = ImGui::GetTextLineHeight();
+    // Joins the loader thread; whatever it still held is released here
+    mArtLoader.Stop();
+    mArtRetiring.clear();
+    mAlbumArtPrev.reset();
+    mAlbumArtTexture.reset();
+    mAlbumArtImage.reset();
+    mArtRequestImage.reset();
+    mArtRegistry.Clear();
+    mOverlay.Clear();
+    cvarManager->removeCvar("rr_enabled");
+    cvarManager->removeCvar("rr_uiscale");
+    cvarManager->removeCvar("rr_media_settle_ms");
+    cvarManager->removeCvar("rr_media_max_latency_ms");
+    cvarManager->removeCvar("rr_art_cache_mb");
+    cvarManager->removeCvar("rr_art_cache_entries");
+    cvarManager->removeCvar("rr_profile");
+    cvarManager->removeNotifier("rr_trace_start");
+    cvarManager->removeNotifier("rr_trace_stop");
+    cvarManager->removeNotifier("rr_media_record_start");
+    cvarManager->removeNotifier("rr_media_record_stop");
+    Profiler::SetEnabled(false);
+
+    // Flush a running capture; wait for the file so the writer can't outlive the DLL
+    Tracer::Stop();
+    Tracer::Shutdown();
 
-    // Reserve space for one line
-    ImGui::Dummy(ImVec2(availableWidth, lineH));
+    LOG("{} unloaded!", kPluginNameStr);
+}
 
-    const float textW = ImGui::CalcTextSize(text).x;
-    const float overflow = textW - availableWidth;
+void RocketRhythm::ApplyMediaRefreshWindows()
+{
+    if (!mMedia) return;
 
-    dl->PushClipRect(pos, ImVec2(pos.x + availableWidth, pos.y + lineH), true);
+    CVarWrapper settle = cvarManager->getCvar("rr_media_settle_ms");
+    CVarWrapper maxLatency = cvarManager->getCvar("rr_media_max_latency_ms");
+    if (!settle || !maxLatency) return;
 
-    if (font) ImGui::PushFont(font);
-    const ImU32 col = ImGui::GetColorU32(color);
+    mMedia->SetRefreshWindows(
+        std::chrono::milliseconds(settle.getIntValue()),
+        std::chrono::milliseconds(maxLatency.getIntValue()));
+}
 
-    if (overflow <= 0.0f || speedPxPerSec <= 0.0f)
-    {
-        dl->AddText(pos, col, text);
-    }
-    else
-    {
-        const float t = static_cast<float>(ImGui::GetTime());
-        const float moveTime = overflow / speedPxPerSec;
-
-        // cycle = wait -> move -> wait -> move back
-        const float cycle = waitTimeSec + moveTime + waitTimeSec + moveTime;
-        const float phase = fmodf(t, cycle);
-
-        float offset;
-        if (phase < waitTimeSec)
-            offset = 0.0f;
-        else if (phase < waitTimeSec + moveTime)
-            offset = (phase - waitTimeSec) * speedPxPerSec;
-        else if (phase < waitTimeSec + moveTime + waitTimeSec)
-            offset = overflow;
-        else
-            offset = overflow - (phase - (waitTimeSec + moveTime + waitTimeSec)) * speedPxPerSec;
+void RocketRhythm::ApplyAlbumCacheBudget()
+{
+    if (!mMedia) return;
 
-        dl->AddText(ImVec2(pos.x - offset, pos.y), col, text);
-    }
+    CVarWrapper megabytes = cvarManager->getCvar("rr_art_cache_mb");
+    CVarWrapper entries = cvarManager->getCvar("rr_art_cache_entries");
+    if (!megabytes || !entries) return;
 
-    if (font) ImGui::PopFont();
-    dl->PopClipRect();
+    mMedia->SetAlbumCacheBudget(
+        static_cast<uint64_t>(megabytes.getIntValue()) * 1024 * 1024,
+        static_cast<size_t>(entries.getIntValue()));
 }
 
 // ------------------------------------------------------------
-// JSON (WindowStyle)
+// Tracing (rr_trace_start / rr_trace_stop)
 // ------------------------------------------------------------
 
-void to_json(nlohmann::json& j, const RocketRhythm::WindowStyle& s)
+// Local time as "YYYYmmdd_HHMMSS" for capture file names
+static std::string FileTimestamp()
 {
-    j = nlohmann::json{
-        {"background_color", ImVec4ToJson(s.backgroundColor)},
-        {"accent_color",     ImVec4ToJson(s.accentColor)},
-        {"accent_color2",    ImVec4ToJson(s.accentColor2)},
-        {"text_color",       ImVec4ToJson(s.textColor)},
-        {"text_color_dim",   ImVec4ToJson(s.textColorDim)},
-        {"text_color_faint", ImVec4ToJson(s.textColorFaint)},
-
-        {"window_rounding",       s.windowRounding},
-        {"album_art_rounding",    s.albumArtRounding},
-        {"progress_bar_height",   s.progressBarHeight},
-        {"progress_bar_rounding", s.progressBarRounding},
-        {"album_art_size",        s.albumArtSize},
-
-        {"enable_pulse",     s.enablePulse},
-        {"show_album_art",   s.showAlbumArt},
-        {"show_progress_bar",s.showProgressBar},
-        {"show_album_info",  s.showAlbumInfo},
-        {"window_opacity",   s.windowOpacity},
-
-        {"ui_scale",            s.uiScale},
-        {"enable_auto_scaling", s.enableAutoScaling},
-        {"min_scale",           s.minScale},
-        {"max_scale",           s.maxScale},
-
-        {"enable_marquee",   s.enableMarquee},
-        {"marquee_speed_px", s.marqueeSpeedPx},
-        {"marquee_wait_sec", s.marqueeWaitSec},
-        {"time_display_mode", static_cast<int>(s.timeDisplayMode)},
-
-    };
+    std::time_t t = std::time(nullptr);
+    std::tm tm{};
+    localtime_s(&tm, &t);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm);
+    return stamp;
 }
 
-void from_json(const nlohmann::json& j, RocketRhythm::WindowStyle& s)
+void RocketRhythm::StartTrace(const std::vector<std::string>& args)
 {
-    const RocketRhythm::WindowStyle def = RocketRhythm::DefaultWindowStyle();
-    s = def;
+    size_t capacity = Tracer::kDefaultCapacity;
+    if (args.size() > 1)
+    {
+        try
+        {
+            capacity = std::clamp<size_t>(std::stoul(args[1]), 1024, 1u << 24);
+        }
+        catch (...)
+        {
+            LOG("rr_trace_start: invalid event count '{}'", args[1]);
+            return;
+        }
+    }
 
-    if (!j.is_object()) return;
+    const auto path = gameWrapper->GetDataFolder() / kConfigDir / "traces" / ("rr_trace_" + FileTimestamp() + ".json");
 
-    auto loadColor = [&](const char* key, ImVec4& target, const ImVec4& fallback)
+    if (!Tracer::Start(path, capacity))
     {
-        auto it = j.find(key);
-        if (it == j.end()) { target = fallback; return; }
-        ImVec4 tmp;
-        if (JsonToImVec4(*it, tmp)) target = tmp;
-        else target = fallback;
-    };
+        LOG("rr_trace_start: a capture is already running");
+        return;
+    }
 
-    loadColor("background_color", s.backgroundColor, def.backgroundColor);
-    loadColor("accent_color",     s.accentColor,     def.accentColor);
-    loadColor("accent_color2",    s.accentColor2,    def.accentColor2);
-    loadColor("text_color",       s.textColor,       def.textColor);
-    loadColor("text_color_dim",   s.textColorDim,    def.textColorDim);
-    loadColor("text_color_faint", s.textColorFaint,  def.textColorFaint);
-
-    int tdm = static_cast<int>(def.timeDisplayMode);
-    tdm = std::clamp(tdm, 0, 1);
-
-    AssignIfNumberOrBool(j, "window_rounding",       s.windowRounding);
-    AssignIfNumberOrBool(j, "album_art_rounding",    s.albumArtRounding);
-    AssignIfNumberOrBool(j, "progress_bar_height",   s.progressBarHeight);
-    AssignIfNumberOrBool(j, "progress_bar_rounding", s.progressBarRounding);
-    AssignIfNumberOrBool(j, "album_art_size",        s.albumArtSize);
-
-    AssignIfNumberOrBool(j, "enable_pulse",          s.enablePulse);
-    AssignIfNumberOrBool(j, "show_album_art",        s.showAlbumArt);
-    AssignIfNumberOrBool(j, "show_progress_bar",     s.showProgressBar);
-    AssignIfNumberOrBool(j, "show_album_info",       s.showAlbumInfo);
-    AssignIfNumberOrBool(j, "window_opacity",        s.windowOpacity);
-
-    AssignIfNumberOrBool(j, "ui_scale",              s.uiScale);
-    AssignIfNumberOrBool(j, "enable_auto_scaling",   s.enableAutoScaling);
-    AssignIfNumberOrBool(j, "min_scale",             s.minScale);
-    AssignIfNumberOrBool(j, "max_scale",             s.maxScale);
-
-    AssignIfNumberOrBool(j, "enable_marquee",   s.enableMarquee);
-    AssignIfNumberOrBool(j, "marquee_speed_px", s.marqueeSpeedPx);
-    AssignIfNumberOrBool(j, "marquee_wait_sec", s.marqueeWaitSec);
-    AssignIfNumberOrBool(j, "time_display_mode", tdm);
-
-    auto clampf = [](float v, float lo, float hi) { return v < lo ? lo : v > hi ? hi : v; };
-
-    s.windowOpacity = clampf(s.windowOpacity, 0.0f, 1.0f);
-
-    s.uiScale   = clampf(s.uiScale, 0.5f, 2.0f);
-    s.minScale  = clampf(s.minScale, 0.1f, 10.0f);
-    s.maxScale  = clampf(s.maxScale, 0.1f, 10.0f);
-    if (s.minScale > s.maxScale) std::swap(s.minScale, s.maxScale);
-
-    s.windowRounding      = clampf(s.windowRounding, 0.0f, 50.0f);
-    s.albumArtRounding    = clampf(s.albumArtRounding, 0.0f, 50.0f);
-    s.progressBarHeight   = clampf(s.progressBarHeight, 0.0f, 50.0f);
-    s.progressBarRounding = clampf(s.progressBarRounding, 0.0f, 50.0f);
-    s.albumArtSize        = clampf(s.albumArtSize, 16.0f, 512.0f);
-
-    s.marqueeSpeedPx = clampf(s.marqueeSpeedPx, 0.0f, 1000.0f);
-    s.marqueeWaitSec = clampf(s.marqueeWaitSec, 0.0f, 10.0f);
-    s.timeDisplayMode = static_cast<RocketRhythm::WindowStyle::TimeDisplayMode>(tdm);
+    Tracer::SetThreadName("game");
+    LOG("Trace capture started ({} events max)", capacity);
 }
 
-// ------------------------------------------------------------
-// RocketRhythm
-// ------------------------------------------------------------
-
-RocketRhythm::RocketRhythm()
-    : mLastProgressAnchor(std::chrono::steady_clock::now())
+void RocketRhythm::StopTrace()
 {
-}
+    const bool stopped = Tracer::Stop([](const std::filesystem::path& path, size_t written, size_t dropped, bool ok)
+    {
+        if (ok)
+            LOG("Trace written: {} ({} events, {} dropped)", path.string(), written, dropped);
+        else
+            LOG("Trace write failed: {}", path.string());
+    });
 
-RocketRhythm::~RocketRhythm() = default;
+    if (!stopped)
+        LOG("rr_trace_stop: no capture running");
+}
 
-void RocketRhythm::onLoad()
+void RocketRhythm::StartMediaRecording()
 {
-    _globalCvarManager = cvarManager;
-
-    mMedia = CreateMediaController(gameWrapper->GetDataFolder().string());
-
-    mEnabled = std::make_shared<bool>(true);
-    mUiScaleCvar = std::make_shared<float>(1.0f);
-
-    cvarManager->registerCvar("rr_enabled", "1", "Enable RocketRhythm").bindTo(mEnabled);
-    cvarManager->registerCvar("rr_uiscale", "1.0", "UI Scale factor", true, true, 0.5f, true, 2.0f).bindTo(mUiScaleCvar);
-
-    LoadConfig();
+    if (!mMedia) return;
 
-    gameWrapper->RegisterDrawable([this](const CanvasWrapper& canvas) { RenderCanvas(canvas); });
-
-    LOG("{} v{} loaded!", kPluginNameStr, plugin_version);
+    const auto path = gameWrapper->GetDataFolder() / kConfigDir / "recordings" / ("rr_media_" + FileTimestamp() + ".rrmr");
+    if (mMedia->StartRecording(path.string()))
+        LOG("Media recording started: {}", path.string());
+    else
+        LOG("rr_media_record_start: could not start recording (already running?)");
 }
 
-void RocketRhythm::onUnload()
+void RocketRhythm::StopMediaRecording()
 {
-    SaveConfig();
-
-    mAlbumArtTexture.reset();
-    cvarManager->removeCvar("rr_enabled");
-    cvarManager->removeCvar("rr_uiscale");
+    if (!mMedia) return;
 
-    LOG("{} unloaded!", kPluginNameStr);
+    mMedia->StopRecording();
+    LOG("Media recording stopped");
 }
 
 // ------------------------------------------------------------
@@ -382,34 +310,32 @@ void RocketRhythm::InitializeFonts()
 
     auto gui = gameWrapper->GetGUIManager();
 
-    const std::filesystem::path bmData    = gameWrapper->GetDataFolder();
-    const std::filesystem::path fontDir   = bmData / "fonts" / "RocketRhythm";
-    const std::filesystem::path fontFile  = fontDir / "segoeui.ttf";
-
     static const std::wstring kFontUrl = L"https://raw.githubusercontent.com/99Anvar99/RocketRhythm/main/fonts/segoeui.ttf";
 
     const std::string fontRel = "RocketRhythm/segoeui.ttf";
 
-    // Ensure directory exists
-    std::error_code ec;
-    std::filesystem::create_directories(fontDir, ec);
-    if (ec)
+    // Probes the disk once (and after a failed download), not every frame
+    if (!mFontProbe)
     {
-        LOG("Failed to create fonts dir: {} ({})", fontDir.string(), ec.message());
+        mFontProbe = std::make_unique<FontFileProbe>(gameWrapper->GetDataFolder() / "fonts" / "RocketRhythm", "segoeui.ttf");
+        mFontProbe->SetFileSystem(*mFileSystem);
     }
 
-    static std::atomic_bool sDownloadInFlight{ false };
-
-    const bool haveFontFile = std::filesystem::exists(fontFile);
+    const FontProbeResult probe = mFontProbe->Poll(std::chrono::steady_clock::now());
+    if (probe.dirError)
+    {
+        LOG("Failed to create fonts dir: {} ({})", mFontProbe->FontDir().string(), probe.dirError.message());
+    }
 
-    if (!haveFontFile && !sDownloadInFlight.exchange(true))
+    if (probe.startDownload)
     {
         // capture only what we need by value
         const std::wstring urlCopy = kFontUrl;
-        const std::filesystem::path dstFinal = fontFile;
-        const std::filesystem::path dstTemp  = fontDir / "segoeui.tmp";
+        const std::filesystem::path dstFinal = mFontProbe->FilePath();
+        const std::filesystem::path dstTemp  = mFontProbe->TempPath();
+        const FontDownloadFlag download = probe.startDownload;
 
-        std::thread([urlCopy, dstFinal, dstTemp]()
+        std::thread([urlCopy, dstFinal, dstTemp, download]()
         {
             HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
 
@@ -438,23 +364,28 @@ void RocketRhythm::InitializeFonts()
                 }
 
                 if (ec3)
+                {
                     LOG("Font move into place failed: {}", ec3.message());
+                    ok = false;
+                }
                 else
+                {
                     LOG("Font downloaded: {}", dstFinal.string());
+                }
             }
 
             if (SUCCEEDED(hr))
                 CoUninitialize();
 
-            sDownloadInFlight.store(false);
+            download->store(ok ? FontDownload::Done : FontDownload::Failed, std::memory_order_release);
         }).detach();
     }
 
-    // Try to load whenever the file exists (this will naturally succeed on later frames)
+    // Try to load once the file is known to exist (this will naturally succeed on later frames)
     static constexpr auto kOverlayKey  = "rr_overlay_24";
     static constexpr auto kSettingsKey = "rr_settings_16";
 
-    if (std::filesystem::exists(fontFile))
+    if (probe.present)
     {
         // Build ranges once
         static ImVector<ImWchar> sGlyphRanges;
@@ -489,6 +420,8 @@ void RocketRhythm::InitializeFonts()
         }
     }
 
+    // Runs laid out before this were measured in the fallback font
+    mOverlay.SetFont(mFontOverlay);
     mFontsInitialized = mFontOverlay != nullptr && mFontSettings != nullptr;
 }
 
@@ -496,342 +429,160 @@ void RocketRhythm::InitializeFonts()
 // Album art
 // ------------------------------------------------------------
 
-void RocketRhythm::LoadAlbumArt(const std::string& path)
+// Render thread: swaps in the art for the current track. Steady state is a pointer
+// compare; a track change is a registry lookup by content hash, and only new pixels
+// (decoded on the media worker's thread pool) cost a texture upload, which runs on
+// mArtLoader's thread and is picked up a frame or more later. No texture is created or
+// destroyed here, and nothing touches the disk. The texture carries albumArtRounding as
+// a corner mask, so a rounding change re-uploads the pixels already in memory.
+void RocketRhythm::UpdateAlbumArtTexture()
 {
-    if (path.empty() || !IsValidImageFile(path))
-    {
-        mAlbumArtLoaded = false;
-        mAlbumArtTexture.reset();
-        mAlbumArtPath.clear();
-        return;
-    }
+    AdvanceArtFade();
 
-    if (mAlbumArtLoaded && mAlbumArtTexture && mAlbumArtPath == path)
-        return;
-
-    try
+    // Replaced textures go back to the loader thread once no frame in flight samples them
+    const int frame = ImGui::GetFrameCount();
+    for (auto it = mArtRetiring.begin(); it != mArtRetiring.end();)
     {
-        mAlbumArtTexture.reset();
-        mAlbumArtTexture = std::make_shared<ImageWrapper>(path, false, true);
-
-        if (mAlbumArtTexture)
+        if (frame < it->second)
         {
-            mAlbumArtLoaded = true;
-            mAlbumArtPath = path;
+            ++it;
+            continue;
         }
-        else
-        {
-            mAlbumArtLoaded = false;
-            mAlbumArtPath.clear();
-        }
-    }
-    catch (const std::exception& e)
-    {
-        mAlbumArtLoaded = false;
-        mAlbumArtTexture.reset();
-        mAlbumArtPath.clear();
-        LOG("Album art load error: {}", e.what());
+        mArtLoader.Retire(std::move(it->first));
+        it = mArtRetiring.erase(it);
     }
-}
-
-// ------------------------------------------------------------
-// Playback position smoothing
-// ------------------------------------------------------------
-
-int RocketRhythm::GetCurrentDisplayPositionSec()
-{
-    const auto now = std::chrono::steady_clock::now();
-
-    const std::string trackKey = mMediaState.title + "|" + mMediaState.artist + "|" + mMediaState.album;
-
-    // Re-anchor when track changes or position updates externally
-    if (trackKey != mLastTrackKey || mMediaState.positionSec != mLastPositionSec)
-    {
-        mLastTrackKey = trackKey;
-        mLastPositionSec = mMediaState.positionSec;
-        mAnchoredPositionSec = mMediaState.positionSec;
-        mLastProgressAnchor = now;
-    }
-
-    if (!mMediaState.isPlaying || mMediaState.durationSec <= 0)
-    {
-        return std::clamp(mMediaState.positionSec, 0, (mMediaState.durationSec > 0 ? mMediaState.durationSec : 0));
-    }
-
-    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - mLastProgressAnchor).count();
-    const int predicted = mAnchoredPositionSec + static_cast<int>(elapsedMs / 1000);
 
-    return std::clamp(predicted, 0, mMediaState.durationSec);
-}
-
-// ------------------------------------------------------------
-// Scaling
-// ------------------------------------------------------------
+    // Content hash: tracks of the same album carry the same key and share one texture
+    const MediaState& media = mOverlay.GetMediaState();
+    const uint64_t artKey = media.albumArtKey;
+    const auto& image = media.albumArtImage;
 
-float RocketRhythm::GetDpiScaleFactor()
-{
-    HDC screen = GetDC(nullptr);
-    const float dpiScaleX = static_cast<float>(GetDeviceCaps(screen, LOGPIXELSX)) / 96.0f;
-    ReleaseDC(nullptr, screen);
-    return dpiScaleX;
-}
-
-float RocketRhythm::CalculateAutoScaleFactor()
-{
-    const ImVec2 displaySize = ImGui::GetIO().DisplaySize;
-
-    constexpr float baseWidth = 1920.0f;
-    constexpr float baseHeight = 1080.0f;
-
-    const float heightRatio = displaySize.y / baseHeight;
-    const float widthRatio = displaySize.x / baseWidth;
-
-    const float resolutionScale = std::min(heightRatio, widthRatio);
-    const float dpiScale = GetDpiScaleFactor();
-
-    float autoScale = resolutionScale * dpiScale;
-    autoScale = std::clamp(autoScale, mWindowStyle.minScale, mWindowStyle.maxScale);
-    return autoScale;
-}
-
-float RocketRhythm::GetEffectiveScaleFactor()
-{
-    if (mUiScaleCvar)
-        mWindowStyle.uiScale = *mUiScaleCvar;
-
-    float scale = mWindowStyle.enableAutoScaling ? CalculateAutoScaleFactor() : 1.0f;
-    scale *= mWindowStyle.uiScale;
-
-    return std::clamp(scale, 0.5f, 3.0f);
-}
-
-float RocketRhythm::GetScaledValue(float baseValue)
-{
-    return baseValue * GetEffectiveScaleFactor();
-}
-
-// ------------------------------------------------------------
-// Animation
-// ------------------------------------------------------------
-
-void RocketRhythm::UpdateAnimation(float deltaTime)
-{
-    if (mMediaState.isPlaying && mWindowStyle.enablePulse)
-    {
-        mPulsePhase += deltaTime * 2.0f;
-        if (mPulsePhase > 6.2831853f) mPulsePhase -= 6.2831853f;
-    }
-}
-
-// ------------------------------------------------------------
-// Drawing (album art)
-// ------------------------------------------------------------
-
-void RocketRhythm::DrawAlbumArtPlaceholder(float scale)
-{
-    ImDrawList* dl = ImGui::GetWindowDrawList();
-    const ImVec2 pos = ImGui::GetCursorScreenPos();
-    const float size = mWindowStyle.albumArtSize * scale;
-
-    const ImU32 top = ImGui::GetColorU32(ImVec4(0.15f, 0.15f, 0.18f, 1.0f));
-    const ImU32 bot = ImGui::GetColorU32(ImVec4(0.12f, 0.12f, 0.15f, 1.0f));
-    dl->AddRectFilledMultiColor(pos, ImVec2(pos.x + size, pos.y + size), top, top, bot, bot);
-
-    const float cx = pos.x + size * 0.5f;
-    const float cy = pos.y + size * 0.5f;
+    // Corner radius relative to the drawn edge; textures are decoded larger than they are drawn
+    const float cornerScale = mWindowStyle.albumArtSize > 0.0f ? mWindowStyle.albumArtRounding / mWindowStyle.albumArtSize : 0.0f;
+    const auto cornersMatch = [&](const ArtTexture& texture) {
+        return std::fabs(texture.GetCornerRadius() - cornerScale * texture.GetWidth()) < 0.5f;
+    };
 
-    for (int i = 0; i < 3; ++i)
+    ArtTextureLoader::Result ready;
+    if (mArtLoader.TakeResult(ready))
     {
-        const float radius = size * 0.25f + i * (8.0f * scale);
-        const ImU32 ring = ImGui::GetColorU32(ImVec4(0.3f, 0.3f, 0.35f, 0.2f));
-        dl->AddCircle(ImVec2(cx, cy), radius, ring, 0, 1.5f);
-    }
+        // Whatever the registry drops is released on the loader thread as well
+        if (ready.texture) mArtLoader.Retire(mArtRegistry.Insert(ready.image->artKey, ready.texture));
 
-    const ImU32 note = ImGui::GetColorU32(mWindowStyle.accentColor);
-    const float fontSize = ImGui::GetFontSize() * 2.0f;
-    const float off = 15.0f * scale;
-    dl->AddText(ImGui::GetFont(), fontSize, ImVec2(cx - off, cy - off), note, "♪");
-
-    const ImU32 border = ImGui::GetColorU32(mWindowStyle.accentColor);
-    dl->AddRect(pos, ImVec2(pos.x + size, pos.y + size), border, mWindowStyle.albumArtRounding * scale, 0, 2.0f);
-
-    // Advance cursor to the right (column layout)
-    ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(size + 15.0f * scale, 0));
-}
-
-void RocketRhythm::DrawAlbumArt(float scale)
-{
-    if (mMediaState.hasAlbumArt && !mMediaState.albumArtPath.empty())
-        LoadAlbumArt(mMediaState.albumArtPath);
-
-    ImDrawList* dl = ImGui::GetWindowDrawList();
-    const ImVec2 pos = ImGui::GetCursorScreenPos();
-    const float size = mWindowStyle.albumArtSize * scale;
-
-    if (mAlbumArtLoaded && mAlbumArtTexture && mAlbumArtTexture->IsLoadedForImGui())
-    {
-        if (ImTextureID tex = mAlbumArtTexture->GetImGuiTex())
+        // A failed upload leaves the placeholder up; the same pixels are not requested again
+        if (ready.image == image)
         {
-            ImGui::Image(tex, ImVec2(size, size));
-            const ImU32 border = ImGui::GetColorU32(ImVec4(1, 1, 1, 0.10f));
-            dl->AddRect(pos, ImVec2(pos.x + size, pos.y + size), border, mWindowStyle.albumArtRounding * scale, 0, 1.0f);
-
-            ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(size + 15.0f * scale, 0));
+            ShowArt(std::move(ready.texture), image, artKey);
             return;
         }
     }
 
-    DrawAlbumArtPlaceholder(scale);
-}
-
-// ------------------------------------------------------------
-// Drawing (progress bar)
-// ------------------------------------------------------------
-
-void RocketRhythm::DrawProgressBar()
-{
-    if (!mWindowStyle.showProgressBar || mMediaState.durationSec <= 0) return;
-
-    const int currentPos = GetCurrentDisplayPositionSec();
-    float progress = static_cast<float>(currentPos) / static_cast<float>(mMediaState.durationSec);
-    progress = std::clamp(progress, 0.0f, 1.0f);
-
-    ImDrawList* dl = ImGui::GetWindowDrawList();
-    const ImVec2 pos = ImGui::GetCursorScreenPos();
-    const float width  = ImGui::GetContentRegionAvail().x;
-    const float height = GetScaledValue(mWindowStyle.progressBarHeight);
-
-    const ImU32 bgCol = ImGui::GetColorU32(ImVec4(0.15f, 0.15f, 0.20f, 0.8f));
-
-    float bgRounding = GetScaledValue(mWindowStyle.progressBarRounding);
-    bgRounding = std::min(bgRounding, height * 0.5f);
-
-    // Background
-    dl->AddRectFilled(pos, ImVec2(pos.x + width, pos.y + height), bgCol, bgRounding);
-
-    // Fill
-    if (progress > 0.0f)
+    if (image == mAlbumArtImage && artKey == mAlbumArtKey)
     {
-        const float fillWidth = width * progress;
-
-        ImVec4 fillColor = mWindowStyle.accentColor;
-        if (mMediaState.isPlaying && mWindowStyle.enablePulse)
-        {
-            const float pulse = 0.8f + 0.2f * sinf(mPulsePhase);
-            fillColor.x *= pulse;
-            fillColor.y *= pulse;
-            fillColor.z *= pulse;
-        }
-
-        float fillRounding = GetScaledValue(mWindowStyle.progressBarRounding);
-        fillRounding = std::min(fillRounding, height * 0.5f);
-        fillRounding = std::min(fillRounding, fillWidth * 0.5f);
-
-        const ImU32 fillCol = ImGui::GetColorU32(fillColor);
-        dl->AddRectFilled(pos, ImVec2(pos.x + fillWidth, pos.y + height), fillCol, fillRounding);
-
-        const ImU32 highlight = ImGui::GetColorU32(ImVec4(1, 1, 1, 0.20f));
-        dl->AddLine(ImVec2(pos.x, pos.y + 1), ImVec2(pos.x + fillWidth, pos.y + 1), highlight, 1.0f);
+        if (!mAlbumArtTexture || !image || cornersMatch(*mAlbumArtTexture)) return;
     }
 
-    // Time labels
-    const float yText = pos.y + height + GetScaledValue(4.0f);
-    const ImU32 textCol = ImGui::GetColorU32(mWindowStyle.textColorDim);
+    auto known = artKey ? mArtRegistry.Find(artKey) : nullptr;
+    if (known && image && !cornersMatch(*known)) known.reset();
 
-    if (mWindowStyle.timeDisplayMode == WindowStyle::TimeDisplayMode::Corners)
+    if (known)
     {
-        const std::string leftTime  = FormatTimeSeconds(currentPos);
-        const std::string rightTime = FormatTimeSeconds(mMediaState.durationSec);
-
-        dl->AddText(ImVec2(pos.x, yText), textCol, leftTime.c_str());
-
-        const float rightW = ImGui::CalcTextSize(rightTime.c_str()).x;
-        dl->AddText(ImVec2(pos.x + width - rightW, yText), textCol, rightTime.c_str());
+        ShowArt(std::move(known), image, artKey);
+        return;
     }
-    else // CenterSlash
-    {
-        const std::string timeText =
-            FormatTimeSeconds(currentPos) + " / " + FormatTimeSeconds(mMediaState.durationSec);
 
-        const float textW = ImGui::CalcTextSize(timeText.c_str()).x;
-        const float x = pos.x + (width - textW) * 0.5f;
+    if (!image)
+    {
+        // Previous art stays up until the new track's pixels arrive
+        if (media.albumArtPending) return;
 
-        dl->AddText(ImVec2(x, yText), textCol, timeText.c_str());
+        ShowArt(nullptr, nullptr, artKey);
+        return;
     }
 
-    // Reserve space (text line + spacing)
-    ImGui::Dummy(ImVec2(width, ImGui::GetTextLineHeight() + GetScaledValue(12.0f)));
+    // Previous art stays up while the loader thread uploads the new pixels; the result is
+    // picked up from the registry on a later frame
+    const float cornerRadiusPx = cornerScale * image->width;
+    if (image != mArtRequestImage || std::fabs(cornerRadiusPx - mArtRequestRadius) >= 0.5f)
+    {
+        mArtRequestImage = image;
+        mArtRequestRadius = cornerRadiusPx;
+        mArtLoader.Request(image, cornerRadiusPx);
+    }
 }
 
-// ------------------------------------------------------------
-// Drawing (music state)
-// ------------------------------------------------------------
-
-void RocketRhythm::DrawMusicStateCompact()
+// Puts `texture` in the front slot. A different cover crossfades over the one it replaces;
+// the same cover re-uploaded with other corners just swaps.
+void RocketRhythm::ShowArt(std::shared_ptr<ArtTexture> texture, std::shared_ptr<const AlbumArtImage> image, uint64_t artKey)
 {
-    if (mFontOverlay) ImGui::PushFont(mFontOverlay);
-
-    const float speed = mWindowStyle.marqueeSpeedPx * GetEffectiveScaleFactor();
-    const float wait  = mWindowStyle.marqueeWaitSec;
-
-    // Title
-    if (!mMediaState.title.empty())
+    if (texture != mAlbumArtTexture)
     {
-        ImVec4 c = mWindowStyle.textColor;
-        if (mMediaState.isPlaying && mWindowStyle.enablePulse)
+        const bool sameArt = texture && mAlbumArtTexture && artKey && artKey == mAlbumArtKey;
+        if (sameArt || mWindowStyle.albumArtFadeSec <= 0.0f)
         {
-            const float pulse = 0.9f + 0.1f * sinf(mPulsePhase);
-            c.w *= pulse;
+            RetireArt(std::move(mAlbumArtTexture));
         }
-
-        if (mWindowStyle.enableMarquee)
-            DrawPingPongMarqueeText(mMediaState.title.c_str(), c, ImGui::GetContentRegionAvail().x, speed, wait, mFontOverlay);
         else
-            ImGui::TextColored(c, "%s", mMediaState.title.c_str());
-    }
-
-    // Artist
-    if (!mMediaState.artist.empty())
-    {
-        if (mWindowStyle.enableMarquee)
-            DrawPingPongMarqueeText(mMediaState.artist.c_str(), mWindowStyle.textColorDim, ImGui::GetContentRegionAvail().x, speed, wait, mFontOverlay);
-        else
-            ImGui::TextColored(mWindowStyle.textColorDim, "%s", mMediaState.artist.c_str());
-    }
-
-    // Album
-    if (mWindowStyle.showAlbumInfo && !mMediaState.album.empty())
-    {
-        if (mWindowStyle.enableMarquee)
-            DrawPingPongMarqueeText(mMediaState.album.c_str(), mWindowStyle.textColorFaint, ImGui::GetContentRegionAvail().x, speed, wait, mFontOverlay);
-        else
-            ImGui::TextColored(mWindowStyle.textColorFaint, "%s", mMediaState.album.c_str());
+        {
+            RetireArt(std::move(mAlbumArtPrev));
+            mAlbumArtPrev = std::move(mAlbumArtTexture);
+            mOverlay.Animations().ArtFade().Start(mOverlay.Animations().Frame(), mWindowStyle.albumArtFadeSec);
+        }
+        mAlbumArtTexture = std::move(texture);
     }
 
-    ImGui::Spacing();
+    mAlbumArtImage = std::move(image);
+    mAlbumArtKey = artKey;
+    mOverlay.Redraw().Invalidate();
+}
 
-    if (mWindowStyle.showProgressBar && mMediaState.durationSec > 0)
-        DrawProgressBar();
+// The draw data of this frame (and of frames still queued on the GPU) may reference the
+// texture, so it is handed to the loader thread a few frames later.
+void RocketRhythm::RetireArt(std::shared_ptr<ArtTexture> texture)
+{
+    constexpr int kRetireFrames = 3;
+    if (texture) mArtRetiring.emplace_back(std::move(texture), ImGui::GetFrameCount() + kRetireFrames);
+}
 
-    if (mFontOverlay) ImGui::PopFont();
+// The fade itself advances with the overlay's frame clock; this drops the old art once it is done
+void RocketRhythm::AdvanceArtFade()
+{
+    if (!mOverlay.Animations().ArtFade().Active()) RetireArt(std::move(mAlbumArtPrev));
 }
 
-void RocketRhythm::DrawNoMusicState()
+// What the overlay draws this frame: the front art, and the art it replaces while the
+// crossfade runs
+OverlayArt RocketRhythm::GetOverlayArt() const
 {
-    const ImVec2 ws = ImGui::GetWindowSize();
-    const ImVec2 center(ws.x * 0.5f, ws.y * 0.5f);
+    const auto layerOf = [](const ArtTexture* texture) {
+        OverlayArtLayer layer;
+        if (!texture) return layer;
+
+        layer.image = texture->GetImGuiTex();
+        layer.backdrop = texture->GetBackdropTex();
+        layer.palette = &texture->GetPalette();
+        return layer;
+    };
 
-    auto mainText = "No Music Playing";
-    auto subText  = "Play a song to see track info";
+    return OverlayArt{ layerOf(mAlbumArtTexture.get()), layerOf(mAlbumArtPrev.get()) };
+}
 
-    const float mainW = ImGui::CalcTextSize(mainText).x;
-    const float subW  = ImGui::CalcTextSize(subText).x;
+void RocketRhythm::SetFileSystem(FileSystem& fs)
+{
+    mFileSystem = &fs;
+    if (mFontProbe) mFontProbe->SetFileSystem(fs);
+}
 
-    ImGui::SetCursorPos(ImVec2(center.x - mainW * 0.5f, center.y - 20));
-    ImGui::TextColored(mWindowStyle.textColorFaint, "%s", mainText);
+// ------------------------------------------------------------
+// Scaling
+// ------------------------------------------------------------
 
-    ImGui::SetCursorPos(ImVec2(center.x - subW * 0.5f, center.y + 10));
-    ImGui::TextColored(mWindowStyle.textColorFaint, "%s", subText);
+float RocketRhythm::GetDpiScaleFactor()
+{
+    HDC screen = GetDC(nullptr);
+    const float dpiScaleX = static_cast<float>(GetDeviceCaps(screen, LOGPIXELSX)) / 96.0f;
+    ReleaseDC(nullptr, screen);
+    return dpiScaleX;
 }
 
 // ------------------------------------------------------------
@@ -883,11 +634,32 @@ void RocketRhythm::RenderSettings()
 
     ImGui::TextColored(mWindowStyle.accentColor, "Media Status");
     ImGui::Text("Player: %s", mMedia ? "Connected" : "Disconnected");
-    ImGui::Text("State: %s", mMediaState.isPlaying ? "Playing" : (!mMediaState.title.empty() ? "Paused" : "No Media"));
-    if (!mMediaState.title.empty())
+    const MediaState& media = mOverlay.GetMediaState();
+    ImGui::Text("State: %s", media.isPlaying ? "Playing" : (!media.title.empty() ? "Paused" : "No Media"));
+    if (!media.title.empty())
+    {
+        ImGui::Text("Track: %s", media.title.c_str());
+        if (!media.artist.empty()) ImGui::Text("Artist: %s", media.artist.c_str());
+    }
+    if (mMedia)
     {
-        ImGui::Text("Track: %s", mMediaState.title.c_str());
-        if (!mMediaState.artist.empty()) ImGui::Text("Artist: %s", mMediaState.artist.c_str());
+        const MediaStats stats = mMedia->GetStats();
+        ImGui::TextDisabled("Events: %llu -> %llu batches (+%llu art completions)",
+            static_cast<unsigned long long>(stats.events),
+            static_cast<unsigned long long>(stats.batches),
+            static_cast<unsigned long long>(stats.completions));
+        ImGui::TextDisabled("Refreshes: %llu full, %llu timeline-only",
+            static_cast<unsigned long long>(stats.fullRefreshes),
+            static_cast<unsigned long long>(stats.timelineRefreshes));
+    }
+
+    if (Profiler::IsEnabled())
+    {
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Spacing();
+
+        DrawProfilerStats();
     }
 
     ImGui::Spacing();
@@ -927,6 +699,10 @@ void RocketRhythm::RenderSettings()
     ImGui::ColorEdit4("Background", &mWindowStyle.backgroundColor.x, ImGuiColorEditFlags_NoInputs);
     ImGui::SameLine();
     ImGui::ColorEdit4("Accent", &mWindowStyle.accentColor.x, ImGuiColorEditFlags_NoInputs);
+    ImGui::SameLine();
+    ImGui::Checkbox("Accent From Album Art", &mWindowStyle.accentFromAlbumArt);
+    ImGui::SameLine();
+    DrawHelpMarker("Use colors picked from the current album art instead of the accent colors (when the art is colorful enough)");
 
     ImGui::Checkbox("Show Album Art", &mWindowStyle.showAlbumArt);
     ImGui::SameLine();
@@ -934,7 +710,14 @@ void RocketRhythm::RenderSettings()
     ImGui::SameLine();
     ImGui::Checkbox("Show Album Info", &mWindowStyle.showAlbumInfo);
 
-    ImGui::SliderFloat("Album Art Size", &mWindowStyle.albumArtSize, 80.0f, 150.0f, "%.0f px");
+    ImGui::Checkbox("Album Art Backdrop", &mWindowStyle.albumArtBackdrop);
+    ImGui::SameLine();
+    DrawHelpMarker("Use a blurred, darkened copy of the album art as the overlay background");
+
+    ImGui::SliderFloat("Album Art Size", &mWindowStyle.albumArtSize, kAlbumArtSizeMin, kAlbumArtSizeMax, "%.0f px");
+    ImGui::SliderFloat("Album Art Fade", &mWindowStyle.albumArtFadeSec, 0.0f, 2.0f, "%.2f s");
+    ImGui::SameLine();
+    DrawHelpMarker("Crossfade between covers on a track change (0 switches at once)");
     ImGui::SliderFloat("Window Rounding", &mWindowStyle.windowRounding, 0.0f, 30.0f, "%.0f");
     ImGui::SliderFloat("Opacity", &mWindowStyle.windowOpacity, 0.5f, 1.0f, "%.2f");
 
@@ -1001,6 +784,7 @@ void RocketRhythm::RenderSettings()
         mHideWhenNotPlaying = true;
         mWindowStyle = DefaultWindowStyle();
         if (mUiScaleCvar) *mUiScaleCvar = mWindowStyle.uiScale;
+        InvalidateLayoutMetrics();
         notify(Info, "{}: Settings Reset To Default!", kPluginNameStr);
     }
 
@@ -1015,6 +799,87 @@ void RocketRhythm::RenderSettings()
     {
         ShellExecuteA(nullptr, "open", "https://github.com/99Anvar99/RocketRhythm", nullptr, nullptr, SW_SHOWNORMAL);
     }
+
+    // Any widget above edited the style this frame (sliders, checkboxes, color pickers)
+    if (ImGui::GetCurrentContext()->ActiveIdHasBeenEditedThisFrame)
+        InvalidateLayoutMetrics();
+}
+
+void RocketRhythm::DrawProfilerStats()
+{
+    ImGui::TextColored(mWindowStyle.accentColor, "Profiler (rr_profile)");
+    ImGui::SameLine();
+    DrawHelpMarker("Per-stage timings in microseconds over the most recent samples. Set rr_profile 0 to hide.");
+
+    const auto stats = Profiler::Collect();
+
+    ImGui::Columns(5, "rr_profiler", false);
+    ImGui::TextDisabled("Stage");   ImGui::NextColumn();
+    ImGui::TextDisabled("Samples"); ImGui::NextColumn();
+    ImGui::TextDisabled("p50 us");  ImGui::NextColumn();
+    ImGui::TextDisabled("p99 us");  ImGui::NextColumn();
+    ImGui::TextDisabled("max us");  ImGui::NextColumn();
+
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        const ProfileStats& st = stats[i];
+        ImGui::TextUnformatted(ProfileStageName(static_cast<ProfileStage>(i))); ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(st.count));       ImGui::NextColumn();
+        ImGui::Text("%.1f", st.p50Us);                                         ImGui::NextColumn();
+        ImGui::Text("%.1f", st.p99Us);                                         ImGui::NextColumn();
+        ImGui::Text("%.1f", st.maxUs);                                         ImGui::NextColumn();
+    }
+
+    ImGui::Columns(1);
+
+    if (const uint64_t dropped = Profiler::DroppedSamples())
+        ImGui::TextDisabled("Dropped samples: %llu", static_cast<unsigned long long>(dropped));
+
+    const RetainedDrawStats& layers = mOverlay.Layers().Stats();
+    ImGui::TextDisabled("Retained layers: %llu replays (%llu vertices copied), %llu recordings (%llu vertices)",
+        static_cast<unsigned long long>(layers.replayedLayers),
+        static_cast<unsigned long long>(layers.replayedVertices),
+        static_cast<unsigned long long>(layers.recordedLayers),
+        static_cast<unsigned long long>(layers.recordedVertices));
+    ImGui::TextDisabled("Overlay redraws: %llu of %llu frames",
+        static_cast<unsigned long long>(mOverlay.Redraw().Redraws()),
+        static_cast<unsigned long long>(mOverlay.Redraw().Frames()));
+    ImGui::TextDisabled("Layout metrics: scale %.2f, computed %llu times",
+        mOverlay.Metrics().scale,
+        static_cast<unsigned long long>(mOverlay.MetricsComputes()));
+
+    std::string animations;
+    for (size_t i = 0; i < static_cast<size_t>(AnimationId::Count); ++i)
+    {
+        const AnimationId id = static_cast<AnimationId>(i);
+        if (!mOverlay.Animations().State(id).active) continue;
+        if (!animations.empty()) animations += ", ";
+        animations += AnimationName(id);
+    }
+    ImGui::TextDisabled("Animations: %s", animations.empty() ? "idle" : animations.c_str());
+
+    if (mMedia)
+    {
+        const MediaStats media = mMedia->GetStats();
+        const double ratio = media.artBlobs ? static_cast<double>(media.artKeys) / static_cast<double>(media.artBlobs) : 1.0;
+        ImGui::TextDisabled("Album art: %llu tracks -> %llu images (%.2fx), %llu album hits, %llu duplicate downloads, %.1f MB saved",
+            static_cast<unsigned long long>(media.artKeys),
+            static_cast<unsigned long long>(media.artBlobs),
+            ratio,
+            static_cast<unsigned long long>(media.artAlbumHits),
+            static_cast<unsigned long long>(media.artDedupeHits),
+            static_cast<double>(media.artBytesSaved) / (1024.0 * 1024.0));
+        ImGui::TextDisabled("Art pack: %.1f MB (%.1f MB awaiting compaction)",
+            static_cast<double>(media.artPackBytes) / (1024.0 * 1024.0),
+            static_cast<double>(media.artDeadBytes) / (1024.0 * 1024.0));
+    }
+
+    if (ImGui::Button("Reset Stats"))
+    {
+        Profiler::Reset();
+        mOverlay.Layers().ResetStats();
+        mOverlay.Redraw().ResetStats();
+    }
 }
 
 // ------------------------------------------------------------
@@ -1051,99 +916,34 @@ void RocketRhythm::RenderWindow()
 {
     if (!mEnabled || !*mEnabled) return;
 
+    if (Tracer::IsActive()) Tracer::SetThreadName("render");
+    RR_PROFILE_SCOPE(ProfileStage::RenderWindow);
+
     if (!mFontsInitialized)
         InitializeFonts();
 
-    static auto lastTime = std::chrono::steady_clock::now();
-    const auto now = std::chrono::steady_clock::now();
-    const float dt = std::chrono::duration<float>(now - lastTime).count();
-    lastTime = now;
+    // The one clock tick of the frame; every animation reads its time from here
+    const FrameTime& frame = mOverlay.BeginFrame(static_cast<uint64_t>(ImGui::GetFrameCount()), std::chrono::steady_clock::now(), std::chrono::system_clock::now());
 
-    UpdateAnimation(dt);
+    // Art uploads and crossfades advance on replayed frames too
+    if (mOverlay.HasMusic() && (mWindowStyle.showAlbumArt || mWindowStyle.albumArtBackdrop))
+        UpdateAlbumArtTexture();
 
-    const float scaleFactor = GetEffectiveScaleFactor();
+    mOverlay.Draw(GetOverlayArt());
 
-    // Base size at scale=1 (approx)
-    float baseWidth = 360.0f;
-    float baseHeight = 130.0f;
-    if (mWindowStyle.showAlbumArt)
+    // Decodes target the largest size the art is drawn at with the current scale
+    const int artPx = mOverlay.AlbumArtRequestPx();
+    if (mMedia && artPx > 0 && artPx != mAlbumArtRequestPx)
     {
-        baseWidth  = mWindowStyle.albumArtSize + 15.0f + 235.0f + 15.0f;
-        baseHeight = std::max(mWindowStyle.albumArtSize + 20.0f, 140.0f);
+        mAlbumArtRequestPx = artPx;
+        mMedia->SetAlbumArtSize(artPx);
     }
 
-    const float scaledW = baseWidth * scaleFactor;
-
-    const ImVec2 screenSize = ImGui::GetIO().DisplaySize;
-    const float winX = (screenSize.x - scaledW) * 0.5f;
-    const float winY = 25.0f * scaleFactor;
-
-    ImGui::SetNextWindowPos(ImVec2(winX, winY), ImGuiCond_FirstUseEver);
-
-    const float minW = baseWidth * 0.5f;
-    const float minH = baseHeight * 0.5f;
-    ImGui::SetNextWindowSizeConstraints(
-        ImVec2(minW * scaleFactor, minH * scaleFactor),
-        ImVec2(FLT_MAX, FLT_MAX)
-    );
-
-    ImVec4 bg = mWindowStyle.backgroundColor;
-    bg.w *= mWindowStyle.windowOpacity;
-
-    ImGui::PushStyleColor(ImGuiCol_WindowBg, bg);
-    ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, mWindowStyle.windowRounding * scaleFactor);
-    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(10.0f * scaleFactor, 10.0f * scaleFactor));
-    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4.0f * scaleFactor, 2.0f * scaleFactor));
-    ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(4.0f * scaleFactor, 2.0f * scaleFactor));
-
-    if (mFontOverlay) ImGui::PushFont(mFontOverlay);
-
-    if (ImGui::Begin("##RocketRhythmWindow", nullptr,
-        ImGuiWindowFlags_NoCollapse |
-        ImGuiWindowFlags_NoTitleBar |
-        ImGuiWindowFlags_NoScrollbar))
     {
-        const ImVec2 currentWindowSize = ImGui::GetWindowSize();
-        const float dynamicScaleX = currentWindowSize.x / baseWidth;
-        const float dynamicScaleY = currentWindowSize.y / baseHeight;
-        float dynamicScale = std::min(dynamicScaleX, dynamicScaleY);
-        dynamicScale = std::clamp(dynamicScale, 0.5f, 3.0f);
-
-        float fontScale = dynamicScale;
-        if (dynamicScale > 1.5f) fontScale *= 0.95f;
-        ImGui::SetWindowFontScale(fontScale);
-
-        if (mMediaState.title.empty() && mMediaState.artist.empty())
-        {
-            DrawNoMusicState();
-        }
-        else
-        {
-            if (mWindowStyle.showAlbumArt)
-            {
-                ImGui::Columns(2, "music_columns", false);
-                const float colW = (mWindowStyle.albumArtSize + 15.0f) * dynamicScale;
-                ImGui::SetColumnWidth(0, colW);
-
-                DrawAlbumArt(dynamicScale);
-
-                ImGui::NextColumn();
-                DrawMusicStateCompact();
-                ImGui::Columns(1);
-            }
-            else
-            {
-                DrawMusicStateCompact();
-            }
-        }
+        RR_PROFILE_SCOPE(ProfileStage::RenderNotifications);
+        const size_t toasts = ImGui::render_notifications(frame.now);
+        mOverlay.Animations().Report(AnimationId::Toasts, toasts ? AnimationState{ true, 0.0 } : AnimationState{});
     }
-    ImGui::End();
-
-    if (mFontOverlay) ImGui::PopFont();
-    ImGui::PopStyleVar(4);
-    ImGui::PopStyleColor(1);
-
-    ImGui::render_notifications();
 }
 
 // ------------------------------------------------------------
@@ -1152,19 +952,17 @@ void RocketRhythm::RenderWindow()
 
 void RocketRhythm::RenderCanvas(const CanvasWrapper& canvas)
 {
-    static auto lastTime = std::chrono::steady_clock::now();
-    const auto now = std::chrono::steady_clock::now();
-    const float dt = std::chrono::duration<float>(now - lastTime).count();
-    lastTime = now;
+    RR_PROFILE_SCOPE(ProfileStage::RenderCanvas);
 
-    if (mMedia)
+    // Only copy when the worker published a new version
+    if (mMedia && mMedia->Update())
     {
-        mMedia->Update();
-        mMediaState = mMedia->GetState();
-        mIsNotPlaying = !mMediaState.isPlaying && mMediaState.title.empty();
+        mOverlay.SetMediaState(mMedia->GetState());
+
+        const MediaState& media = mOverlay.GetMediaState();
+        mIsNotPlaying = !media.isPlaying && media.title.empty();
     }
 
-    UpdateAnimation(dt);
     UpdateWindowState();
 
     const std::string& menuName = GetMenuNameCached();
@@ -1255,6 +1053,9 @@ void RocketRhythm::LoadConfig()
         return;
     }
 
+    // Every path below replaces the style
+    InvalidateLayoutMetrics();
+
     try
     {
         // Defaults
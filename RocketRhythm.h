@@ -2,10 +2,17 @@
 #include <memory>
 #include <string>
 #include <chrono>
+#include <vector>
 #include <nlohmann/json_fwd.hpp>
 
 #include "GuiBase.h"
 #include "media.h"
+#include "overlay_view.h"
+#include "art_texture.h"
+#include "album_art_registry.h"
+#include "file_system.h"
+#include "font_probe.h"
+#include "window_style.h"
 #include "bakkesmod/plugin/bakkesmodplugin.h"
 #include "IMGUI/imgui.h"
 #include "bakkesmod/wrappers/wrapperstructs.h"
@@ -28,51 +35,10 @@ public:
 
     void RenderCanvas(const CanvasWrapper& canvas);
 
-private:
-    // ---------------------------
-    // Configurable style/settings
-    // ---------------------------
-    struct WindowStyle
-    {
-        ImVec4 backgroundColor = ImVec4(0.0f, 0.0f, 0.0f, 1.0f);
-        ImVec4 accentColor     = ImVec4(0.0f, 0.9884f, 1.0f, 1.0f);
-        ImVec4 accentColor2    = ImVec4(0.2f, 0.68f, 1.0f, 1.0f);
-        ImVec4 textColor       = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
-        ImVec4 textColorDim    = ImVec4(0.75f, 0.75f, 0.75f, 1.0f);
-        ImVec4 textColorFaint  = ImVec4(0.55f, 0.55f, 0.55f, 1.0f);
-
-        float windowRounding      = 5.0f;
-        float albumArtRounding    = 14.0f;
-        float progressBarHeight   = 8.0f;
-        float progressBarRounding = 4.0f;
-        float albumArtSize        = 118.0f;
-
-        bool  enablePulse      = true;
-        bool  showAlbumArt     = true;
-        bool  showProgressBar  = true;
-        bool  showAlbumInfo    = true;
-        float windowOpacity    = 1.0f;
-
-        // Scaling
-        float uiScale           = 1.0f;
-        bool  enableAutoScaling = false;
-        float minScale          = 0.8f;
-        float maxScale          = 2.0f;
-
-        // Marquee
-        bool  enableMarquee     = true;
-        float marqueeSpeedPx    = 40.0f;
-        float marqueeWaitSec    = 0.80f;
-
-        enum class TimeDisplayMode : int
-        {
-            CenterSlash = 0,    // "0:10 / 3:45" centered
-            Corners = 1         // "0:10" left, "3:45" right
-        };
-
-        TimeDisplayMode timeDisplayMode = TimeDisplayMode::Corners;
-    };
+    // Replaces the filesystem used on the render path (e.g. a CountingFileSystem)
+    void SetFileSystem(FileSystem& fs);
 
+private:
     static WindowStyle DefaultWindowStyle() { return WindowStyle{}; }
 
     // ---------------------------
@@ -92,27 +58,40 @@ private:
     bool mPluginNameCached = false;
 
     std::unique_ptr<MediaController> mMedia;
-    MediaState mMediaState;
 
     bool   mFontsInitialized = false;
     ImFont* mFontOverlay     = nullptr;
     ImFont* mFontSettings    = nullptr;
 
-    float mPulsePhase = 0.0f;
+    // Two-slot ring: mAlbumArtTexture is the art for mAlbumArtKey (fading in while
+    // the overlay's ArtFade() runs), mAlbumArtPrev the art it replaced (fading out). The previous
+    // art stays up until the next track's texture exists. Textures are created and
+    // released on mArtLoader's thread; textures of recent tracks stay in the registry.
+    std::shared_ptr<ArtTexture> mAlbumArtTexture;
+    std::shared_ptr<ArtTexture> mAlbumArtPrev;
+    std::shared_ptr<const AlbumArtImage> mAlbumArtImage;
+    uint64_t mAlbumArtKey = 0;
+    AlbumArtRegistry<ArtTexture> mArtRegistry{8};
+    int mAlbumArtRequestPx = 0;
+
+    ArtTextureLoader mArtLoader;
+    std::shared_ptr<const AlbumArtImage> mArtRequestImage;
+    float mArtRequestRadius = 0.0f;
 
-    std::chrono::steady_clock::time_point mLastProgressAnchor;
-    int mLastPositionSec      = 0;
-    int mAnchoredPositionSec  = 0;
-    std::string mLastTrackKey;
+    // Replaced textures wait a few frames before going back to the loader thread
+    std::vector<std::pair<std::shared_ptr<ArtTexture>, int>> mArtRetiring;
 
-    std::shared_ptr<ImageWrapper> mAlbumArtTexture;
-    bool mAlbumArtLoaded = false;
-    std::string mAlbumArtPath;
+    // All render-path file access goes through here (swappable for tests/benchmarks)
+    FileSystem* mFileSystem = &DefaultFileSystem();
+    std::unique_ptr<FontFileProbe> mFontProbe;
 
     ImVector<ImWchar> mMergedGlyphRanges;
 
     WindowStyle mWindowStyle{};
 
+    // The overlay window itself (platform-neutral); draws with mWindowStyle
+    OverlayView mOverlay{ mWindowStyle };
+
     // ---------------------------
     // Helpers / rendering
     // ---------------------------
@@ -120,33 +99,30 @@ private:
     const std::string& GetPluginNameCached();
 
     void DrawHelpMarker(const char* desc);
+    void DrawProfilerStats();
 
     bool ShouldShowWindow() const;
     void UpdateWindowState();
 
     void InitializeFonts();
-    void LoadAlbumArt(const std::string& path);
+    void UpdateAlbumArtTexture();
+    void AdvanceArtFade();
+    void ShowArt(std::shared_ptr<ArtTexture> texture, std::shared_ptr<const AlbumArtImage> image, uint64_t artKey);
+    void RetireArt(std::shared_ptr<ArtTexture> texture);
+    OverlayArt GetOverlayArt() const;
 
-    void UpdateAnimation(float deltaTime);
+    void ApplyMediaRefreshWindows();
+    void ApplyAlbumCacheBudget();
 
-    int  GetCurrentDisplayPositionSec();
+    void StartTrace(const std::vector<std::string>& args);
+    void StopTrace();
+    void StartMediaRecording();
+    void StopMediaRecording();
 
     float GetDpiScaleFactor();
-    float CalculateAutoScaleFactor();
-    float GetEffectiveScaleFactor();
-    float GetScaledValue(float baseValue);
-
-    void DrawNoMusicState();
-    void DrawAlbumArtPlaceholder(float scale);
-    void DrawAlbumArt(float scale);
-
-    void DrawMusicStateCompact();
-    void DrawProgressBar();
+    void InvalidateLayoutMetrics() { mOverlay.InvalidateLayoutMetrics(); }
 
     // Persistence
     void SaveConfig();
     void LoadConfig();
-
-    friend void to_json(nlohmann::json& j, const WindowStyle& s);
-    friend void from_json(const nlohmann::json& j, WindowStyle& s);
 };
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Render-side registry of validated album art, keyed by the art's content hash
+// (MediaState::albumArtKey), so all tracks of an album share one texture.
+//
+// An entry is only added once its texture was created (or its file validated), so
+// a lookup is a short scan over a handful of pointers and never touches the disk.
+// Holds the most recently used `capacity` images; going back to a recent track
+// reuses its texture instead of uploading again.
+template <typename Texture>
+class AlbumArtRegistry
+{
+public:
+    explicit AlbumArtRegistry(size_t capacity = 8)
+        : mCapacity(std::max<size_t>(1, capacity))
+    {
+    }
+
+    // nullptr when the key has no validated entry
+    std::shared_ptr<Texture> Find(uint64_t key)
+    {
+        const auto it = std::find_if(mEntries.begin(), mEntries.end(), [&](const auto& e) { return e.first == key; });
+        if (it == mEntries.end()) return nullptr;
+
+        // Most recent first
+        std::rotate(mEntries.begin(), it, it + 1);
+        return mEntries.front().second;
+    }
+
+    // Returns the entry it replaced or evicted, so the caller decides where it is released
+    std::shared_ptr<Texture> Insert(uint64_t key, std::shared_ptr<Texture> texture)
+    {
+        std::shared_ptr<Texture> dropped;
+
+        const auto it = std::find_if(mEntries.begin(), mEntries.end(), [&](const auto& e) { return e.first == key; });
+        if (it != mEntries.end())
+        {
+            dropped = std::move(it->second);
+            mEntries.erase(it);
+        }
+        else if (mEntries.size() >= mCapacity)
+        {
+            dropped = std::move(mEntries.back().second);
+            mEntries.pop_back();
+        }
+
+        mEntries.insert(mEntries.begin(), { key, std::move(texture) });
+        return dropped;
+    }
+
+    void Erase(uint64_t key)
+    {
+        mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(), [&](const auto& e) { return e.first == key; }), mEntries.end());
+    }
+
+    void Clear() { mEntries.clear(); }
+    size_t Size() const { return mEntries.size(); }
+
+private:
+    size_t mCapacity;
+    std::vector<std::pair<uint64_t, std::shared_ptr<Texture>>> mEntries;
+};
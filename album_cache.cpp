@@ -0,0 +1,565 @@
+#include "album_cache.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr const char* kIndexFileName = "index.txt";
+	constexpr const char* kPackFileName = "art.pack";
+
+	// Loose files larger than this are not worth importing (downloads are capped far below)
+	constexpr uintmax_t kMaxImportBytes = 64u * 1024u * 1024u;
+
+	// Index is rewritten at most this often while entries change
+	constexpr auto kIndexFlushInterval = std::chrono::seconds(10);
+
+	// Pixel blobs are the rows, then the backdrop rows (if any), then this trailer, so
+	// reading one back into AlbumArtImage::rgba is a single copy plus a shrink
+	struct PixelTrailer
+	{
+		char magic[4];
+		uint16_t width;
+		uint16_t height;
+		uint8_t flags;
+		uint8_t accent[3];
+		uint8_t accent2[3];
+		uint8_t backdrop;   // backdrop edge in pixels, 0 if none
+	};
+	static_assert(sizeof(PixelTrailer) == 16, "pixel trailer layout");
+
+	constexpr char kPixelMagic[4] = { 'R', 'R', 'P', 'X' };
+	constexpr uint8_t kPixelPremultiplied = 1;
+	constexpr uint8_t kPixelOpaque = 2;
+	constexpr uint8_t kPixelPalette = 4;         // accent fields hold the extraction result
+	constexpr uint8_t kPixelPaletteUsable = 8;
+
+	ArtHash PixelKey(ArtHash hash, int px)
+	{
+		uint64_t h = Fnv1a64Append(kFnv1a64Offset, std::string_view(reinterpret_cast<const char*>(&hash), sizeof(hash)));
+		h = Fnv1a64Append(h, std::string_view(reinterpret_cast<const char*>(&px), sizeof(px)));
+		return h == kNoTrack ? 1 : h;
+	}
+
+	int64_t UnixNow()
+	{
+		return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+
+	bool ParseHex(const std::string& s, TrackId& out)
+	{
+		if (s.empty() || s.size() > 16) return false;
+
+		TrackId v = 0;
+		for (const char c : s)
+		{
+			v <<= 4;
+			if (c >= '0' && c <= '9')      v |= static_cast<TrackId>(c - '0');
+			else if (c >= 'a' && c <= 'f') v |= static_cast<TrackId>(c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F') v |= static_cast<TrackId>(c - 'A' + 10);
+			else return false;
+		}
+
+		out = v;
+		return v != kNoTrack;
+	}
+}
+
+ArtHash ComputeArtHash(std::string_view bytes)
+{
+	const uint64_t h = Fnv1a64(bytes);
+	return h == kNoTrack ? 1 : h;
+}
+
+AlbumCache::~AlbumCache()
+{
+	Close();
+}
+
+bool AlbumCache::Open(const std::filesystem::path& dir)
+{
+	Close();
+
+	std::error_code ec;
+	std::filesystem::create_directories(dir, ec);
+	if (ec) return false;
+
+	if (!pack_.Open(dir / kPackFileName)) return false;
+
+	{
+		std::lock_guard lk(mutex_);
+		dir_ = dir;
+		lru_.clear();
+		blobs_.clear();
+		tracks_.clear();
+		albums_.clear();
+		totalBytes_ = 0;
+		stop_ = false;
+
+		// First run (or lost index): keys are rebuilt as tracks come by, blobs come from the pack
+		if (!LoadIndex()) dirty_ = true;
+
+		ImportLooseFiles();
+		ReconcileWithPack();
+	}
+
+	thread_ = std::thread([this] { EvictionLoop(); });
+	return true;
+}
+
+void AlbumCache::Close()
+{
+	{
+		std::lock_guard lk(mutex_);
+		stop_ = true;
+	}
+	cv_.notify_all();
+
+	if (thread_.joinable()) thread_.join();
+
+	pack_.Close();
+}
+
+void AlbumCache::SetBudget(Budget budget)
+{
+	{
+		std::lock_guard lk(mutex_);
+		budget_ = budget;
+	}
+	cv_.notify_one();
+}
+
+// Holds mutex_
+void AlbumCache::Touch(List::iterator it)
+{
+	it->lastAccess = UnixNow();
+	lru_.splice(lru_.begin(), lru_, it);
+	dirty_ = true;
+}
+
+std::optional<ArtHash> AlbumCache::Resolve(TrackId trackId, uint64_t albumKey)
+{
+	std::lock_guard lk(mutex_);
+
+	auto lookup = [&](auto& keys, uint64_t key) -> std::optional<ArtHash>
+	{
+		if (key == kNoTrack) return std::nullopt;
+
+		const auto it = keys.find(key);
+		if (it == keys.end()) return std::nullopt;
+
+		if (!blobs_.count(it->second))
+		{
+			// Blob was evicted; drop the dangling key
+			keys.erase(it);
+			dirty_ = true;
+			return std::nullopt;
+		}
+		return it->second;
+	};
+
+	std::optional<ArtHash> hash = lookup(tracks_, trackId);
+	if (!hash)
+	{
+		hash = lookup(albums_, albumKey);
+		if (!hash) return std::nullopt;
+
+		++albumHits_;
+		bytesSaved_ += blobs_[*hash]->bytes;
+		tracks_[trackId] = *hash;
+	}
+
+	Touch(blobs_[*hash]);
+	return hash;
+}
+
+bool AlbumCache::Read(ArtHash hash, std::vector<uint8_t>& out)
+{
+	if (pack_.Read(hash, out) && !out.empty()) return true;
+
+	Erase(hash);
+	return false;
+}
+
+ArtHash AlbumCache::Store(TrackId trackId, uint64_t albumKey, const std::vector<uint8_t>& bytes)
+{
+	const ArtHash hash = ComputeArtHash(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+
+	{
+		std::lock_guard lk(mutex_);
+
+		if (const auto it = blobs_.find(hash); it != blobs_.end())
+		{
+			// Same image under another key: nothing new on disk
+			++dedupeHits_;
+			bytesSaved_ += it->second->bytes;
+			Touch(it->second);
+			MapKeys(trackId, albumKey, hash);
+			return hash;
+		}
+	}
+
+	// Not cached if the append fails; the caller can still show the bytes it has
+	if (bytes.empty() || !pack_.Append(hash, bytes.data(), static_cast<uint32_t>(bytes.size()))) return hash;
+
+	{
+		std::lock_guard lk(mutex_);
+
+		AddBlob(Blob{ hash, bytes.size(), 0 });
+		Touch(blobs_[hash]);
+		MapKeys(trackId, albumKey, hash);
+	}
+	cv_.notify_one();
+	return hash;
+}
+
+bool AlbumCache::ReadPixels(ArtHash hash, int px, AlbumArtImage& out)
+{
+	const ArtHash key = PixelKey(hash, px);
+
+	{
+		std::lock_guard lk(mutex_);
+
+		const auto it = blobs_.find(key);
+		if (it == blobs_.end()) return false;
+		Touch(it->second);
+	}
+
+	PixelTrailer t{};
+	bool ok = pack_.Read(key, out.rgba) && out.rgba.size() >= sizeof(t);
+	if (ok)
+	{
+		std::memcpy(&t, out.rgba.data() + out.rgba.size() - sizeof(t), sizeof(t));
+		ok = std::memcmp(t.magic, kPixelMagic, sizeof(kPixelMagic)) == 0 &&
+			out.rgba.size() - sizeof(t) == (static_cast<size_t>(t.width) * t.height + static_cast<size_t>(t.backdrop) * t.backdrop) * 4;
+	}
+
+	if (!ok)
+	{
+		out.rgba.clear();
+		Erase(key);
+		return false;
+	}
+
+	const size_t pixelBytes = static_cast<size_t>(t.width) * t.height * 4;
+	out.backdropSize = t.backdrop;
+	out.backdrop.assign(out.rgba.begin() + pixelBytes, out.rgba.end() - sizeof(t));
+
+	out.rgba.resize(pixelBytes);
+	out.width = t.width;
+	out.height = t.height;
+	out.premultiplied = (t.flags & kPixelPremultiplied) != 0;
+	out.opaque = (t.flags & kPixelOpaque) != 0;
+
+	out.palette = ArtPalette{};
+	out.palette.extracted = (t.flags & kPixelPalette) != 0;
+	out.palette.usable = (t.flags & kPixelPaletteUsable) != 0;
+	std::memcpy(out.palette.accent, t.accent, sizeof(t.accent));
+	std::memcpy(out.palette.accent2, t.accent2, sizeof(t.accent2));
+	return true;
+}
+
+void AlbumCache::StorePixels(ArtHash hash, int px, const AlbumArtImage& image)
+{
+	if (image.width <= 0 || image.height <= 0 || image.width > 0xFFFF || image.height > 0xFFFF) return;
+	if (image.rgba.size() != static_cast<size_t>(image.width) * image.height * 4) return;
+
+	const bool backdrop = image.backdropSize > 0 && image.backdropSize <= 0xFF &&
+		image.backdrop.size() == static_cast<size_t>(image.backdropSize) * image.backdropSize * 4;
+
+	PixelTrailer t{};
+	std::memcpy(t.magic, kPixelMagic, sizeof(kPixelMagic));
+	t.width = static_cast<uint16_t>(image.width);
+	t.height = static_cast<uint16_t>(image.height);
+	t.flags = static_cast<uint8_t>((image.premultiplied ? kPixelPremultiplied : 0) | (image.opaque ? kPixelOpaque : 0) |
+		(image.palette.extracted ? kPixelPalette : 0) | (image.palette.usable ? kPixelPaletteUsable : 0));
+	std::memcpy(t.accent, image.palette.accent, sizeof(t.accent));
+	std::memcpy(t.accent2, image.palette.accent2, sizeof(t.accent2));
+	t.backdrop = static_cast<uint8_t>(backdrop ? image.backdropSize : 0);
+
+	std::vector<uint8_t> blob;
+	blob.reserve(image.rgba.size() + (backdrop ? image.backdrop.size() : 0) + sizeof(t));
+	blob.insert(blob.end(), image.rgba.begin(), image.rgba.end());
+	if (backdrop) blob.insert(blob.end(), image.backdrop.begin(), image.backdrop.end());
+	blob.insert(blob.end(), reinterpret_cast<const uint8_t*>(&t), reinterpret_cast<const uint8_t*>(&t) + sizeof(t));
+
+	const ArtHash key = PixelKey(hash, px);
+	if (!pack_.Append(key, blob.data(), static_cast<uint32_t>(blob.size()))) return;
+
+	{
+		std::lock_guard lk(mutex_);
+
+		AddBlob(Blob{ key, blob.size(), 0, true });
+		Touch(blobs_[key]);
+	}
+	cv_.notify_one();
+}
+
+void AlbumCache::Erase(ArtHash hash)
+{
+	{
+		std::lock_guard lk(mutex_);
+
+		const auto it = blobs_.find(hash);
+		if (it != blobs_.end())
+		{
+			totalBytes_ -= it->second->bytes;
+			lru_.erase(it->second);
+			blobs_.erase(it);
+			dirty_ = true;
+		}
+	}
+
+	pack_.Remove(hash);
+}
+
+AlbumCacheStats AlbumCache::GetStats() const
+{
+	std::lock_guard lk(mutex_);
+
+	AlbumCacheStats stats;
+	for (const Blob& b : lru_) ++(b.pixels ? stats.pixelBlobs : stats.blobs);
+	stats.keys = tracks_.size();
+	stats.albumHits = albumHits_;
+	stats.dedupeHits = dedupeHits_;
+	stats.bytesSaved = bytesSaved_;
+	stats.evictionPasses = evictionPasses_;
+
+	const ArtPackStats pack = pack_.GetStats();
+	stats.packBytes = pack.fileBytes;
+	stats.deadBytes = pack.deadBytes;
+	return stats;
+}
+
+// Holds mutex_ (appends: callers add blobs most recent first)
+void AlbumCache::AddBlob(const Blob& blob)
+{
+	if (blobs_.count(blob.hash)) return;
+
+	lru_.push_back(blob);
+	blobs_[blob.hash] = std::prev(lru_.end());
+	totalBytes_ += blob.bytes;
+}
+
+// Holds mutex_
+void AlbumCache::MapKeys(TrackId trackId, uint64_t albumKey, ArtHash hash)
+{
+	if (trackId != kNoTrack) tracks_[trackId] = hash;
+	if (albumKey != kNoTrack) albums_[albumKey] = hash;
+	dirty_ = true;
+}
+
+bool AlbumCache::OverBudget() const
+{
+	return totalBytes_ > budget_.maxBytes || lru_.size() > budget_.maxEntries;
+}
+
+// Holds mutex_. The most recent blob is never evicted, so one blob larger than the
+// whole budget stays over it without anything left to do.
+bool AlbumCache::CanEvict() const
+{
+	return OverBudget() && lru_.size() > 1;
+}
+
+// Holds mutex_
+bool AlbumCache::LoadIndex()
+{
+	std::ifstream in(dir_ / kIndexFileName);
+	if (!in.is_open()) return false;
+
+	std::string line;
+	while (std::getline(in, line))
+	{
+		std::istringstream ss(line);
+		std::string kind, first, second;
+		if (!(ss >> kind)) continue;
+
+		if (kind == "b" || kind == "p")
+		{
+			Blob b;
+			b.pixels = kind == "p";
+			if (ss >> first >> b.bytes >> b.lastAccess && ParseHex(first, b.hash)) AddBlob(b);
+		}
+		else if (kind == "t" || kind == "a")
+		{
+			uint64_t key = 0;
+			ArtHash hash = 0;
+			if (ss >> first >> second && ParseHex(first, key) && ParseHex(second, hash))
+				(kind == "t" ? tracks_ : albums_)[key] = hash;
+		}
+		else
+		{
+			// Pre-dedupe index: "<trackId>\t<bytes>\t<lastAccess>", file named by TrackId
+			Blob b;
+			if (ParseHex(kind, b.hash) && ss >> b.bytes >> b.lastAccess)
+			{
+				AddBlob(b);
+				tracks_[b.hash] = b.hash;
+				dirty_ = true;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Holds mutex_. Moves `<hex>.png` files left by older versions into the pack. Their
+// stem was the TrackId (or, briefly, the content hash), so it stays mapped as a track key.
+void AlbumCache::ImportLooseFiles()
+{
+	std::error_code ec;
+	for (const auto& f : std::filesystem::directory_iterator(dir_, ec))
+	{
+		const auto& p = f.path();
+		if (p.extension() != ".png") continue;
+
+		TrackId stem = kNoTrack;
+		std::error_code fec;
+		const uintmax_t size = f.file_size(fec);
+		if (!ParseHex(p.stem().string(), stem) || fec || size == 0 || size > kMaxImportBytes) continue;
+
+		std::vector<uint8_t> bytes(static_cast<size_t>(size));
+		{
+			std::ifstream in(p, std::ios::binary);
+			if (!in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) continue;
+		}
+
+		const ArtHash hash = ComputeArtHash(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+		if (!pack_.Append(hash, bytes.data(), static_cast<uint32_t>(bytes.size()))) continue;
+
+		AddBlob(Blob{ hash, bytes.size(), UnixNow() });
+		tracks_[stem] = hash;
+		dirty_ = true;
+
+		std::filesystem::remove(p, fec);
+	}
+}
+
+// Holds mutex_. The pack is the source of truth for which blobs exist: index entries
+// without a blob are dropped, blobs the index missed (index not flushed) are adopted
+// as least recently used.
+void AlbumCache::ReconcileWithPack()
+{
+	for (auto it = lru_.begin(); it != lru_.end();)
+	{
+		if (pack_.Contains(it->hash))
+		{
+			++it;
+			continue;
+		}
+
+		totalBytes_ -= it->bytes;
+		blobs_.erase(it->hash);
+		it = lru_.erase(it);
+		dirty_ = true;
+	}
+
+	for (const auto& [hash, size] : pack_.Entries())
+	{
+		if (blobs_.count(hash)) continue;
+
+		// Decoded copies are told apart by their trailer, like ReadPixels does
+		PixelTrailer t{};
+		const bool pixels = pack_.ReadTail(hash, &t, sizeof(t)) &&
+			std::memcmp(t.magic, kPixelMagic, sizeof(kPixelMagic)) == 0;
+
+		AddBlob(Blob{ hash, size, 0, pixels });
+		dirty_ = true;
+	}
+}
+
+// Holds mutex_
+std::string AlbumCache::SerializeIndex() const
+{
+	std::string out;
+	out.reserve((lru_.size() + tracks_.size() + albums_.size()) * 40);
+
+	for (const Blob& b : lru_)
+	{
+		out += (b.pixels ? "p\t" : "b\t") + TrackIdToHex(b.hash) + '\t' + std::to_string(b.bytes) + '\t' + std::to_string(b.lastAccess) + '\n';
+	}
+
+	// Keys of evicted blobs are not written back
+	auto keys = [&](const char* kind, const auto& map)
+	{
+		for (const auto& [key, hash] : map)
+		{
+			if (blobs_.count(hash))
+				out += std::string(kind) + '\t' + TrackIdToHex(key) + '\t' + TrackIdToHex(hash) + '\n';
+		}
+	};
+	keys("t", tracks_);
+	keys("a", albums_);
+
+	return out;
+}
+
+bool AlbumCache::WriteIndex(const std::string& contents) const
+{
+	const auto path = dir_ / kIndexFileName;
+	auto tmp = path;
+	tmp += ".tmp";
+
+	{
+		std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+		if (!f.is_open()) return false;
+		f.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+		if (!f) return false;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmp, path, ec);
+	if (ec) std::filesystem::remove(tmp, ec);
+	return !ec;
+}
+
+void AlbumCache::EvictionLoop()
+{
+	std::unique_lock lk(mutex_);
+
+	while (true)
+	{
+		cv_.wait_for(lk, kIndexFlushInterval, [this] { return stop_ || CanEvict(); });
+		++evictionPasses_;
+
+		// Evict least recently used (never the entry in use right now)
+		std::vector<ArtHash> victims;
+		while (CanEvict())
+		{
+			const Blob& b = lru_.back();
+			victims.push_back(b.hash);
+			totalBytes_ -= b.bytes;
+			blobs_.erase(b.hash);
+			lru_.pop_back();
+			dirty_ = true;
+		}
+
+		const bool writeIndex = dirty_;
+		std::string index;
+		if (writeIndex)
+		{
+			index = SerializeIndex();
+			dirty_ = false;
+		}
+
+		const bool stop = stop_;
+
+		// Disk work without the lock so lookups from the media worker never wait on it
+		lk.unlock();
+
+		for (const ArtHash id : victims) pack_.Remove(id);
+
+		// Reads of the pack wait while it is rewritten; the key index stays available
+		if (pack_.NeedsCompaction()) pack_.Compact();
+
+		const bool written = !writeIndex || WriteIndex(index);
+
+		lk.lock();
+		if (!written) dirty_ = true;
+		if (stop) break;
+	}
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "art_pack.h"
+#include "media.h"
+#include "track_id.h"
+
+// ------------------------------------------------------------
+// album_cache directory manager
+//
+// Two-level, de-duplicated index:
+//   track key (TrackId) / album key (ComputeAlbumKey) -> content hash of the image bytes
+//   content hash -> one blob in `art.pack` (see art_pack.h)
+//   content hash + display size -> decoded pixels, palette and blurred backdrop, so
+//                                  a repeat load skips decoding, extraction and blur
+// Every track of an album resolves to the same blob (and, downstream, the same
+// GPU texture); tracks after the first hit the album key and never download.
+//
+// Keys and LRU order are persisted as `index.txt`, blobs most recent first:
+//   b <hash> <bytes> <lastAccessUnixSec>      (encoded image)
+//   p <key> <bytes> <lastAccessUnixSec>       (decoded pixels)
+//   t <trackId> <hash>
+//   a <albumKey> <hash>
+// Startup reads the index and reconciles it with the pack; loose .png files
+// from older versions are moved into the pack once. Key lookups never touch the
+// disk and blob reads are a copy out of the mapping. A background thread evicts
+// least-recently-used blobs while over the byte/entry budget, compacts the pack
+// once enough of it is dead, and rewrites the index when it changed; keys
+// pointing at evicted blobs are dropped lazily.
+// ------------------------------------------------------------
+
+using ArtHash = uint64_t;
+
+// FNV-1a 64 of the encoded image bytes (never kNoTrack)
+ArtHash ComputeArtHash(std::string_view bytes);
+
+struct AlbumCacheBudget
+{
+    uint64_t maxBytes   = 256ull * 1024 * 1024;
+    size_t   maxEntries = 2000;
+};
+
+struct AlbumCacheStats
+{
+    size_t   blobs          = 0;   // stored images
+    size_t   pixelBlobs     = 0;   // decoded copies at display size
+    size_t   keys           = 0;   // track keys mapped onto them
+    uint64_t albumHits      = 0;   // resolved through the album key (download skipped)
+    uint64_t dedupeHits     = 0;   // downloaded, but the bytes were already stored
+    uint64_t bytesSaved     = 0;   // not downloaded / not written thanks to the two hits above
+    uint64_t packBytes      = 0;   // art.pack size on disk
+    uint64_t deadBytes      = 0;   // evicted, reclaimed by the next compaction
+    uint64_t evictionPasses = 0;   // eviction thread wake-ups (budget, index flush, stop)
+};
+
+class AlbumCache
+{
+public:
+    using Budget = AlbumCacheBudget;
+
+    AlbumCache() = default;
+    ~AlbumCache();
+
+    AlbumCache(const AlbumCache&) = delete;
+    AlbumCache& operator=(const AlbumCache&) = delete;
+
+    // Creates the directory, loads (or rebuilds) the index, starts the eviction thread
+    bool Open(const std::filesystem::path& dir);
+
+    // Stops the thread and writes the index
+    void Close();
+
+    // Any time, also before Open()
+    void SetBudget(Budget budget);
+
+    // Content hash for the track (track key first, then album key); marks the blob
+    // most recently used. An album hit also maps the track key.
+    std::optional<ArtHash> Resolve(TrackId trackId, uint64_t albumKey);
+
+    // Copies the stored image bytes; a blob that cannot be read is forgotten
+    bool Read(ArtHash hash, std::vector<uint8_t>& out);
+
+    // Stores downloaded bytes (one append, skipped when the same image is already
+    // stored) and maps the keys onto them. Returns the content hash either way.
+    ArtHash Store(TrackId trackId, uint64_t albumKey, const std::vector<uint8_t>& bytes);
+
+    // Decoded pixels of `hash` at the `px` display size (see StorePixels); false on a miss
+    bool ReadPixels(ArtHash hash, int px, AlbumArtImage& out);
+
+    // Persists decoded pixels (rows tightly packed, any alpha mode), palette and backdrop under hash + px
+    void StorePixels(ArtHash hash, int px, const AlbumArtImage& image);
+
+    // Forget (and drop from the pack) a blob that turned out to be broken
+    void Erase(ArtHash hash);
+
+    AlbumCacheStats GetStats() const;
+
+private:
+    struct Blob
+    {
+        ArtHash hash = kNoTrack;
+        uint64_t bytes = 0;
+        int64_t lastAccess = 0;   // unix seconds
+        bool pixels = false;      // decoded copy, not an encoded image
+    };
+
+    using List = std::list<Blob>;
+
+    void Touch(List::iterator it);
+    bool LoadIndex();
+    void ImportLooseFiles();
+    void ReconcileWithPack();
+    void AddBlob(const Blob& blob);
+    void MapKeys(TrackId trackId, uint64_t albumKey, ArtHash hash);
+    std::string SerializeIndex() const;
+    bool WriteIndex(const std::string& contents) const;
+    void EvictionLoop();
+    bool OverBudget() const;
+    bool CanEvict() const;
+
+    std::filesystem::path dir_;
+    ArtPack pack_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    List lru_;   // front: most recent
+    std::unordered_map<ArtHash, List::iterator> blobs_;
+    std::unordered_map<TrackId, ArtHash> tracks_;
+    std::unordered_map<uint64_t, ArtHash> albums_;
+    uint64_t totalBytes_ = 0;
+    Budget budget_{};
+    bool dirty_ = false;
+    bool stop_ = false;
+
+    uint64_t albumHits_ = 0;
+    uint64_t dedupeHits_ = 0;
+    uint64_t bytesSaved_ = 0;
+    uint64_t evictionPasses_ = 0;
+
+    std::thread thread_;
+};
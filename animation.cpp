@@ -0,0 +1,132 @@
+#include "animation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "overlay_core.h"
+
+// ------------------------------------------------------------
+// FrameClock
+// ------------------------------------------------------------
+
+const FrameTime& FrameClock::Tick(uint64_t frameIndex, Clock::time_point now)
+{
+    if (!mStarted)
+    {
+        mStarted = true;
+        mStart = now;
+        mFrame = FrameTime{ frameIndex, now, 0.0, 0.0f };
+        return mFrame;
+    }
+
+    if (frameIndex == mFrame.index) return mFrame;
+
+    const float dt = std::chrono::duration<float>(now - mFrame.now).count();
+    mFrame.index = frameIndex;
+    mFrame.now = now;
+    mFrame.seconds = std::chrono::duration<double>(now - mStart).count();
+    mFrame.dt = std::clamp(dt, 0.0f, kMaxDtSec);
+    return mFrame;
+}
+
+// ------------------------------------------------------------
+// Animations
+// ------------------------------------------------------------
+
+void Tween::Start(const FrameTime& frame, float durationSec)
+{
+    mStartSec = frame.seconds;
+    mDurationSec = durationSec;
+    mValue = durationSec > 0.0f ? 0.0f : 1.0f;
+}
+
+AnimationState Tween::Update(const FrameTime& frame)
+{
+    if (mValue >= 1.0f) return {};
+
+    const float elapsed = static_cast<float>(frame.seconds - mStartSec);
+    mValue = std::min(1.0f, elapsed / mDurationSec);
+    return { true, 0.0 };
+}
+
+AnimationState Oscillator::Update(const FrameTime& frame)
+{
+    if (!mRunning) return {};
+
+    constexpr float kTwoPi = 6.2831853f;
+    mPhase = std::fmod(mPhase + frame.dt * mRate, kTwoPi);
+    return { true, 0.0 };
+}
+
+void MarqueeClock::AddLine(float overflow, float speedPxPerSec, float waitTimeSec)
+{
+    mLines.push_back(Line{ overflow, speedPxPerSec, waitTimeSec });
+}
+
+AnimationState MarqueeClock::Update(const FrameTime& frame)
+{
+    if (mRestart)
+    {
+        mRestart = false;
+        mStartSec = frame.seconds;
+    }
+    mTime = static_cast<float>(frame.seconds - mStartSec);
+
+    AnimationState state;
+    for (const Line& line : mLines)
+    {
+        const double idle = ComputeMarqueeIdleTime(line.overflow, line.speed, line.wait, mTime);
+        if (std::isinf(idle)) continue;
+
+        state.active = true;
+        state.idleSec = std::min(state.idleSec, idle);
+    }
+    return state;
+}
+
+// ------------------------------------------------------------
+// AnimationTimeline
+// ------------------------------------------------------------
+
+const char* AnimationName(AnimationId id)
+{
+    switch (id)
+    {
+    case AnimationId::Pulse:   return "Pulse";
+    case AnimationId::Marquee: return "Marquee";
+    case AnimationId::ArtFade: return "Art fade";
+    case AnimationId::Toasts:  return "Toasts";
+    default:                   return "?";
+    }
+}
+
+const FrameTime& AnimationTimeline::BeginFrame(uint64_t frameIndex, Clock::time_point now)
+{
+    const FrameTime& frame = mClock.Tick(frameIndex, now);
+    if (mEvaluated && mEvaluatedFrame == frame.index) return frame;
+
+    mEvaluated = true;
+    mEvaluatedFrame = frame.index;
+
+    mStates[static_cast<size_t>(AnimationId::Pulse)] = mPulse.Update(frame);
+    mStates[static_cast<size_t>(AnimationId::Marquee)] = mMarquee.Update(frame);
+    mStates[static_cast<size_t>(AnimationId::ArtFade)] = mArtFade.Update(frame);
+    return frame;
+}
+
+void AnimationTimeline::Report(AnimationId id, const AnimationState& state)
+{
+    mStates[static_cast<size_t>(id)] = state;
+}
+
+double AnimationTimeline::NextChangeSec() const
+{
+    double next = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < mStates.size(); ++i)
+    {
+        // Toasts are windows of their own, drawn every frame anyway
+        if (static_cast<AnimationId>(i) == AnimationId::Toasts) continue;
+        if (mStates[i].active) next = std::min(next, mStates[i].idleSec);
+    }
+    return next;
+}
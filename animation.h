@@ -0,0 +1,163 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// ------------------------------------------------------------
+// Frame clock and the overlay's animations.
+//
+// Every animation reads the time of the frame from one FrameClock, ticked once per
+// rendered frame, so a second hook calling in during the same frame does not advance
+// anything twice and all parts of a frame agree on the time. AnimationTimeline is the
+// registry: it ticks the clock and evaluates each animation once per frame, keeping
+// what each reported (active, and how long until it changes again). Idle throttling
+// (RedrawScheduler) wakes for the earliest change and ignores inactive animations.
+// ------------------------------------------------------------
+
+struct FrameTime
+{
+    uint64_t index = 0;                               // renderer frame it was ticked for
+    std::chrono::steady_clock::time_point now{};
+    double seconds = 0.0;                             // since the clock started
+    float dt = 0.0f;                                  // since the previous frame, clamped
+};
+
+class FrameClock
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // A stall (loading screen, alt-tab) does not jump animations forward
+    static constexpr float kMaxDtSec = 0.25f;
+
+    // Once per rendered frame; repeated calls for the same `frameIndex` return the same time
+    const FrameTime& Tick(uint64_t frameIndex, Clock::time_point now);
+
+    const FrameTime& Current() const { return mFrame; }
+
+private:
+    FrameTime mFrame;
+    Clock::time_point mStart{};
+    bool mStarted = false;
+};
+
+// What an animation reported for the frame
+struct AnimationState
+{
+    bool active = false;
+    double idleSec = std::numeric_limits<double>::infinity();   // until it changes again; 0 = every frame
+};
+
+// 0 -> 1 over a duration (crossfades). Starts finished.
+class Tween
+{
+public:
+    // A duration <= 0 finishes at once
+    void Start(const FrameTime& frame, float durationSec);
+    void Finish() { mValue = 1.0f; }
+
+    float Value() const { return mValue; }
+    bool Active() const { return mValue < 1.0f; }
+
+    AnimationState Update(const FrameTime& frame);
+
+private:
+    double mStartSec = 0.0;
+    float mDurationSec = 0.0f;
+    float mValue = 1.0f;
+};
+
+// Endless phase in [0, 2pi) that advances only while running (pulse)
+class Oscillator
+{
+public:
+    explicit Oscillator(float radiansPerSec) : mRate(radiansPerSec) {}
+
+    void SetRunning(bool running) { mRunning = running; }
+    float Phase() const { return mPhase; }
+
+    AnimationState Update(const FrameTime& frame);
+
+private:
+    float mRate;
+    float mPhase = 0.0f;
+    bool mRunning = false;
+};
+
+// Time base of the ping-pong marquees. Restarts with each track, so a new title
+// always begins with its pause; the lines drawn by the last redraw tell it when the
+// text next moves.
+class MarqueeClock
+{
+public:
+    void Restart() { mRestart = true; }
+    float Time() const { return mTime; }
+
+    // Lines are registered while the overlay is drawn and kept for replayed frames
+    void ClearLines() { mLines.clear(); }
+    void AddLine(float overflow, float speedPxPerSec, float waitTimeSec);
+
+    AnimationState Update(const FrameTime& frame);
+
+private:
+    struct Line
+    {
+        float overflow;
+        float speed;
+        float wait;
+    };
+
+    std::vector<Line> mLines;
+    double mStartSec = 0.0;
+    float mTime = 0.0f;
+    bool mRestart = true;
+};
+
+enum class AnimationId : uint8_t
+{
+    Pulse,
+    Marquee,
+    ArtFade,
+    Toasts,
+
+    Count
+};
+
+const char* AnimationName(AnimationId id);
+
+class AnimationTimeline
+{
+public:
+    using Clock = FrameClock::Clock;
+
+    // Once per rendered frame: ticks the clock and evaluates every animation
+    const FrameTime& BeginFrame(uint64_t frameIndex, Clock::time_point now);
+    const FrameTime& Frame() const { return mClock.Current(); }
+
+    Oscillator& Pulse() { return mPulse; }
+    MarqueeClock& Marquee() { return mMarquee; }
+    Tween& ArtFade() { return mArtFade; }
+    const Oscillator& Pulse() const { return mPulse; }
+    const MarqueeClock& Marquee() const { return mMarquee; }
+    const Tween& ArtFade() const { return mArtFade; }
+
+    // For animations evaluated elsewhere (toasts are drawn by notification.cpp)
+    void Report(AnimationId id, const AnimationState& state);
+
+    const AnimationState& State(AnimationId id) const { return mStates[static_cast<size_t>(id)]; }
+
+    // Seconds until the first active animation changes; infinity when all are idle
+    double NextChangeSec() const;
+
+private:
+    FrameClock mClock;
+    Oscillator mPulse{ 2.0f };
+    MarqueeClock mMarquee;
+    Tween mArtFade;
+
+    std::array<AnimationState, static_cast<size_t>(AnimationId::Count)> mStates{};
+    uint64_t mEvaluatedFrame = 0;
+    bool mEvaluated = false;
+};
@@ -0,0 +1,366 @@
+#include "art_pack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace
+{
+	constexpr char kMagic[4] = { 'R', 'R', 'A', 'P' };
+	constexpr uint32_t kVersion = 1;
+
+	constexpr uint32_t kMinSlots = 1024;
+
+	// Data region headroom per growth step
+	constexpr uint64_t kMinGrowBytes = 1ull << 20;
+
+	// Compact once this much is dead and it is at least half of what is live
+	constexpr uint64_t kMinDeadBytes = 4ull << 20;
+
+	enum SlotState : uint32_t
+	{
+		kEmpty = 0,
+		kLive = 1,
+		kTombstone = 2,
+	};
+
+	struct PackHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t slotCount;    // power of two
+		uint32_t liveCount;
+		uint32_t tombstones;
+		uint32_t reserved0;
+		uint64_t dataStart;    // first byte after the index
+		uint64_t dataEnd;      // next append offset
+		uint64_t liveBytes;
+		uint64_t deadBytes;
+		uint64_t reserved1;
+	};
+
+	struct PackSlot
+	{
+		uint64_t hash;
+		uint64_t offset;
+		uint32_t size;
+		uint32_t state;
+	};
+
+	static_assert(sizeof(PackHeader) == 64, "pack header layout");
+	static_assert(sizeof(PackSlot) == 24, "pack slot layout");
+
+	PackHeader* HeaderOf(uint8_t* base) { return reinterpret_cast<PackHeader*>(base); }
+	const PackHeader* HeaderOf(const uint8_t* base) { return reinterpret_cast<const PackHeader*>(base); }
+	PackSlot* SlotsOf(uint8_t* base) { return reinterpret_cast<PackSlot*>(base + sizeof(PackHeader)); }
+	const PackSlot* SlotsOf(const uint8_t* base) { return reinterpret_cast<const PackSlot*>(base + sizeof(PackHeader)); }
+
+	uint64_t DataStartFor(uint32_t slotCount)
+	{
+		return sizeof(PackHeader) + static_cast<uint64_t>(slotCount) * sizeof(PackSlot);
+	}
+
+	// Smallest table that stays at most half full with `entries`
+	uint32_t SlotCountFor(uint64_t entries)
+	{
+		uint32_t count = kMinSlots;
+		while (static_cast<uint64_t>(count) < entries * 2) count <<= 1;
+		return count;
+	}
+
+	// First free (empty or tombstoned) slot on the probe sequence of `hash`
+	uint32_t FreeSlot(const PackSlot* slots, uint32_t slotCount, uint64_t hash)
+	{
+		const uint32_t mask = slotCount - 1;
+		uint32_t i = static_cast<uint32_t>(hash) & mask;
+		while (slots[i].state == kLive) i = (i + 1) & mask;
+		return i;
+	}
+}
+
+bool ArtPack::Open(const std::filesystem::path& path)
+{
+	std::unique_lock lk(mutex_);
+
+	file_.Close();
+	path_ = path;
+
+	if (!file_.Open(path_, sizeof(PackHeader))) return false;
+	if (Validate()) return true;
+
+	// New file, or one we cannot trust: start over
+	return Create(kMinSlots);
+}
+
+void ArtPack::Close()
+{
+	std::unique_lock lk(mutex_);
+	file_.Close();
+}
+
+// Holds mutex_ exclusively
+bool ArtPack::Create(uint32_t slotCount)
+{
+	const uint64_t dataStart = DataStartFor(slotCount);
+	if (!file_.Resize(dataStart + kMinGrowBytes)) return false;
+
+	std::memset(file_.Data(), 0, static_cast<size_t>(dataStart));
+
+	PackHeader* h = HeaderOf(file_.Data());
+	std::memcpy(h->magic, kMagic, sizeof(kMagic));
+	h->version = kVersion;
+	h->slotCount = slotCount;
+	h->dataStart = dataStart;
+	h->dataEnd = dataStart;
+	return true;
+}
+
+bool ArtPack::Validate() const
+{
+	if (!file_.IsOpen() || file_.Size() < sizeof(PackHeader)) return false;
+
+	const PackHeader* h = HeaderOf(file_.Data());
+	if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion) return false;
+	if (h->slotCount < kMinSlots || (h->slotCount & (h->slotCount - 1)) != 0) return false;
+	if (h->dataStart != DataStartFor(h->slotCount)) return false;
+	return h->dataStart <= h->dataEnd && h->dataEnd <= file_.Size();
+}
+
+// Holds mutex_
+int64_t ArtPack::Find(uint64_t hash) const
+{
+	if (!file_.IsOpen()) return -1;
+
+	const uint32_t mask = HeaderOf(file_.Data())->slotCount - 1;
+	const PackSlot* slots = SlotsOf(file_.Data());
+
+	for (uint32_t i = static_cast<uint32_t>(hash) & mask, n = 0; n <= mask; i = (i + 1) & mask, ++n)
+	{
+		const PackSlot& s = slots[i];
+		if (s.state == kEmpty) return -1;
+		if (s.state == kLive && s.hash == hash) return i;
+	}
+	return -1;
+}
+
+bool ArtPack::Contains(uint64_t hash) const
+{
+	std::shared_lock lk(mutex_);
+	return Find(hash) >= 0;
+}
+
+bool ArtPack::Read(uint64_t hash, std::vector<uint8_t>& out) const
+{
+	std::shared_lock lk(mutex_);
+
+	const int64_t i = Find(hash);
+	if (i < 0) return false;
+
+	// A damaged slot must not read past the written data
+	const PackHeader* h = HeaderOf(file_.Data());
+	const PackSlot& s = SlotsOf(file_.Data())[i];
+	if (s.offset < h->dataStart || s.offset + s.size > h->dataEnd) return false;
+
+	const uint8_t* p = file_.Data() + s.offset;
+	out.assign(p, p + s.size);
+	return true;
+}
+
+bool ArtPack::ReadTail(uint64_t hash, void* out, uint32_t size) const
+{
+	std::shared_lock lk(mutex_);
+
+	const int64_t i = Find(hash);
+	if (i < 0) return false;
+
+	const PackHeader* h = HeaderOf(file_.Data());
+	const PackSlot& s = SlotsOf(file_.Data())[i];
+	if (s.offset < h->dataStart || s.offset + s.size > h->dataEnd || s.size < size) return false;
+
+	std::memcpy(out, file_.Data() + s.offset + s.size - size, size);
+	return true;
+}
+
+bool ArtPack::Append(uint64_t hash, const uint8_t* data, uint32_t size)
+{
+	std::unique_lock lk(mutex_);
+
+	if (!file_.IsOpen()) return false;
+	if (Find(hash) >= 0) return true;
+
+	// Keep probe sequences short: rebuild before the table is 70% used
+	{
+		const PackHeader* h = HeaderOf(file_.Data());
+		const uint64_t used = static_cast<uint64_t>(h->liveCount) + h->tombstones + 1;
+		if (used * 10 > static_cast<uint64_t>(h->slotCount) * 7)
+		{
+			if (!CompactLocked(SlotCountFor(static_cast<uint64_t>(h->liveCount) + 1))) return false;
+		}
+	}
+
+	const uint64_t offset = HeaderOf(file_.Data())->dataEnd;
+	const uint64_t end = offset + size;
+	if (end > file_.Size())
+	{
+		const uint64_t grown = std::max(end + kMinGrowBytes, file_.Size() + file_.Size() / 2);
+		if (!file_.Resize(grown)) return false;
+	}
+
+	// Blob first, then the slot, then the header: an interrupted append leaves unreferenced bytes only
+	std::memcpy(file_.Data() + offset, data, size);
+
+	PackHeader* h = HeaderOf(file_.Data());
+	PackSlot* slots = SlotsOf(file_.Data());
+	const uint32_t i = FreeSlot(slots, h->slotCount, hash);
+
+	if (slots[i].state == kTombstone) --h->tombstones;
+	slots[i] = PackSlot{ hash, offset, size, kLive };
+
+	++h->liveCount;
+	h->dataEnd = end;
+	h->liveBytes += size;
+	return true;
+}
+
+bool ArtPack::Remove(uint64_t hash)
+{
+	std::unique_lock lk(mutex_);
+
+	const int64_t i = Find(hash);
+	if (i < 0) return false;
+
+	PackSlot& s = SlotsOf(file_.Data())[i];
+	s.state = kTombstone;
+
+	PackHeader* h = HeaderOf(file_.Data());
+	--h->liveCount;
+	++h->tombstones;
+	h->liveBytes -= s.size;
+	h->deadBytes += s.size;
+	return true;
+}
+
+std::vector<std::pair<uint64_t, uint32_t>> ArtPack::Entries() const
+{
+	std::shared_lock lk(mutex_);
+
+	std::vector<std::pair<uint64_t, uint32_t>> entries;
+	if (!file_.IsOpen()) return entries;
+
+	const PackHeader* h = HeaderOf(file_.Data());
+	const PackSlot* slots = SlotsOf(file_.Data());
+	entries.reserve(h->liveCount);
+
+	for (uint32_t i = 0; i < h->slotCount; ++i)
+	{
+		if (slots[i].state == kLive) entries.emplace_back(slots[i].hash, slots[i].size);
+	}
+	return entries;
+}
+
+bool ArtPack::NeedsCompaction() const
+{
+	std::shared_lock lk(mutex_);
+	if (!file_.IsOpen()) return false;
+
+	const PackHeader* h = HeaderOf(file_.Data());
+	if (h->tombstones * 4ull > h->slotCount) return true;
+	return h->deadBytes >= kMinDeadBytes && h->deadBytes * 2 >= h->liveBytes;
+}
+
+bool ArtPack::Compact()
+{
+	std::unique_lock lk(mutex_);
+	if (!file_.IsOpen()) return false;
+
+	return CompactLocked(SlotCountFor(HeaderOf(file_.Data())->liveCount));
+}
+
+// Holds mutex_ exclusively. Writes the live blobs (in file order) into a new pack
+// next to this one, then replaces the file and remaps it.
+bool ArtPack::CompactLocked(uint32_t slotCount)
+{
+	const PackHeader* h = HeaderOf(file_.Data());
+	const PackSlot* slots = SlotsOf(file_.Data());
+
+	std::vector<PackSlot> live;
+	live.reserve(h->liveCount);
+	for (uint32_t i = 0; i < h->slotCount; ++i)
+	{
+		const PackSlot& s = slots[i];
+		if (s.state == kLive && s.offset >= h->dataStart && s.offset + s.size <= h->dataEnd) live.push_back(s);
+	}
+	std::sort(live.begin(), live.end(), [](const PackSlot& a, const PackSlot& b) { return a.offset < b.offset; });
+
+	uint64_t liveBytes = 0;
+	for (const PackSlot& s : live) liveBytes += s.size;
+
+	auto tmp = path_;
+	tmp += ".tmp";
+
+	std::error_code ec;
+	std::filesystem::remove(tmp, ec);
+
+	const uint64_t dataStart = DataStartFor(slotCount);
+	{
+		MappedFile out;
+		if (!out.Open(tmp, dataStart + liveBytes + kMinGrowBytes)) return false;
+
+		uint8_t* base = out.Data();
+		std::memset(base, 0, static_cast<size_t>(dataStart));
+
+		PackSlot* outSlots = SlotsOf(base);
+		uint64_t offset = dataStart;
+		for (const PackSlot& s : live)
+		{
+			std::memcpy(base + offset, file_.Data() + s.offset, s.size);
+			outSlots[FreeSlot(outSlots, slotCount, s.hash)] = PackSlot{ s.hash, offset, s.size, kLive };
+			offset += s.size;
+		}
+
+		PackHeader* nh = HeaderOf(base);
+		std::memcpy(nh->magic, kMagic, sizeof(kMagic));
+		nh->version = kVersion;
+		nh->slotCount = slotCount;
+		nh->liveCount = static_cast<uint32_t>(live.size());
+		nh->dataStart = dataStart;
+		nh->dataEnd = offset;
+		nh->liveBytes = liveBytes;
+
+		if (!out.Flush())
+		{
+			out.Close();
+			std::filesystem::remove(tmp, ec);
+			return false;
+		}
+	}
+
+	// The old mapping has to go before the file can be replaced (Windows)
+	file_.Close();
+	std::filesystem::rename(tmp, path_, ec);
+	if (ec)
+	{
+		// Still the old pack (reads keep working), but the compaction did not happen: an
+		// Append that relied on it would fill the old table until no slot is free
+		std::filesystem::remove(tmp, ec);
+		if (file_.Open(path_, sizeof(PackHeader)) && !Validate()) file_.Close();
+		return false;
+	}
+
+	return file_.Open(path_, sizeof(PackHeader)) && Validate();
+}
+
+ArtPackStats ArtPack::GetStats() const
+{
+	std::shared_lock lk(mutex_);
+
+	ArtPackStats stats;
+	if (!file_.IsOpen()) return stats;
+
+	const PackHeader* h = HeaderOf(file_.Data());
+	stats.entries = h->liveCount;
+	stats.liveBytes = h->liveBytes;
+	stats.deadBytes = h->deadBytes;
+	stats.fileBytes = file_.Size();
+	return stats;
+}
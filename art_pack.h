@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "mapped_file.h"
+
+// ------------------------------------------------------------
+// Single-file store for encoded album art, read through a memory mapping.
+//
+//   [header 64 B][index: slotCount x 24 B slots][blobs back to back ...]
+//
+// The index is an open-addressed table (linear probing, power-of-two size) keyed
+// by content hash, so a lookup is one probe sequence into mapped memory. A write
+// appends the blob at the data end, then fills the slot, then updates the
+// header. Removal only tombstones the slot; Compact() rewrites the live blobs
+// (and a larger index once it fills up) into a fresh file and swaps it in.
+//
+// Thread-safe: reads share a lock, writes and compaction take it exclusively.
+// ------------------------------------------------------------
+
+struct ArtPackStats
+{
+    uint64_t entries   = 0;
+    uint64_t liveBytes = 0;   // blob bytes still indexed
+    uint64_t deadBytes = 0;   // removed, reclaimed by the next compaction
+    uint64_t fileBytes = 0;
+};
+
+class ArtPack
+{
+public:
+    ArtPack() = default;
+    ~ArtPack() = default;
+
+    ArtPack(const ArtPack&) = delete;
+    ArtPack& operator=(const ArtPack&) = delete;
+
+    // Opens the pack (creating it, or recreating it when the header is unusable)
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    bool Contains(uint64_t hash) const;
+
+    // Copies the blob out of the mapping; false if it is not stored
+    bool Read(uint64_t hash, std::vector<uint8_t>& out) const;
+
+    // Copies the last `size` bytes of the blob; false if it is not stored or shorter
+    bool ReadTail(uint64_t hash, void* out, uint32_t size) const;
+
+    // Stores the blob unless the hash is already present
+    bool Append(uint64_t hash, const uint8_t* data, uint32_t size);
+
+    bool Remove(uint64_t hash);
+
+    // (hash, size) of every stored blob
+    std::vector<std::pair<uint64_t, uint32_t>> Entries() const;
+
+    // Enough dead space (or a full enough index) to be worth a rewrite
+    bool NeedsCompaction() const;
+    bool Compact();
+
+    ArtPackStats GetStats() const;
+
+private:
+    bool Create(uint32_t slotCount);
+    bool Validate() const;
+
+    // Slot index, -1 if not stored
+    int64_t Find(uint64_t hash) const;
+    bool CompactLocked(uint32_t slotCount);
+
+    std::filesystem::path path_;
+    mutable std::shared_mutex mutex_;
+    MappedFile file_;
+};
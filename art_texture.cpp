@@ -0,0 +1,246 @@
+#include "pch.h"
+#include "art_texture.h"
+
+#include <algorithm>
+#include <d3d11.h>
+#pragma comment(lib, "d3d11.lib")
+
+#include "image_kernels.h"
+#include "profiler.h"
+
+namespace
+{
+    // The DX11 ImGui backend stores the font atlas as an ID3D11ShaderResourceView*
+    ID3D11Device* AcquireDevice()
+    {
+        auto* fontView = static_cast<ID3D11ShaderResourceView*>(ImGui::GetIO().Fonts->TexID);
+        if (!fontView) return nullptr;
+
+        ID3D11Device* device = nullptr;
+        fontView->GetDevice(&device);   // AddRef'd
+        return device;
+    }
+
+    // ImGui's DX11 pipeline blends straight alpha (SRC_ALPHA, INV_SRC_ALPHA)
+    std::vector<uint8_t> Unpremultiply(const std::vector<uint8_t>& rgba)
+    {
+        std::vector<uint8_t> out(rgba.size());
+        for (size_t i = 0; i + 3 < rgba.size(); i += 4)
+        {
+            const uint32_t a = rgba[i + 3];
+            for (size_t c = 0; c < 3; ++c)
+                out[i + c] = a ? static_cast<uint8_t>(std::min<uint32_t>(255, (rgba[i + c] * 255 + a / 2) / a)) : 0;
+            out[i + 3] = static_cast<uint8_t>(a);
+        }
+        return out;
+    }
+
+    // Immutable RGBA8 texture + view; nullptr on failure
+    ID3D11ShaderResourceView* CreateView(ID3D11Device* device, const uint8_t* rgba, int width, int height)
+    {
+        D3D11_TEXTURE2D_DESC desc{};
+        desc.Width = static_cast<UINT>(width);
+        desc.Height = static_cast<UINT>(height);
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.Usage = D3D11_USAGE_IMMUTABLE;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        D3D11_SUBRESOURCE_DATA data{};
+        data.pSysMem = rgba;
+        data.SysMemPitch = static_cast<UINT>(width) * 4;
+
+        ID3D11Texture2D* texture = nullptr;
+        ID3D11ShaderResourceView* view = nullptr;
+
+        if (SUCCEEDED(device->CreateTexture2D(&desc, &data, &texture)))
+        {
+            D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc{};
+            viewDesc.Format = desc.Format;
+            viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+            viewDesc.Texture2D.MipLevels = 1;
+
+            if (FAILED(device->CreateShaderResourceView(texture, &viewDesc, &view)))
+                view = nullptr;
+
+            texture->Release();   // the view keeps it alive
+        }
+        return view;
+    }
+}
+
+ArtTexture::ArtTexture(ID3D11ShaderResourceView* view, ID3D11ShaderResourceView* backdropView, TrackId trackId, int width, float cornerRadius, const ArtPalette& palette)
+    : mView(view)
+    , mBackdropView(backdropView)
+    , mTrackId(trackId)
+    , mWidth(width)
+    , mCornerRadius(cornerRadius)
+    , mPalette(palette)
+{
+}
+
+ArtTexture::~ArtTexture()
+{
+    if (mView) mView->Release();
+    if (mBackdropView) mBackdropView->Release();
+}
+
+std::shared_ptr<ArtTexture> ArtTexture::Create(const AlbumArtImage& image, float cornerRadiusPx, ID3D11Device* device)
+{
+    if (image.width <= 0 || image.height <= 0) return nullptr;
+    if (image.rgba.size() != static_cast<size_t>(image.width) * image.height * 4) return nullptr;
+
+    if (device) device->AddRef();
+    else device = AcquireDevice();
+    if (!device) return nullptr;
+
+    // Opaque square art uploads the stored pixels as they are
+    std::vector<uint8_t> straight;
+    if (image.premultiplied && !image.opaque) straight = Unpremultiply(image.rgba);
+
+    // ImGui 1.75's Image() cannot clip to a rounded rect, so the corners live in the texture
+    cornerRadiusPx = std::max(0.0f, cornerRadiusPx);
+    if (cornerRadiusPx > 0.0f)
+    {
+        if (straight.empty()) straight = image.rgba;
+        ImageKernels::ApplyRoundedCorners(straight.data(), image.width, image.height, cornerRadiusPx);
+    }
+
+    ID3D11ShaderResourceView* view = CreateView(device, straight.empty() ? image.rgba.data() : straight.data(), image.width, image.height);
+
+    // The backdrop is optional; the art is still drawable without it
+    ID3D11ShaderResourceView* backdropView = nullptr;
+    if (view && image.backdropSize > 0 && image.backdrop.size() == static_cast<size_t>(image.backdropSize) * image.backdropSize * 4)
+    {
+        if (image.opaque)
+            backdropView = CreateView(device, image.backdrop.data(), image.backdropSize, image.backdropSize);
+        else
+            backdropView = CreateView(device, Unpremultiply(image.backdrop).data(), image.backdropSize, image.backdropSize);
+    }
+
+    device->Release();
+
+    if (!view) return nullptr;
+    return std::shared_ptr<ArtTexture>(new ArtTexture(view, backdropView, image.trackId, image.width, cornerRadiusPx, image.palette));
+}
+
+ImTextureID ArtTexture::GetImGuiTex() const
+{
+    return mView;
+}
+
+ImTextureID ArtTexture::GetBackdropTex() const
+{
+    return mBackdropView;
+}
+
+// ------------------------------------------------------------
+// ArtTextureLoader
+// ------------------------------------------------------------
+
+ArtTextureLoader::~ArtTextureLoader()
+{
+    Stop();
+}
+
+void ArtTextureLoader::EnsureThread()
+{
+    if (!mThread.joinable() && !mStop) mThread = std::thread([this] { Run(); });
+}
+
+void ArtTextureLoader::Request(std::shared_ptr<const AlbumArtImage> image, float cornerRadiusPx)
+{
+    if (!image) return;
+
+    ID3D11Device* device = AcquireDevice();
+    if (!device) return;
+
+    {
+        std::lock_guard lk(mMutex);
+        if (mJob && mJob->device) mJob->device->Release();
+        mJob = Job{ std::move(image), cornerRadiusPx, device };
+        EnsureThread();
+    }
+    mCv.notify_one();
+}
+
+bool ArtTextureLoader::TakeResult(Result& out)
+{
+    if (!mHasResult.load(std::memory_order_acquire)) return false;
+
+    std::lock_guard lk(mMutex);
+    if (!mResult) return false;
+
+    out = std::move(*mResult);
+    mResult.reset();
+    mHasResult.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void ArtTextureLoader::Retire(std::shared_ptr<ArtTexture> texture)
+{
+    if (!texture) return;
+
+    {
+        std::lock_guard lk(mMutex);
+        mRetired.push_back(std::move(texture));
+        EnsureThread();
+    }
+    mCv.notify_one();
+}
+
+void ArtTextureLoader::Stop()
+{
+    {
+        std::lock_guard lk(mMutex);
+        mStop = true;
+    }
+    mCv.notify_one();
+    if (mThread.joinable()) mThread.join();
+
+    // Only the caller's thread is left
+    if (mJob && mJob->device) mJob->device->Release();
+    mJob.reset();
+    mResult.reset();
+    mHasResult.store(false, std::memory_order_relaxed);
+    mRetired.clear();
+}
+
+void ArtTextureLoader::Run()
+{
+    std::unique_lock lk(mMutex);
+    while (true)
+    {
+        mCv.wait(lk, [this] { return mStop || mJob || !mRetired.empty(); });
+        if (mStop) return;
+
+        std::optional<Job> job;
+        job.swap(mJob);
+        std::vector<std::shared_ptr<ArtTexture>> retired;
+        retired.swap(mRetired);
+
+        lk.unlock();
+
+        retired.clear();
+
+        std::optional<Result> result;
+        if (job)
+        {
+            RR_PROFILE_SCOPE(ProfileStage::UploadAlbumArt);
+            result = Result{ job->image, job->cornerRadiusPx, ArtTexture::Create(*job->image, job->cornerRadiusPx, job->device) };
+            job->device->Release();
+        }
+
+        lk.lock();
+
+        if (result)
+        {
+            // Not taken yet: the newer upload wins, the older one goes with the next batch
+            if (mResult && mResult->texture) mRetired.push_back(std::move(mResult->texture));
+            mResult = std::move(result);
+            mHasResult.store(true, std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "IMGUI/imgui.h"
+#include "media.h"
+
+struct ID3D11Device;
+struct ID3D11ShaderResourceView;
+
+// GPU copy of a decoded AlbumArtImage, drawable with ImGui::Image.
+//
+// Only a texture upload of pixels that were decoded off-thread. The D3D11 device
+// is taken from ImGui's font atlas texture, so nothing here has to hook the
+// game's renderer.
+class ArtTexture
+{
+public:
+    // nullptr if no D3D11 device is reachable or the upload failed. A positive
+    // `cornerRadiusPx` (in image pixels) bakes rounded corners into the alpha.
+    // Without a `device` it is looked up through ImGui (render thread only).
+    static std::shared_ptr<ArtTexture> Create(const AlbumArtImage& image, float cornerRadiusPx = 0.0f, ID3D11Device* device = nullptr);
+
+    ~ArtTexture();
+
+    ArtTexture(const ArtTexture&) = delete;
+    ArtTexture& operator=(const ArtTexture&) = delete;
+
+    // nullptr until the texture is ready to draw
+    ImTextureID GetImGuiTex() const;
+
+    // Blurred copy for the window backdrop; nullptr if the art came without one
+    ImTextureID GetBackdropTex() const;
+
+    TrackId GetTrackId() const { return mTrackId; }
+    int GetWidth() const { return mWidth; }
+    float GetCornerRadius() const { return mCornerRadius; }
+    const ArtPalette& GetPalette() const { return mPalette; }
+
+private:
+    ArtTexture(ID3D11ShaderResourceView* view, ID3D11ShaderResourceView* backdropView, TrackId trackId, int width, float cornerRadius, const ArtPalette& palette);
+
+    ID3D11ShaderResourceView* mView = nullptr;
+    ID3D11ShaderResourceView* mBackdropView = nullptr;
+    TrackId mTrackId = kNoTrack;
+    int mWidth = 0;
+    float mCornerRadius = 0.0f;
+    ArtPalette mPalette;
+};
+
+// Creates and releases ArtTextures on its own thread, so neither lands in a frame.
+// ID3D11Device is free-threaded; only the device lookup happens on the render
+// thread, in Request().
+class ArtTextureLoader
+{
+public:
+    struct Result
+    {
+        std::shared_ptr<const AlbumArtImage> image;
+        float cornerRadiusPx = 0.0f;
+        std::shared_ptr<ArtTexture> texture;   // nullptr if the upload failed
+    };
+
+    ArtTextureLoader() = default;
+    ~ArtTextureLoader();
+
+    ArtTextureLoader(const ArtTextureLoader&) = delete;
+    ArtTextureLoader& operator=(const ArtTextureLoader&) = delete;
+
+    // Render thread. Replaces a request that has not started yet.
+    void Request(std::shared_ptr<const AlbumArtImage> image, float cornerRadiusPx);
+
+    // Render thread: the latest finished request, once. One atomic load when there is none.
+    bool TakeResult(Result& out);
+
+    // Drops this reference on the loader thread (the texture is destroyed there if it was the last)
+    void Retire(std::shared_ptr<ArtTexture> texture);
+
+    // Finishes the upload in progress and joins; pending work is dropped
+    void Stop();
+
+private:
+    struct Job
+    {
+        std::shared_ptr<const AlbumArtImage> image;
+        float cornerRadiusPx = 0.0f;
+        ID3D11Device* device = nullptr;   // AddRef'd
+    };
+
+    void EnsureThread();
+    void Run();
+
+    std::mutex mMutex;
+    std::condition_variable mCv;
+    std::thread mThread;
+    bool mStop = false;
+
+    std::optional<Job> mJob;
+    std::optional<Result> mResult;
+    std::atomic<bool> mHasResult{ false };
+    std::vector<std::shared_ptr<ArtTexture>> mRetired;
+};
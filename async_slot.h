@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+// Holds at most one in-flight async operation and a generation token.
+// Starting a new operation (Reset) cancels the previous one and invalidates its
+// token, so a completion that arrives late can tell it is stale and drop its result.
+//
+// Cancelling does not stop an operation's body on the spot: a superseded body may
+// still be running on another thread. Bodies hold a Track() guard for as long as they
+// may touch their owner, and the owner waits for all of them (WaitIdle) before it goes.
+//
+// `Operation` only needs Cancel(); WinRT IAsyncAction/IAsyncOperation qualify, and
+// so does any fake used to drive the state machine without WinRT.
+template <typename Operation>
+class AsyncSlot
+{
+public:
+    // Owner thread: cancels the in-flight operation (if any) and returns the token
+    // for the next one.
+    uint64_t Reset()
+    {
+        if (op_) op_->Cancel();
+        op_.reset();
+        return generation_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    // Owner thread: keeps `op` so it can be cancelled later. If the token was
+    // invalidated in the meantime the operation is cancelled right away.
+    void Attach(uint64_t token, Operation op)
+    {
+        if (IsCurrent(token)) op_ = std::move(op);
+        else op.Cancel();
+    }
+
+    // Owner thread: invalidates the current token and hands the operation back
+    // (e.g. to cancel and wait for it on shutdown).
+    std::optional<Operation> Release()
+    {
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+        return std::exchange(op_, std::nullopt);
+    }
+
+    // Any thread
+    bool IsCurrent(uint64_t token) const
+    {
+        return generation_.load(std::memory_order_acquire) == token;
+    }
+
+    // Held by an operation's body while it runs, current or superseded
+    class [[nodiscard]] InFlight
+    {
+    public:
+        explicit InFlight(AsyncSlot& slot) : slot_(&slot)
+        {
+            std::lock_guard lk(slot_->idleMutex_);
+            ++slot_->inFlight_;
+        }
+
+        ~InFlight()
+        {
+            // Notified under the lock: once WaitIdle sees zero the slot may be destroyed
+            std::lock_guard lk(slot_->idleMutex_);
+            if (--slot_->inFlight_ == 0) slot_->idle_.notify_all();
+        }
+
+        InFlight(const InFlight&) = delete;
+        InFlight& operator=(const InFlight&) = delete;
+
+    private:
+        AsyncSlot* slot_;
+    };
+
+    // Any thread, first thing in the operation's body (before its first suspension, so
+    // it is counted by the time the operation is returned to the owner)
+    InFlight Track() { return InFlight(*this); }
+
+    // Owner thread: blocks until no body holds a Track() guard. Cancel first (Reset or
+    // Release) or this waits for the operations to finish on their own.
+    void WaitIdle()
+    {
+        std::unique_lock lk(idleMutex_);
+        idle_.wait(lk, [this] { return inFlight_ == 0; });
+    }
+
+private:
+    std::optional<Operation> op_;
+    std::atomic<uint64_t> generation_{0};
+
+    std::mutex idleMutex_;
+    std::condition_variable idle_;
+    int inFlight_ = 0;
+};
+
+// The completion of a slot's operation, handed from the thread it completed on to the
+// owner. Only a completion whose token is still current is kept, and never over one with
+// a newer token, so a late stale completion can not replace the current one.
+template <typename T>
+class AsyncResult
+{
+public:
+    // Completing thread: returns false when the result was dropped as stale
+    template <typename Operation>
+    bool Offer(const AsyncSlot<Operation>& slot, uint64_t token, T value)
+    {
+        std::lock_guard lk(mutex_);
+        if (!slot.IsCurrent(token)) return false;
+        if (value_ && value_->first > token) return false;
+
+        value_.emplace(token, std::move(value));
+        return true;
+    }
+
+    // Owner thread: the pending result, if its token is still current
+    template <typename Operation>
+    std::optional<T> Take(const AsyncSlot<Operation>& slot)
+    {
+        std::optional<std::pair<uint64_t, T>> taken;
+        {
+            std::lock_guard lk(mutex_);
+            taken.swap(value_);
+        }
+
+        if (!taken || !slot.IsCurrent(taken->first)) return std::nullopt;
+        return std::move(taken->second);
+    }
+
+private:
+    std::mutex mutex_;
+    std::optional<std::pair<uint64_t, T>> value_;
+};
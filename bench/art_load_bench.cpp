@@ -0,0 +1,152 @@
+// Album art load latency and texture memory: the display-size pixel cache against the
+// previous path, which loaded the full-resolution image and uploaded it on every load.
+//
+//   rr_art_load [--iterations N]
+//
+// For each thumbnail size GSMTC hands out and each display size the overlay requests:
+//   full-size   the old path's per-load work after decoding: copy the full-resolution
+//               pixels out of storage into the upload buffer; the texture is that size
+//   first load  the new path's one-time work: resample to the display size, palette,
+//               backdrop blur, StorePixels
+//   cached      every later load on the new path: ReadPixels, copy into the upload buffer;
+//               the textures are the display-size image and the 64 px backdrop
+//
+// No image decoder is part of the core build, so PNG/JPEG decoding is not timed. The old
+// path paid it on every load; the new path pays it on the first load only.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include "album_cache.h"
+#include "image_kernels.h"
+#include "palette.h"
+#include "track_id.h"
+
+namespace
+{
+    // As media.cpp builds the backdrop
+    constexpr int kBackdropPx = 64;
+    constexpr int kBackdropBlurRadius = 6;
+    constexpr int kBackdropBlurPasses = 3;
+
+    // A cover-like image: gradients plus some noise, opaque
+    std::vector<uint8_t> MakeCover(int size)
+    {
+        std::vector<uint8_t> rgba(static_cast<size_t>(size) * size * 4);
+        uint32_t noise = 12345;
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                noise = noise * 1664525u + 1013904223u;
+                uint8_t* p = &rgba[(static_cast<size_t>(y) * size + x) * 4];
+                p[0] = static_cast<uint8_t>(x * 255 / size);
+                p[1] = static_cast<uint8_t>(y * 255 / size);
+                p[2] = static_cast<uint8_t>(128 + static_cast<int>(noise >> 28) * 4);
+                p[3] = 255;
+            }
+        }
+        return rgba;
+    }
+
+    AlbumArtImage BuildDisplayImage(const std::vector<uint8_t>& full, int size, int px)
+    {
+        AlbumArtImage image;
+        image.width = std::min(size, px);
+        image.height = image.width;
+        image.premultiplied = true;
+        image.opaque = true;
+        image.palette = ExtractPalette(full.data(), size, size);
+
+        image.backdropSize = kBackdropPx;
+        image.backdrop.resize(static_cast<size_t>(kBackdropPx) * kBackdropPx * 4);
+        ImageKernels::ResampleToPremultiplied(full.data(), size, size, image.backdrop.data(), kBackdropPx, kBackdropPx);
+        ImageKernels::BoxBlurRgba8(image.backdrop.data(), kBackdropPx, kBackdropPx, kBackdropBlurRadius, kBackdropBlurPasses);
+
+        image.rgba.resize(static_cast<size_t>(image.width) * image.height * 4);
+        ImageKernels::ResampleToPremultiplied(full.data(), size, size, image.rgba.data(), image.width, image.height);
+        return image;
+    }
+
+    template <typename Body>
+    double UsPerCall(int iterations, Body&& body)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) body();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / iterations;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 200;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "rr_art_load_bench";
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    AlbumCache cache;
+    if (!cache.Open(dir))
+    {
+        std::fprintf(stderr, "cannot open a cache in %s\n", dir.string().c_str());
+        return 1;
+    }
+
+    std::printf("kernels: %s, %d iterations\n\n", ImageKernels::IsaName(ImageKernels::ActiveIsa()), iterations);
+    std::printf("%-7s %-5s | %-24s | %-14s | %-24s\n", "source", "px", "full-size load  texture", "first load", "cached load  textures");
+
+    const int sources[] = { 300, 640, 1000, 1400 };
+    const int displays[] = { 128, 192, 256 };
+
+    std::vector<uint8_t> upload;
+    std::vector<uint8_t> stored;
+    AlbumArtImage cached;
+
+    for (const int size : sources)
+    {
+        const std::vector<uint8_t> full = MakeCover(size);
+        const TrackId track = ComputeTrackId("bench", std::to_string(size), "");
+        const ArtHash hash = cache.Store(track, 0, full);
+
+        // Old path: the whole image every load, and a texture of that size
+        const double fullUs = UsPerCall(iterations, [&] {
+            cache.Read(hash, stored);
+            upload.assign(stored.begin(), stored.end());
+        });
+        const double fullKiB = static_cast<double>(full.size()) / 1024.0;
+
+        for (const int px : displays)
+        {
+            AlbumArtImage image;
+            const double buildUs = UsPerCall(std::max(1, iterations / 10), [&] { image = BuildDisplayImage(full, size, px); });
+            const double firstUs = buildUs + UsPerCall(1, [&] { cache.StorePixels(hash, px, image); });
+
+            const double cachedUs = UsPerCall(iterations, [&] {
+                cache.ReadPixels(hash, px, cached);
+                upload.assign(cached.rgba.begin(), cached.rgba.end());
+            });
+            const double cachedKiB = static_cast<double>(cached.rgba.size() + cached.backdrop.size()) / 1024.0;
+
+            std::printf("%4dpx  %-5d | %8.1f us  %8.0f KiB | %9.1f us | %8.1f us  %6.0f KiB\n",
+                size, px, fullUs, fullKiB, firstUs, cachedUs, cachedKiB);
+        }
+    }
+
+    cache.Close();
+    std::filesystem::remove_all(dir, ec);
+    return 0;
+}
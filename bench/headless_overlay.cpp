@@ -0,0 +1,216 @@
+// Headless overlay host: drives OverlayView from a media script through the null
+// renderer and reports what a frame costs, without Rocket League or a GPU.
+//
+//   rr_headless [--frames N] [--fps F] [--no-art] [--immediate | --compare] [--script file.tsv]
+//
+// The script format is ScriptedMediaController::ParseScript's; without one a built-in
+// playlist (long titles, pauses, seeks, track changes) is used. --immediate turns the
+// retained layers off (every frame paints everything); --compare runs the script both
+// ways and prints the difference.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "media_scripted.h"
+#include "null_renderer.h"
+#include "overlay_view.h"
+#include "palette.h"
+#include "window_style.h"
+
+namespace
+{
+    const char* kDefaultScript =
+        "0\ttrack\tNever Gonna Give You Up (Remastered 2022 Extended Version)\tRick Astley\tWhenever You Need Somebody\t213\n"
+        "20\tpause\n"
+        "22\tplay\n"
+        "30\tseek\t150\n"
+        "40\ttrack\tShort\tA\tB\t95\n"
+        "70\ttrack\tRoundabout\tYes\tFragile\t508\n";
+
+    struct Options
+    {
+        int frames = 3600;
+        double fps = 60.0;
+        bool art = true;
+        bool retained = true;
+        bool compare = false;
+        std::string script;
+    };
+
+    bool ParseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (!std::strcmp(arg, "--frames") && hasValue) opt.frames = std::max(1, std::atoi(argv[++i]));
+            else if (!std::strcmp(arg, "--fps") && hasValue) opt.fps = std::max(1.0, std::atof(argv[++i]));
+            else if (!std::strcmp(arg, "--script") && hasValue) opt.script = argv[++i];
+            else if (!std::strcmp(arg, "--no-art")) opt.art = false;
+            else if (!std::strcmp(arg, "--immediate")) opt.retained = false;
+            else if (!std::strcmp(arg, "--compare")) opt.compare = true;
+            else
+            {
+                std::fprintf(stderr, "usage: %s [--frames N] [--fps F] [--no-art] [--immediate | --compare] [--script file.tsv]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double Percentile(std::vector<double> v, double p)
+    {
+        if (v.empty()) return 0.0;
+        const size_t k = std::min(v.size() - 1, static_cast<size_t>(p * static_cast<double>(v.size())));
+        std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+        return v[k];
+    }
+
+    struct RunResult
+    {
+        std::vector<double> frameUs;
+        uint64_t vertices = 0;            // emitted by the overlay, generated or replayed
+        uint64_t stateChanges = 0;
+        uint64_t metricsComputes = 0;
+        RetainedDrawStats layers;
+    };
+
+    // One pass over the script on a fresh renderer and overlay
+    RunResult Run(const Options& opt, const std::vector<ScriptedMediaEvent>& events, bool retained)
+    {
+        NullRenderer renderer;
+        WindowStyle style{};
+        style.albumArtBackdrop = opt.art;
+        style.showAlbumArt = opt.art;
+
+        OverlayView overlay(style);
+        overlay.Layers().SetEnabled(retained);
+        ScriptedMediaController media(events);
+
+        ArtPalette palette{};
+        OverlayArt art{};
+        if (opt.art)
+        {
+            art.current.image = NullRenderer::FakeTexture(2);
+            art.current.backdrop = NullRenderer::FakeTexture(3);
+            art.current.palette = &palette;
+        }
+
+        // Script and frame clocks both start at zero; the wall clock only anchors positions
+        const auto start = OverlayView::Clock::time_point{};
+        const auto wallStart = std::chrono::system_clock::time_point{};
+        const double frameSec = 1.0 / opt.fps;
+
+        RunResult result;
+        result.frameUs.reserve(static_cast<size_t>(opt.frames));
+
+        for (int i = 0; i < opt.frames; ++i)
+        {
+            const double t = i * frameSec;
+            const auto offset = std::chrono::duration_cast<OverlayView::Clock::duration>(std::chrono::duration<double>(t));
+
+            const auto t0 = std::chrono::steady_clock::now();
+
+            if (media.AdvanceTo(t))
+            {
+                overlay.SetMediaState(media.GetState());
+                ++result.stateChanges;
+            }
+
+            renderer.BeginFrame(static_cast<float>(frameSec));
+            overlay.BeginFrame(static_cast<uint64_t>(i), start + offset,
+                wallStart + std::chrono::duration_cast<std::chrono::system_clock::duration>(offset));
+            overlay.Draw(art);
+            const NullFrameStats& stats = renderer.EndFrame();
+
+            result.frameUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+            result.vertices += static_cast<uint64_t>(stats.vertices);
+        }
+
+        result.layers = overlay.Layers().Stats();
+        result.metricsComputes = overlay.MetricsComputes();
+        return result;
+    }
+
+    double MeanUs(const RunResult& r)
+    {
+        double total = 0.0;
+        for (double us : r.frameUs) total += us;
+        return total / static_cast<double>(r.frameUs.size());
+    }
+
+    void Report(const char* mode, const Options& opt, const RunResult& r)
+    {
+        // Immediate mode generates every vertex; retained mode only what it recorded
+        const uint64_t generated = r.vertices - std::min(r.vertices, r.layers.replayedVertices);
+        const double frames = static_cast<double>(opt.frames);
+        std::printf("[%s]\n", mode);
+        std::printf("frame   mean %.2f us  p50 %.2f us  p99 %.2f us  max %.2f us\n",
+            MeanUs(r), Percentile(r.frameUs, 0.50), Percentile(r.frameUs, 0.99),
+            *std::max_element(r.frameUs.begin(), r.frameUs.end()));
+        std::printf("output  %.0f vertices/frame, %.0f generated, %.0f replayed\n",
+            static_cast<double>(r.vertices) / frames, static_cast<double>(generated) / frames,
+            static_cast<double>(r.layers.replayedVertices) / frames);
+        std::printf("layers  %llu recorded, %llu replayed; %llu layout metric computes\n",
+            static_cast<unsigned long long>(r.layers.recordedLayers), static_cast<unsigned long long>(r.layers.replayedLayers),
+            static_cast<unsigned long long>(r.metricsComputes));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt)) return 2;
+
+    std::vector<ScriptedMediaEvent> events;
+    if (opt.script.empty())
+    {
+        std::istringstream in(kDefaultScript);
+        events = ScriptedMediaController::ParseScript(in);
+    }
+    else
+    {
+        std::ifstream in(opt.script);
+        if (!in)
+        {
+            std::fprintf(stderr, "cannot open %s\n", opt.script.c_str());
+            return 1;
+        }
+        events = ScriptedMediaController::ParseScript(in);
+    }
+
+    const double frameSec = 1.0 / opt.fps;
+    std::printf("frames %d (%.0f fps, %.1f s script)\n", opt.frames, opt.fps, opt.frames * frameSec);
+
+    if (!opt.compare)
+    {
+        const RunResult r = Run(opt, events, opt.retained);
+        std::printf("%llu state changes\n", static_cast<unsigned long long>(r.stateChanges));
+        Report(opt.retained ? "retained" : "immediate", opt, r);
+        return 0;
+    }
+
+    const RunResult retained = Run(opt, events, true);
+    const RunResult immediate = Run(opt, events, false);
+    std::printf("%llu state changes\n", static_cast<unsigned long long>(retained.stateChanges));
+    Report("retained", opt, retained);
+    Report("immediate", opt, immediate);
+
+    // Both modes draw the same overlay; a vertex count mismatch means a replay went stale
+    const double delta = MeanUs(retained) - MeanUs(immediate);
+    std::printf("retained vs immediate  %+.2f us/frame (%+.0f%%)\n", delta, 100.0 * delta / MeanUs(immediate));
+    if (retained.vertices != immediate.vertices)
+    {
+        std::fprintf(stderr, "vertex count differs: retained %llu, immediate %llu\n",
+            static_cast<unsigned long long>(retained.vertices), static_cast<unsigned long long>(immediate.vertices));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Image kernel cost per path (scalar, SSE2, AVX2) at the sizes the overlay uses:
+// thumbnails GSMTC hands out resampled to the display sizes, the backdrop blur, the
+// palette histogram and the corner mask.
+//
+//   rr_image_kernels [--iterations N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "image_kernels.h"
+
+using namespace ImageKernels;
+
+namespace
+{
+    std::vector<uint8_t> RandomImage(int w, int h)
+    {
+        std::mt19937 rng(static_cast<uint32_t>(w * 131 + h));
+        std::vector<uint8_t> rgba(static_cast<size_t>(w) * h * 4);
+        for (uint8_t& b : rgba) b = static_cast<uint8_t>(rng());
+        return rgba;
+    }
+
+    template <typename Body>
+    double UsPerCall(int iterations, Body&& body)
+    {
+        body();   // warm up
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) body();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / iterations;
+    }
+
+    // One row: the kernel on every path this CPU has, with the speedup over scalar
+    template <typename Body>
+    void Row(const char* label, int iterations, Body&& body)
+    {
+        std::printf("%-34s", label);
+        double scalar = 0.0;
+        for (Isa isa : { Isa::Scalar, Isa::Sse2, Isa::Avx2 })
+        {
+            if (isa > DetectIsa())
+            {
+                std::printf(" %20s", "-");
+                continue;
+            }
+
+            SetIsa(isa);
+            const double us = UsPerCall(iterations, body);
+            if (isa == Isa::Scalar) scalar = us;
+            std::printf(" %10.1f us %5.1fx", us, scalar / us);
+        }
+        std::printf("\n");
+        SetIsa(DetectIsa());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 50;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("detected %s, %d iterations\n", IsaName(DetectIsa()), iterations);
+    std::printf("%-34s %20s %20s %20s\n", "", "scalar", "sse2", "avx2");
+
+    char label[64];
+    const struct { int src; int dst; } resamples[] = {
+        { 300, 128 }, { 640, 128 }, { 640, 192 }, { 1000, 192 }, { 1000, 256 }, { 1400, 256 }, { 640, 64 },
+    };
+    for (const auto& r : resamples)
+    {
+        const std::vector<uint8_t> src = RandomImage(r.src, r.src);
+        std::vector<uint8_t> dst(static_cast<size_t>(r.dst) * r.dst * 4);
+        std::snprintf(label, sizeof(label), "resample %d -> %d", r.src, r.dst);
+        Row(label, iterations, [&] { ResampleToPremultiplied(src.data(), r.src, r.src, dst.data(), r.dst, r.dst); });
+    }
+
+    {
+        const std::vector<uint8_t> src = RandomImage(256, 256);
+        std::vector<uint8_t> work;
+        Row("premultiply 256x256", iterations * 10, [&] {
+            work = src;
+            PremultiplyRgba8(work.data(), work.size() / 4);
+        });
+        Row("rounded corners 256x256 r30", iterations * 10, [&] {
+            work = src;
+            ApplyRoundedCorners(work.data(), 256, 256, 30.0f);
+        });
+    }
+
+    {
+        const std::vector<uint8_t> src = RandomImage(64, 64);
+        std::vector<uint8_t> work;
+        Row("backdrop blur 64x64 r6 x3", iterations * 10, [&] {
+            work = src;
+            BoxBlurRgba8(work.data(), 64, 64, 6, 3);
+        });
+    }
+
+    {
+        const std::vector<uint8_t> src = RandomImage(1000, 1000);
+        std::vector<uint32_t> bins(kHistogramBins + 1);
+        Row("histogram 1000x1000", iterations, [&] {
+            std::fill(bins.begin(), bins.end(), 0u);
+            ColorHistogram(src.data(), src.size() / 4, bins.data());
+        });
+    }
+    return 0;
+}
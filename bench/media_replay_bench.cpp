@@ -0,0 +1,156 @@
+// Refresh counts and publish latency of the media pipeline for recorded (.rrmr) event
+// streams, across debounce windows. Without a file a synthetic session is replayed:
+// a browser spamming timeline events, an ad break with empty metadata and a few
+// track changes.
+//
+//   rr_media_replay [recording.rrmr] [--settle ms] [--max-latency ms]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "media_recording.h"
+#include "media_replay.h"
+#include "media_scheduler.h"
+#include "track_id.h"
+
+namespace
+{
+    class SyntheticSession
+    {
+    public:
+        void Event(int64_t ms, RefreshReason reason)
+        {
+            MediaRecord r;
+            r.kind = MediaRecord::Kind::Event;
+            r.atNs = ms * 1'000'000;
+            r.reasons = static_cast<uint32_t>(reason);
+            mRecords.push_back(r);
+        }
+
+        void State(int64_t ms, const char* title, const char* artist, int positionSec, bool playing = true)
+        {
+            MediaRecord r;
+            r.kind = MediaRecord::Kind::State;
+            r.atNs = ms * 1'000'000;
+            r.state.title = title;
+            r.state.artist = artist;
+            r.state.trackId = ComputeTrackId(title, artist, "");
+            r.state.positionSec = positionSec;
+            r.state.isPlaying = playing;
+            mRecords.push_back(r);
+        }
+
+        std::vector<MediaRecord> Take() { return std::move(mRecords); }
+
+    private:
+        std::vector<MediaRecord> mRecords;
+    };
+
+    std::vector<MediaRecord> MakeSyntheticSession()
+    {
+        SyntheticSession s;
+        s.Event(0, RefreshReason::Initial);
+        s.State(40, "Song A", "Artist", 0);
+
+        // Browser: a timeline event every 5-20 ms for a minute
+        int64_t t = 100;
+        for (int i = 0; t < 60'000; ++i)
+        {
+            s.Event(t, RefreshReason::TimelineChanged);
+            if (i % 8 == 0) s.State(t + 40, "Song A", "Artist", static_cast<int>(t / 1000));
+            t += 5 + (i * 7) % 16;
+        }
+
+        // Ad break: metadata cleared and restored, with playback flapping
+        for (int i = 0; i < 6; ++i)
+        {
+            const int64_t at = 60'000 + i * 2'500;
+            s.Event(at, RefreshReason::MediaChanged);
+            s.Event(at + 3, RefreshReason::PlaybackChanged);
+            s.State(at + 45, i % 2 ? "Song B" : "", i % 2 ? "Artist" : "", 0, i % 2 != 0);
+        }
+
+        // Track changes with the usual burst of follow-up events
+        for (int i = 0; i < 20; ++i)
+        {
+            const int64_t at = 80'000 + i * 3'000;
+            const std::string title = "Track " + std::to_string(i);
+            s.Event(at, RefreshReason::MediaChanged);
+            s.Event(at + 2, RefreshReason::PlaybackChanged);
+            s.Event(at + 9, RefreshReason::TimelineChanged);
+            s.Event(at + 30, RefreshReason::TimelineChanged);
+            s.State(at + 40, title.c_str(), "Artist", 0);
+        }
+        return s.Take();
+    }
+
+    void Print(const char* label, const MediaReplayStats& s)
+    {
+        std::printf("%-18s events %6llu  batches %5llu  full %4llu  timeline %5llu  publishes %5llu  latency p50 %6.1f  p99 %6.1f  max %6.1f ms\n",
+            label,
+            static_cast<unsigned long long>(s.events), static_cast<unsigned long long>(s.batches),
+            static_cast<unsigned long long>(s.fullRefreshes), static_cast<unsigned long long>(s.timelineRefreshes),
+            static_cast<unsigned long long>(s.publishes), s.latencyP50Ms, s.latencyP99Ms, s.latencyMaxMs);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string path;
+    int settle = -1;
+    int maxLatency = -1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--settle") && i + 1 < argc) settle = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--max-latency") && i + 1 < argc) maxLatency = std::atoi(argv[++i]);
+        else if (argv[i][0] != '-' && path.empty()) path = argv[i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [recording.rrmr] [--settle ms] [--max-latency ms]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<MediaRecord> records;
+    if (path.empty())
+    {
+        records = MakeSyntheticSession();
+        std::printf("synthetic session, %zu records\n", records.size());
+    }
+    else
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in || !ReadMediaRecording(in, records))
+        {
+            std::fprintf(stderr, "cannot read %s\n", path.c_str());
+            return 1;
+        }
+        std::printf("%s, %zu records\n", path.c_str(), records.size());
+    }
+
+    using std::chrono::milliseconds;
+    if (settle >= 0 || maxLatency >= 0)
+    {
+        const milliseconds s = settle >= 0 ? milliseconds(settle) : RefreshScheduler::kDefaultSettle;
+        const milliseconds m = maxLatency >= 0 ? milliseconds(maxLatency) : RefreshScheduler::kDefaultMaxLatency;
+        char label[64];
+        std::snprintf(label, sizeof(label), "settle %lld/%lld", static_cast<long long>(s.count()), static_cast<long long>(m.count()));
+        Print(label, SimulateMediaReplay(records, s, m));
+        return 0;
+    }
+
+    // No debouncing, then the defaults and a few neighbours
+    const struct { int settle; int maxLatency; } windows[] = { { 0, 0 }, { 20, 100 }, { 40, 150 }, { 80, 250 }, { 150, 400 } };
+    for (const auto& w : windows)
+    {
+        char label[64];
+        std::snprintf(label, sizeof(label), "settle %d/%d", w.settle, w.maxLatency);
+        Print(label, SimulateMediaReplay(records, milliseconds(w.settle), milliseconds(w.maxLatency)));
+    }
+    return 0;
+}
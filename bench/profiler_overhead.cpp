@@ -0,0 +1,93 @@
+// Cost of an RR_PROFILE_SCOPE around a small piece of work: without a scope, with the
+// profiler disabled (the default in game), enabled, and while a trace capture runs.
+//
+//   rr_profiler_overhead [--iterations N]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#include "profiler.h"
+#include "trace_writer.h"
+
+namespace
+{
+    volatile uint64_t gSink = 0;
+
+    // A few nanoseconds of work the scope is wrapped around
+    inline void Work(uint64_t i)
+    {
+        gSink = gSink + (i * 0x9E3779B97F4A7C15ull >> 7);
+    }
+
+    template <typename Body>
+    double NsPerIteration(int iterations, Body&& body)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) body(static_cast<uint64_t>(i));
+        const auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+    }
+
+    double Bare(int iterations)
+    {
+        return NsPerIteration(iterations, [](uint64_t i) { Work(i); });
+    }
+
+    double Scoped(int iterations)
+    {
+        return NsPerIteration(iterations, [](uint64_t i) {
+            RR_PROFILE_SCOPE(ProfileStage::DrawMusicState);
+            Work(i);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 5'000'000;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = std::max(1000, std::atoi(argv[++i]));
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--iterations N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Warm up caches and the clock
+    Bare(iterations / 10);
+
+    Profiler::SetEnabled(false);
+    const double bare = Bare(iterations);
+    const double disabled = Scoped(iterations);
+
+    Profiler::SetEnabled(true);
+    Profiler::Reset();
+    const double enabled = Scoped(iterations);
+    const uint64_t recorded = Profiler::Collect()[static_cast<size_t>(ProfileStage::DrawMusicState)].count;
+    Profiler::SetEnabled(false);
+
+    // Tracing only: events go to the capture buffer, which is discarded afterwards
+    const std::filesystem::path tracePath = std::filesystem::temp_directory_path() / "rr_profiler_overhead.json";
+    double tracing = 0.0;
+    if (Tracer::Start(tracePath))
+    {
+        tracing = Scoped(std::min(iterations, static_cast<int>(Tracer::kDefaultCapacity)));
+        Tracer::Stop();
+        Tracer::Shutdown();
+        std::error_code ec;
+        std::filesystem::remove(tracePath, ec);
+    }
+
+    std::printf("iterations %d\n", iterations);
+    std::printf("no scope          %6.2f ns\n", bare);
+    std::printf("profiler disabled %6.2f ns  (+%.2f ns/scope)\n", disabled, disabled - bare);
+    std::printf("profiler enabled  %6.2f ns  (+%.2f ns/scope, %llu samples)\n", enabled, enabled - bare,
+        static_cast<unsigned long long>(recorded));
+    std::printf("trace capture     %6.2f ns  (+%.2f ns/scope)\n", tracing, tracing - bare);
+    return 0;
+}
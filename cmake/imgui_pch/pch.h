@@ -0,0 +1,3 @@
+#pragma once
+// The vendored Dear ImGui sources include the plugin's precompiled header first. Outside
+// of the plugin build they need nothing from it; CMake puts this empty one in its place.
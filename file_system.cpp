@@ -0,0 +1,51 @@
+#include "file_system.h"
+
+namespace
+{
+	class StdFileSystem final : public FileSystem
+	{
+	public:
+		bool Exists(const std::filesystem::path& path) override
+		{
+			std::error_code ec;
+			return std::filesystem::exists(path, ec);
+		}
+
+		uintmax_t FileSize(const std::filesystem::path& path) override
+		{
+			std::error_code ec;
+			const uintmax_t size = std::filesystem::file_size(path, ec);
+			return ec ? 0 : size;
+		}
+
+		bool CreateDirectories(const std::filesystem::path& path, std::error_code& ec) override
+		{
+			std::filesystem::create_directories(path, ec);
+			return !ec;
+		}
+	};
+}
+
+FileSystem& DefaultFileSystem()
+{
+	static StdFileSystem fs;
+	return fs;
+}
+
+bool CountingFileSystem::Exists(const std::filesystem::path& path)
+{
+	mCalls.fetch_add(1, std::memory_order_relaxed);
+	return mInner.Exists(path);
+}
+
+uintmax_t CountingFileSystem::FileSize(const std::filesystem::path& path)
+{
+	mCalls.fetch_add(1, std::memory_order_relaxed);
+	return mInner.FileSize(path);
+}
+
+bool CountingFileSystem::CreateDirectories(const std::filesystem::path& path, std::error_code& ec)
+{
+	mCalls.fetch_add(1, std::memory_order_relaxed);
+	return mInner.CreateDirectories(path, ec);
+}
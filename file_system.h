@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <system_error>
+
+// ------------------------------------------------------------
+// Filesystem seam for code that runs on the render path.
+//
+// Frame code must not touch the disk in steady state; routing its few calls
+// through here lets a benchmark/test swap in CountingFileSystem and assert
+// zero calls per frame.
+// ------------------------------------------------------------
+class FileSystem
+{
+public:
+    virtual ~FileSystem() = default;
+
+    virtual bool Exists(const std::filesystem::path& path) = 0;
+
+    // 0 if the file is missing or unreadable
+    virtual uintmax_t FileSize(const std::filesystem::path& path) = 0;
+
+    virtual bool CreateDirectories(const std::filesystem::path& path, std::error_code& ec) = 0;
+};
+
+// std::filesystem, never throws
+FileSystem& DefaultFileSystem();
+
+// Forwards to another FileSystem and counts every call
+class CountingFileSystem final : public FileSystem
+{
+public:
+    explicit CountingFileSystem(FileSystem& inner) : mInner(inner) {}
+
+    bool Exists(const std::filesystem::path& path) override;
+    uintmax_t FileSize(const std::filesystem::path& path) override;
+    bool CreateDirectories(const std::filesystem::path& path, std::error_code& ec) override;
+
+    uint64_t Calls() const { return mCalls.load(std::memory_order_relaxed); }
+    void ResetCalls() { mCalls.store(0, std::memory_order_relaxed); }
+
+private:
+    FileSystem& mInner;
+    std::atomic<uint64_t> mCalls{0};
+};
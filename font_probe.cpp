@@ -0,0 +1,46 @@
+#include "font_probe.h"
+
+FontFileProbe::FontFileProbe(std::filesystem::path fontDir, std::filesystem::path fileName)
+    : mFontDir(std::move(fontDir))
+{
+    mFilePath = mFontDir / fileName;
+}
+
+std::filesystem::path FontFileProbe::TempPath() const
+{
+    std::filesystem::path temp = mFilePath;
+    temp.replace_extension(".tmp");
+    return temp;
+}
+
+FontProbeResult FontFileProbe::Poll(Clock::time_point now)
+{
+    FontProbeResult result;
+
+    const FontDownload download = mDownload->load(std::memory_order_acquire);
+    if (!mPresent && download == FontDownload::Done) mPresent = true;
+
+    // Failed downloads are retried, but not every frame
+    if (mChecked && !mPresent && download == FontDownload::Failed && now >= mRetryAt)
+    {
+        mDownload->store(FontDownload::Idle, std::memory_order_relaxed);
+        mChecked = false;
+    }
+
+    if (!mChecked)
+    {
+        mChecked = true;
+        mRetryAt = now + kRetryDelay;
+
+        mFileSystem->CreateDirectories(mFontDir, result.dirError);
+
+        mPresent = mFileSystem->Exists(mFilePath);
+
+        FontDownload idle = FontDownload::Idle;
+        if (!mPresent && mDownload->compare_exchange_strong(idle, FontDownload::InFlight, std::memory_order_acq_rel))
+            result.startDownload = mDownload;
+    }
+
+    result.present = mPresent;
+    return result;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+
+#include "file_system.h"
+
+// ------------------------------------------------------------
+// Whether the overlay font file is on disk, without probing every frame.
+//
+// The host polls once per frame until its fonts are loaded. The disk is probed on
+// the first poll only; while the file is missing the download thread reports back
+// through a shared flag, and a failed download is probed (and retried) again after
+// kRetryDelay. Every other poll is a couple of atomic loads.
+// ------------------------------------------------------------
+
+enum class FontDownload : int
+{
+    Idle,
+    InFlight,
+    Done,
+    Failed
+};
+
+// Shared with the download thread, which is detached and may outlive the probe
+using FontDownloadFlag = std::shared_ptr<std::atomic<FontDownload>>;
+
+struct FontProbeResult
+{
+    bool present = false;
+
+    // Set when this poll probed the disk and could not create the font directory
+    std::error_code dirError;
+
+    // Non-null: start a download into TempPath() and store Done/Failed here when it ends
+    FontDownloadFlag startDownload;
+};
+
+class FontFileProbe
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto kRetryDelay = std::chrono::seconds(30);
+
+    FontFileProbe(std::filesystem::path fontDir, std::filesystem::path fileName);
+
+    // All disk access goes through `fs` (e.g. a CountingFileSystem)
+    void SetFileSystem(FileSystem& fs) { mFileSystem = &fs; }
+
+    FontProbeResult Poll(Clock::time_point now);
+
+    const std::filesystem::path& FontDir() const { return mFontDir; }
+    const std::filesystem::path& FilePath() const { return mFilePath; }
+
+    // Downloads land here first and are renamed to FilePath() once complete
+    std::filesystem::path TempPath() const;
+
+private:
+    FileSystem* mFileSystem = &DefaultFileSystem();
+    std::filesystem::path mFontDir;
+    std::filesystem::path mFilePath;
+
+    bool mChecked = false;
+    bool mPresent = false;
+    Clock::time_point mRetryAt{};
+    FontDownloadFlag mDownload = std::make_shared<std::atomic<FontDownload>>(FontDownload::Idle);
+};
@@ -0,0 +1,912 @@
+#include "image_kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define RR_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define RR_TARGET_SSE2
+#define RR_TARGET_AVX2
+#else
+#define RR_TARGET_SSE2 __attribute__((target("sse2")))
+#define RR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define RR_KERNELS_X86 0
+#endif
+
+namespace
+{
+	// Linear light and alpha are carried as 15-bit values so they fit the signed 16-bit
+	// multiply-add of SSE2/AVX2 (_mm_madd_epi16); filter weights are Q14.
+	constexpr int kLinearMax = 32767;
+	constexpr int kWeightBits = 14;
+	constexpr int kWeightOne = 1 << kWeightBits;
+	constexpr int kWeightRound = 1 << (kWeightBits - 1);
+
+	constexpr double kLanczosLobes = 3.0;
+	constexpr double kPi = 3.14159265358979323846;
+
+	// Exact round(x / 255) for x = v * f + 128 with v, f <= 255
+	constexpr uint32_t Div255(uint32_t x)
+	{
+		return (x + (x >> 8)) >> 8;
+	}
+
+	// ------------------------------------------------------------
+	// Lookup tables (shared by every path)
+	// ------------------------------------------------------------
+
+	struct Luts
+	{
+		uint16_t srgbToLinear[256];
+		uint16_t alphaToLinear[256];
+		uint8_t linearToSrgb[kLinearMax + 1];
+
+		Luts()
+		{
+			for (int i = 0; i < 256; ++i)
+			{
+				const double c = i / 255.0;
+				const double lin = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+				srgbToLinear[i] = static_cast<uint16_t>(std::lround(lin * kLinearMax));
+				alphaToLinear[i] = static_cast<uint16_t>((i * kLinearMax + 127) / 255);
+			}
+
+			for (int i = 0; i <= kLinearMax; ++i)
+			{
+				const double lin = static_cast<double>(i) / kLinearMax;
+				const double c = lin <= 0.0031308 ? lin * 12.92 : 1.055 * std::pow(lin, 1.0 / 2.4) - 0.055;
+				linearToSrgb[i] = static_cast<uint8_t>(std::clamp(std::lround(c * 255.0), 0L, 255L));
+			}
+		}
+	};
+
+	const Luts& GetLuts()
+	{
+		static const Luts luts;
+		return luts;
+	}
+
+	// ------------------------------------------------------------
+	// Separable filter taps
+	// ------------------------------------------------------------
+
+	struct Taps
+	{
+		int count = 0;                  // per output sample, padded to a multiple of 4 with zero weights
+		std::vector<int> start;         // first input sample per output sample
+		std::vector<int16_t> weights;   // outSize * count, Q14, each row sums to kWeightOne
+	};
+
+	double Lanczos(double x)
+	{
+		x = std::fabs(x);
+		if (x < 1e-9) return 1.0;
+		if (x >= kLanczosLobes) return 0.0;
+		const double px = kPi * x;
+		return kLanczosLobes * std::sin(px) * std::sin(px / kLanczosLobes) / (px * px);
+	}
+
+	Taps BuildTaps(int inSize, int outSize)
+	{
+		const double scale = static_cast<double>(inSize) / outSize;
+		const double stretch = std::max(1.0, scale);   // widen the kernel when shrinking
+		const double support = kLanczosLobes * stretch;
+
+		std::vector<std::vector<double>> rows(outSize);
+		Taps taps;
+		taps.start.resize(outSize);
+
+		int maxCount = 1;
+		for (int i = 0; i < outSize; ++i)
+		{
+			const double center = (i + 0.5) * scale;
+			const int lo = std::max(0, static_cast<int>(std::floor(center - support)));
+			const int hi = std::min(inSize - 1, static_cast<int>(std::ceil(center + support)));
+
+			double sum = 0.0;
+			for (int j = lo; j <= hi; ++j)
+			{
+				const double w = Lanczos((j + 0.5 - center) / stretch);
+				rows[i].push_back(w);
+				sum += w;
+			}
+			for (double& w : rows[i]) w /= sum;
+
+			taps.start[i] = lo;
+			maxCount = std::max(maxCount, hi - lo + 1);
+		}
+
+		taps.count = (maxCount + 3) & ~3;
+		taps.weights.assign(static_cast<size_t>(outSize) * taps.count, 0);
+
+		for (int i = 0; i < outSize; ++i)
+		{
+			int16_t* q = taps.weights.data() + static_cast<size_t>(i) * taps.count;
+
+			int total = 0;
+			size_t peak = 0;
+			for (size_t k = 0; k < rows[i].size(); ++k)
+			{
+				q[k] = static_cast<int16_t>(std::lround(rows[i][k] * kWeightOne));
+				total += q[k];
+				if (rows[i][k] > rows[i][peak]) peak = k;
+			}
+
+			// Rounding must not brighten or darken flat areas
+			q[peak] = static_cast<int16_t>(q[peak] + (kWeightOne - total));
+		}
+
+		return taps;
+	}
+
+	constexpr uint16_t ClampLinear(int32_t acc)
+	{
+		const int32_t v = (acc + kWeightRound) >> kWeightBits;
+		return static_cast<uint16_t>(v < 0 ? 0 : (v > kLinearMax ? kLinearMax : v));
+	}
+
+	// ------------------------------------------------------------
+	// Scalar reference kernels
+	// ------------------------------------------------------------
+
+	// RGB *= A, 15-bit, alpha untouched
+	void Premultiply15Scalar(uint16_t* p, size_t pixels)
+	{
+		for (size_t i = 0; i < pixels; ++i, p += 4)
+		{
+			const uint32_t a = p[3];
+			for (int c = 0; c < 3; ++c) p[c] = static_cast<uint16_t>((p[c] * a + 16384) >> 15);
+		}
+	}
+
+	// One row: out[x] = sum_k w[x][k] * in[start[x] + k]; `in` has taps.count zero pixels of padding
+	void HorizontalScalar(const uint16_t* in, uint16_t* out, int outWidth, const Taps& taps)
+	{
+		for (int x = 0; x < outWidth; ++x)
+		{
+			const int16_t* w = taps.weights.data() + static_cast<size_t>(x) * taps.count;
+			const uint16_t* px = in + static_cast<size_t>(taps.start[x]) * 4;
+
+			int32_t acc[4] = {};
+			for (int k = 0; k < taps.count; ++k)
+				for (int c = 0; c < 4; ++c) acc[c] += w[k] * px[k * 4 + c];
+
+			for (int c = 0; c < 4; ++c) out[x * 4 + c] = ClampLinear(acc[c]);
+		}
+	}
+
+	// One output row from `count` input rows (count is a multiple of 4)
+	void VerticalScalar(const uint16_t* const* rows, const int16_t* w, int count, uint16_t* out, size_t values)
+	{
+		for (size_t v = 0; v < values; ++v)
+		{
+			int32_t acc = 0;
+			for (int k = 0; k < count; ++k) acc += w[k] * rows[k][v];
+			out[v] = ClampLinear(acc);
+		}
+	}
+
+	void Premultiply8Scalar(uint8_t* p, size_t pixels)
+	{
+		for (size_t i = 0; i < pixels; ++i, p += 4)
+		{
+			const uint32_t a = p[3];
+			for (int c = 0; c < 3; ++c) p[c] = static_cast<uint8_t>(Div255(p[c] * a + 128));
+		}
+	}
+
+	void MultiplyAlphaScalar(uint8_t* p, const uint8_t* coverage, size_t pixels)
+	{
+		for (size_t i = 0; i < pixels; ++i, p += 4)
+			p[3] = static_cast<uint8_t>(Div255(p[3] * static_cast<uint32_t>(coverage[i]) + 128));
+	}
+
+	// 5:5:5 bin of a pixel, or the skip bin when alpha < 128
+	constexpr uint32_t HistogramBin(const uint8_t* p)
+	{
+		if (p[3] < 128) return ImageKernels::kHistogramBins;
+		return (static_cast<uint32_t>(p[0] >> 3) << 10) | (static_cast<uint32_t>(p[1] >> 3) << 5) | (p[2] >> 3);
+	}
+
+	void HistogramScalar(const uint8_t* p, size_t pixels, uint32_t* bins)
+	{
+		for (size_t i = 0; i < pixels; ++i, p += 4) ++bins[HistogramBin(p)];
+	}
+
+	// Running box sum down `values` byte columns (rows `stride` bytes apart), edges clamped;
+	// src and dst must not overlap. Sums stay below 2^16 for radius <= kMaxBlurRadius, so the
+	// SIMD paths carry them in 16-bit lanes, and (sum * inv) >> 16 with inv = ceil(2^16 / taps)
+	// is the division every path shares.
+	void BoxColumnsScalar(const uint8_t* src, uint8_t* dst, size_t values, size_t stride, int height, int radius, uint32_t inv)
+	{
+		for (size_t v = 0; v < values; ++v)
+		{
+			const uint8_t* col = src + v;
+
+			uint32_t sum = col[0] * static_cast<uint32_t>(radius + 1);
+			for (int k = 1; k <= radius; ++k) sum += col[static_cast<size_t>(std::min(k, height - 1)) * stride];
+
+			for (int y = 0; y < height; ++y)
+			{
+				dst[static_cast<size_t>(y) * stride + v] = static_cast<uint8_t>((sum * inv) >> 16);
+				sum += col[static_cast<size_t>(std::min(y + radius + 1, height - 1)) * stride];
+				sum -= col[static_cast<size_t>(std::max(y - radius, 0)) * stride];
+			}
+		}
+	}
+
+#if RR_KERNELS_X86
+	// ------------------------------------------------------------
+	// SSE2
+	// ------------------------------------------------------------
+
+	inline int32_t WeightPair(const int16_t* w)
+	{
+		return static_cast<int32_t>(static_cast<uint16_t>(w[0]) | (static_cast<uint32_t>(static_cast<uint16_t>(w[1])) << 16));
+	}
+
+	RR_TARGET_SSE2 inline __m128i RoundClamp(__m128i lo, __m128i hi)
+	{
+		const __m128i round = _mm_set1_epi32(kWeightRound);
+		lo = _mm_srai_epi32(_mm_add_epi32(lo, round), kWeightBits);
+		hi = _mm_srai_epi32(_mm_add_epi32(hi, round), kWeightBits);
+		return _mm_max_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+	}
+
+	RR_TARGET_SSE2 void Premultiply15Sse2(uint16_t* p, size_t pixels)
+	{
+		const __m128i alphaMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+		const __m128i round = _mm_set1_epi32(16384);
+
+		size_t i = 0;
+		for (; i + 2 <= pixels; i += 2)
+		{
+			__m128i* ptr = reinterpret_cast<__m128i*>(p + i * 4);
+			const __m128i v = _mm_loadu_si128(ptr);
+			const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xFF), 0xFF);
+
+			const __m128i lo = _mm_mullo_epi16(v, a);
+			const __m128i hi = _mm_mulhi_epu16(v, a);
+			const __m128i p0 = _mm_srli_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), 15);
+			const __m128i p1 = _mm_srli_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), 15);
+
+			const __m128i r = _mm_packs_epi32(p0, p1);
+			_mm_storeu_si128(ptr, _mm_or_si128(_mm_andnot_si128(alphaMask, r), _mm_and_si128(alphaMask, v)));
+		}
+
+		Premultiply15Scalar(p + i * 4, pixels - i);
+	}
+
+	RR_TARGET_SSE2 void HorizontalSse2(const uint16_t* in, uint16_t* out, int outWidth, const Taps& taps)
+	{
+		for (int x = 0; x < outWidth; ++x)
+		{
+			const int16_t* w = taps.weights.data() + static_cast<size_t>(x) * taps.count;
+			const uint16_t* px = in + static_cast<size_t>(taps.start[x]) * 4;
+
+			// Two taps per step: interleave their channels and multiply-add against (w0, w1)
+			__m128i acc = _mm_setzero_si128();
+			for (int k = 0; k < taps.count; k += 2)
+			{
+				const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px + k * 4));
+				const __m128i pair = _mm_unpacklo_epi16(p, _mm_srli_si128(p, 8));
+				acc = _mm_add_epi32(acc, _mm_madd_epi16(pair, _mm_set1_epi32(WeightPair(w + k))));
+			}
+
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), RoundClamp(acc, acc));
+		}
+	}
+
+	RR_TARGET_SSE2 void VerticalSse2(const uint16_t* const* rows, const int16_t* w, int count, uint16_t* out, size_t values)
+	{
+		size_t v = 0;
+		for (; v + 8 <= values; v += 8)
+		{
+			__m128i lo = _mm_setzero_si128();
+			__m128i hi = _mm_setzero_si128();
+			for (int k = 0; k < count; k += 2)
+			{
+				const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + v));
+				const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k + 1] + v));
+				const __m128i wp = _mm_set1_epi32(WeightPair(w + k));
+				lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), wp));
+				hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), wp));
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + v), RoundClamp(lo, hi));
+		}
+
+		if (v < values)
+		{
+			std::vector<const uint16_t*> tail(rows, rows + count);
+			for (const uint16_t*& row : tail) row += v;
+			VerticalScalar(tail.data(), w, count, out + v, values - v);
+		}
+	}
+
+	// c = round(c * f / 255) per 16-bit lane, f already spread per channel
+	RR_TARGET_SSE2 inline __m128i MulDiv255(__m128i c, __m128i f)
+	{
+		const __m128i x = _mm_add_epi16(_mm_mullo_epi16(c, f), _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+	}
+
+	RR_TARGET_SSE2 void Premultiply8Sse2(uint8_t* p, size_t pixels)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alphaMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+
+		size_t i = 0;
+		for (; i + 4 <= pixels; i += 4)
+		{
+			__m128i* ptr = reinterpret_cast<__m128i*>(p + i * 4);
+			const __m128i v = _mm_loadu_si128(ptr);
+
+			__m128i lo = _mm_unpacklo_epi8(v, zero);
+			__m128i hi = _mm_unpackhi_epi8(v, zero);
+			const __m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF);
+			const __m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF);
+
+			lo = _mm_or_si128(_mm_andnot_si128(alphaMask, MulDiv255(lo, alo)), _mm_and_si128(alphaMask, lo));
+			hi = _mm_or_si128(_mm_andnot_si128(alphaMask, MulDiv255(hi, ahi)), _mm_and_si128(alphaMask, hi));
+			_mm_storeu_si128(ptr, _mm_packus_epi16(lo, hi));
+		}
+
+		Premultiply8Scalar(p + i * 4, pixels - i);
+	}
+
+	RR_TARGET_SSE2 void MultiplyAlphaSse2(uint8_t* p, const uint8_t* coverage, size_t pixels)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alphaMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+		const __m128i opaque = _mm_andnot_si128(alphaMask, _mm_set1_epi16(255));
+
+		size_t i = 0;
+		for (; i + 4 <= pixels; i += 4)
+		{
+			__m128i* ptr = reinterpret_cast<__m128i*>(p + i * 4);
+			const __m128i v = _mm_loadu_si128(ptr);
+
+			// c0 c0 c1 c1 c2 c2 c3 c3 -> per-pixel factors (255, 255, 255, coverage)
+			int32_t cov4;
+			std::copy(coverage + i, coverage + i + 4, reinterpret_cast<uint8_t*>(&cov4));
+			const __m128i c16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(cov4), zero);
+			const __m128i c32 = _mm_unpacklo_epi16(c16, c16);
+			const __m128i flo = _mm_or_si128(opaque, _mm_and_si128(alphaMask, _mm_unpacklo_epi32(c32, c32)));
+			const __m128i fhi = _mm_or_si128(opaque, _mm_and_si128(alphaMask, _mm_unpackhi_epi32(c32, c32)));
+
+			const __m128i lo = MulDiv255(_mm_unpacklo_epi8(v, zero), flo);
+			const __m128i hi = MulDiv255(_mm_unpackhi_epi8(v, zero), fhi);
+			_mm_storeu_si128(ptr, _mm_packus_epi16(lo, hi));
+		}
+
+		MultiplyAlphaScalar(p + i * 4, coverage + i, pixels - i);
+	}
+
+	// Bin indices are computed four pixels at a time; the increments stay scalar (no scatter in
+	// SSE2). Runs of one bin (flat art) are counted in a register instead of chaining increments
+	// through the same counter.
+	RR_TARGET_SSE2 void HistogramSse2(const uint8_t* p, size_t pixels, uint32_t* bins)
+	{
+		const __m128i top5 = _mm_set1_epi32(0xF8);
+		const __m128i low5 = _mm_set1_epi32(0x1F);
+		const __m128i skip = _mm_set1_epi32(static_cast<int>(ImageKernels::kHistogramBins));
+
+		alignas(16) uint32_t index[4];
+		uint32_t runBin = ImageKernels::kHistogramBins;
+		uint32_t run = 0;
+
+		size_t i = 0;
+		for (; i + 4 <= pixels; i += 4)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 4));
+
+			const __m128i r = _mm_slli_epi32(_mm_and_si128(v, top5), 7);
+			const __m128i g = _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 8), top5), 2);
+			const __m128i b = _mm_and_si128(_mm_srli_epi32(v, 19), low5);
+			const __m128i bin = _mm_or_si128(r, _mm_or_si128(g, b));
+
+			// Alpha >= 128 is the sign bit of each pixel
+			const __m128i keep = _mm_srai_epi32(v, 31);
+			const __m128i idx = _mm_or_si128(_mm_and_si128(keep, bin), _mm_andnot_si128(keep, skip));
+
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(idx, _mm_set1_epi32(static_cast<int>(runBin)))) == 0xFFFF)
+			{
+				run += 4;
+				continue;
+			}
+
+			_mm_store_si128(reinterpret_cast<__m128i*>(index), idx);
+			bins[runBin] += run;
+			++bins[index[0]];
+			++bins[index[1]];
+			++bins[index[2]];
+			runBin = index[3];
+			run = 1;
+		}
+		bins[runBin] += run;
+
+		HistogramScalar(p + i * 4, pixels - i, bins);
+	}
+
+	RR_TARGET_SSE2 void BoxColumnsSse2(const uint8_t* src, uint8_t* dst, size_t values, size_t stride, int height, int radius, uint32_t inv)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i scale = _mm_set1_epi16(static_cast<short>(inv));
+		const __m128i edge = _mm_set1_epi16(static_cast<short>(radius + 1));
+
+		size_t v = 0;
+		for (; v + 16 <= values; v += 16)
+		{
+			const uint8_t* col = src + v;
+
+			const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(col));
+			__m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(first, zero), edge);
+			__m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(first, zero), edge);
+			for (int k = 1; k <= radius; ++k)
+			{
+				const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(col + static_cast<size_t>(std::min(k, height - 1)) * stride));
+				lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(r, zero));
+				hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(r, zero));
+			}
+
+			for (int y = 0; y < height; ++y)
+			{
+				const __m128i out = _mm_packus_epi16(_mm_mulhi_epu16(lo, scale), _mm_mulhi_epu16(hi, scale));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + static_cast<size_t>(y) * stride + v), out);
+
+				// Wraps in between, but the true sum is always back in range
+				const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(col + static_cast<size_t>(std::min(y + radius + 1, height - 1)) * stride));
+				const __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i*>(col + static_cast<size_t>(std::max(y - radius, 0)) * stride));
+				lo = _mm_sub_epi16(_mm_add_epi16(lo, _mm_unpacklo_epi8(in, zero)), _mm_unpacklo_epi8(old, zero));
+				hi = _mm_sub_epi16(_mm_add_epi16(hi, _mm_unpackhi_epi8(in, zero)), _mm_unpackhi_epi8(old, zero));
+			}
+		}
+
+		if (v < values) BoxColumnsScalar(src + v, dst + v, values - v, stride, height, radius, inv);
+	}
+
+	// ------------------------------------------------------------
+	// AVX2
+	// ------------------------------------------------------------
+
+	RR_TARGET_AVX2 inline __m256i RoundClamp256(__m256i lo, __m256i hi)
+	{
+		const __m256i round = _mm256_set1_epi32(kWeightRound);
+		lo = _mm256_srai_epi32(_mm256_add_epi32(lo, round), kWeightBits);
+		hi = _mm256_srai_epi32(_mm256_add_epi32(hi, round), kWeightBits);
+		return _mm256_max_epi16(_mm256_packs_epi32(lo, hi), _mm256_setzero_si256());
+	}
+
+	RR_TARGET_AVX2 void Premultiply15Avx2(uint16_t* p, size_t pixels)
+	{
+		const __m256i alphaMask = _mm256_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1);
+		const __m256i round = _mm256_set1_epi32(16384);
+
+		size_t i = 0;
+		for (; i + 4 <= pixels; i += 4)
+		{
+			__m256i* ptr = reinterpret_cast<__m256i*>(p + i * 4);
+			const __m256i v = _mm256_loadu_si256(ptr);
+			const __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, 0xFF), 0xFF);
+
+			const __m256i lo = _mm256_mullo_epi16(v, a);
+			const __m256i hi = _mm256_mulhi_epu16(v, a);
+			const __m256i p0 = _mm256_srli_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(lo, hi), round), 15);
+			const __m256i p1 = _mm256_srli_epi32(_mm256_add_epi32(_mm256_unpackhi_epi16(lo, hi), round), 15);
+
+			const __m256i r = _mm256_packs_epi32(p0, p1);
+			_mm256_storeu_si256(ptr, _mm256_or_si256(_mm256_andnot_si256(alphaMask, r), _mm256_and_si256(alphaMask, v)));
+		}
+
+		Premultiply15Sse2(p + i * 4, pixels - i);
+	}
+
+	RR_TARGET_AVX2 void HorizontalAvx2(const uint16_t* in, uint16_t* out, int outWidth, const Taps& taps)
+	{
+		// (w0, w1) into the low four dwords, (w2, w3) into the high four
+		const __m256i pairIndex = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+
+		for (int x = 0; x < outWidth; ++x)
+		{
+			const int16_t* w = taps.weights.data() + static_cast<size_t>(x) * taps.count;
+			const uint16_t* px = in + static_cast<size_t>(taps.start[x]) * 4;
+
+			// Four taps per step: taps 0/1 in the low lane, 2/3 in the high lane
+			__m256i acc = _mm256_setzero_si256();
+			for (int k = 0; k < taps.count; k += 4)
+			{
+				const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(px + k * 4));
+				const __m256i pairs = _mm256_unpacklo_epi16(p, _mm256_srli_si256(p, 8));
+				const __m128i w4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w + k));
+				const __m256i wp = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(w4), pairIndex);
+				acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, wp));
+			}
+
+			const __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), RoundClamp(sum, sum));
+		}
+	}
+
+	RR_TARGET_AVX2 void VerticalAvx2(const uint16_t* const* rows, const int16_t* w, int count, uint16_t* out, size_t values)
+	{
+		size_t v = 0;
+		for (; v + 16 <= values; v += 16)
+		{
+			__m256i lo = _mm256_setzero_si256();
+			__m256i hi = _mm256_setzero_si256();
+			for (int k = 0; k < count; k += 2)
+			{
+				const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k] + v));
+				const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k + 1] + v));
+				const __m256i wp = _mm256_set1_epi32(WeightPair(w + k));
+				lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), wp));
+				hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), wp));
+			}
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + v), RoundClamp256(lo, hi));
+		}
+
+		if (v < values)
+		{
+			std::vector<const uint16_t*> tail(rows, rows + count);
+			for (const uint16_t*& row : tail) row += v;
+			VerticalSse2(tail.data(), w, count, out + v, values - v);
+		}
+	}
+
+	RR_TARGET_AVX2 void Premultiply8Avx2(uint8_t* p, size_t pixels)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i alphaMask = _mm256_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1);
+		const __m256i half = _mm256_set1_epi16(128);
+
+		size_t i = 0;
+		for (; i + 8 <= pixels; i += 8)
+		{
+			__m256i* ptr = reinterpret_cast<__m256i*>(p + i * 4);
+			const __m256i v = _mm256_loadu_si256(ptr);
+
+			__m256i lo = _mm256_unpacklo_epi8(v, zero);
+			__m256i hi = _mm256_unpackhi_epi8(v, zero);
+			const __m256i alo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, 0xFF), 0xFF);
+			const __m256i ahi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, 0xFF), 0xFF);
+
+			__m256i xlo = _mm256_add_epi16(_mm256_mullo_epi16(lo, alo), half);
+			__m256i xhi = _mm256_add_epi16(_mm256_mullo_epi16(hi, ahi), half);
+			xlo = _mm256_srli_epi16(_mm256_add_epi16(xlo, _mm256_srli_epi16(xlo, 8)), 8);
+			xhi = _mm256_srli_epi16(_mm256_add_epi16(xhi, _mm256_srli_epi16(xhi, 8)), 8);
+
+			lo = _mm256_or_si256(_mm256_andnot_si256(alphaMask, xlo), _mm256_and_si256(alphaMask, lo));
+			hi = _mm256_or_si256(_mm256_andnot_si256(alphaMask, xhi), _mm256_and_si256(alphaMask, hi));
+			_mm256_storeu_si256(ptr, _mm256_packus_epi16(lo, hi));
+		}
+
+		Premultiply8Sse2(p + i * 4, pixels - i);
+	}
+
+	RR_TARGET_AVX2 void HistogramAvx2(const uint8_t* p, size_t pixels, uint32_t* bins)
+	{
+		const __m256i top5 = _mm256_set1_epi32(0xF8);
+		const __m256i low5 = _mm256_set1_epi32(0x1F);
+		const __m256i skip = _mm256_set1_epi32(static_cast<int>(ImageKernels::kHistogramBins));
+
+		alignas(32) uint32_t index[8];
+		uint32_t runBin = ImageKernels::kHistogramBins;
+		uint32_t run = 0;
+
+		size_t i = 0;
+		for (; i + 8 <= pixels; i += 8)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i * 4));
+
+			const __m256i r = _mm256_slli_epi32(_mm256_and_si256(v, top5), 7);
+			const __m256i g = _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(v, 8), top5), 2);
+			const __m256i b = _mm256_and_si256(_mm256_srli_epi32(v, 19), low5);
+			const __m256i bin = _mm256_or_si256(r, _mm256_or_si256(g, b));
+
+			const __m256i keep = _mm256_srai_epi32(v, 31);
+			const __m256i idx = _mm256_blendv_epi8(skip, bin, keep);
+
+			if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(idx, _mm256_set1_epi32(static_cast<int>(runBin)))) == -1)
+			{
+				run += 8;
+				continue;
+			}
+
+			_mm256_store_si256(reinterpret_cast<__m256i*>(index), idx);
+			bins[runBin] += run;
+			for (int k = 0; k < 7; ++k) ++bins[index[k]];
+			runBin = index[7];
+			run = 1;
+		}
+		bins[runBin] += run;
+
+		HistogramSse2(p + i * 4, pixels - i, bins);
+	}
+
+	RR_TARGET_AVX2 void BoxColumnsAvx2(const uint8_t* src, uint8_t* dst, size_t values, size_t stride, int height, int radius, uint32_t inv)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i scale = _mm256_set1_epi16(static_cast<short>(inv));
+		const __m256i edge = _mm256_set1_epi16(static_cast<short>(radius + 1));
+
+		size_t v = 0;
+		for (; v + 32 <= values; v += 32)
+		{
+			const uint8_t* col = src + v;
+
+			// unpack/pack work per 128-bit lane, so the bytes come back in order
+			const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col));
+			__m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(first, zero), edge);
+			__m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(first, zero), edge);
+			for (int k = 1; k <= radius; ++k)
+			{
+				const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + static_cast<size_t>(std::min(k, height - 1)) * stride));
+				lo = _mm256_add_epi16(lo, _mm256_unpacklo_epi8(r, zero));
+				hi = _mm256_add_epi16(hi, _mm256_unpackhi_epi8(r, zero));
+			}
+
+			for (int y = 0; y < height; ++y)
+			{
+				const __m256i out = _mm256_packus_epi16(_mm256_mulhi_epu16(lo, scale), _mm256_mulhi_epu16(hi, scale));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + static_cast<size_t>(y) * stride + v), out);
+
+				const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + static_cast<size_t>(std::min(y + radius + 1, height - 1)) * stride));
+				const __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + static_cast<size_t>(std::max(y - radius, 0)) * stride));
+				lo = _mm256_sub_epi16(_mm256_add_epi16(lo, _mm256_unpacklo_epi8(in, zero)), _mm256_unpacklo_epi8(old, zero));
+				hi = _mm256_sub_epi16(_mm256_add_epi16(hi, _mm256_unpackhi_epi8(in, zero)), _mm256_unpackhi_epi8(old, zero));
+			}
+		}
+
+		if (v < values) BoxColumnsSse2(src + v, dst + v, values - v, stride, height, radius, inv);
+	}
+#endif
+
+	// ------------------------------------------------------------
+	// Dispatch
+	// ------------------------------------------------------------
+
+	struct KernelTable
+	{
+		void (*premultiply15)(uint16_t*, size_t);
+		void (*horizontal)(const uint16_t*, uint16_t*, int, const Taps&);
+		void (*vertical)(const uint16_t* const*, const int16_t*, int, uint16_t*, size_t);
+		void (*premultiply8)(uint8_t*, size_t);
+		void (*multiplyAlpha)(uint8_t*, const uint8_t*, size_t);
+		void (*histogram)(const uint8_t*, size_t, uint32_t*);
+		void (*boxColumns)(const uint8_t*, uint8_t*, size_t, size_t, int, int, uint32_t);
+	};
+
+	constexpr KernelTable kScalarKernels{ Premultiply15Scalar, HorizontalScalar, VerticalScalar, Premultiply8Scalar, MultiplyAlphaScalar, HistogramScalar, BoxColumnsScalar };
+#if RR_KERNELS_X86
+	constexpr KernelTable kSse2Kernels{ Premultiply15Sse2, HorizontalSse2, VerticalSse2, Premultiply8Sse2, MultiplyAlphaSse2, HistogramSse2, BoxColumnsSse2 };
+
+	// Corner masks touch a few hundred pixels; the SSE2 version is plenty
+	constexpr KernelTable kAvx2Kernels{ Premultiply15Avx2, HorizontalAvx2, VerticalAvx2, Premultiply8Avx2, MultiplyAlphaSse2, HistogramAvx2, BoxColumnsAvx2 };
+#endif
+
+	std::atomic<ImageKernels::Isa>& ActiveSlot()
+	{
+		static std::atomic<ImageKernels::Isa> isa{ ImageKernels::DetectIsa() };
+		return isa;
+	}
+
+	const KernelTable& Kernels()
+	{
+#if RR_KERNELS_X86
+		switch (ActiveSlot().load(std::memory_order_relaxed))
+		{
+			case ImageKernels::Isa::Avx2: return kAvx2Kernels;
+			case ImageKernels::Isa::Sse2: return kSse2Kernels;
+			case ImageKernels::Isa::Scalar: break;
+		}
+#endif
+		return kScalarKernels;
+	}
+
+	// 15-bit premultiplied linear -> 8-bit premultiplied sRGB (table lookups, same on every path)
+	void StoreRow(const uint16_t* in, uint8_t* out, int width, const Luts& luts)
+	{
+		for (int x = 0; x < width; ++x, in += 4, out += 4)
+		{
+			const uint32_t pa = in[3];
+			const uint32_t a8 = (pa * 255 + kLinearMax / 2) / kLinearMax;
+			if (a8 == 0)
+			{
+				out[0] = out[1] = out[2] = out[3] = 0;
+				continue;
+			}
+
+			for (int c = 0; c < 3; ++c)
+			{
+				// Ringing can overshoot alpha; clamp after un-premultiplying
+				const uint32_t lin = std::min<uint32_t>(kLinearMax, (in[c] * static_cast<uint32_t>(kLinearMax) + pa / 2) / pa);
+				const uint32_t s = luts.linearToSrgb[lin];
+				out[c] = static_cast<uint8_t>(a8 == 255 ? s : Div255(s * a8 + 128));
+			}
+			out[3] = static_cast<uint8_t>(a8);
+		}
+	}
+
+	// RGBA pixels of a w x h image -> h x w image
+	void Transpose(const uint8_t* src, uint8_t* dst, int width, int height)
+	{
+		for (int y = 0; y < height; ++y)
+			for (int x = 0; x < width; ++x)
+				std::memcpy(dst + (static_cast<size_t>(x) * height + y) * 4, src + (static_cast<size_t>(y) * width + x) * 4, 4);
+	}
+}
+
+namespace ImageKernels
+{
+	const char* IsaName(Isa isa)
+	{
+		switch (isa)
+		{
+			case Isa::Scalar: return "scalar";
+			case Isa::Sse2:   return "SSE2";
+			case Isa::Avx2:   return "AVX2";
+		}
+		return "?";
+	}
+
+	Isa DetectIsa()
+	{
+#if RR_KERNELS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4] = {};
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		const bool sse2 = (info[3] & (1 << 26)) != 0;
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+
+		bool avx2 = false;
+		if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		const bool sse2 = __builtin_cpu_supports("sse2");
+		const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+		if (avx2) return Isa::Avx2;
+		if (sse2) return Isa::Sse2;
+#endif
+		return Isa::Scalar;
+	}
+
+	Isa ActiveIsa()
+	{
+		return ActiveSlot().load(std::memory_order_relaxed);
+	}
+
+	void SetIsa(Isa isa)
+	{
+		ActiveSlot().store(std::min(isa, DetectIsa()), std::memory_order_relaxed);
+	}
+
+	void ResampleToPremultiplied(const uint8_t* src, int sw, int sh, uint8_t* dst, int dw, int dh)
+	{
+		if (sw <= 0 || sh <= 0 || dw <= 0 || dh <= 0) return;
+
+		const Luts& luts = GetLuts();
+		const KernelTable& k = Kernels();
+
+		const Taps hTaps = BuildTaps(sw, dw);
+		const Taps vTaps = BuildTaps(sh, dh);
+
+		// Input row in linear light with zero padding for the last taps
+		std::vector<uint16_t> line((static_cast<size_t>(sw) + hTaps.count) * 4, 0);
+
+		// Horizontally filtered rows, plus zero rows for padded vertical taps
+		const size_t rowValues = static_cast<size_t>(dw) * 4;
+		std::vector<uint16_t> mid((static_cast<size_t>(sh) + vTaps.count) * rowValues, 0);
+
+		for (int y = 0; y < sh; ++y)
+		{
+			const uint8_t* s = src + static_cast<size_t>(y) * sw * 4;
+			for (int x = 0; x < sw; ++x)
+			{
+				line[x * 4 + 0] = luts.srgbToLinear[s[x * 4 + 0]];
+				line[x * 4 + 1] = luts.srgbToLinear[s[x * 4 + 1]];
+				line[x * 4 + 2] = luts.srgbToLinear[s[x * 4 + 2]];
+				line[x * 4 + 3] = luts.alphaToLinear[s[x * 4 + 3]];
+			}
+			k.premultiply15(line.data(), static_cast<size_t>(sw));
+			k.horizontal(line.data(), mid.data() + y * rowValues, dw, hTaps);
+		}
+
+		std::vector<uint16_t> out(rowValues);
+		std::vector<const uint16_t*> rows(vTaps.count);
+
+		for (int y = 0; y < dh; ++y)
+		{
+			const int start = vTaps.start[y];
+			for (int t = 0; t < vTaps.count; ++t) rows[t] = mid.data() + static_cast<size_t>(start + t) * rowValues;
+
+			k.vertical(rows.data(), vTaps.weights.data() + static_cast<size_t>(y) * vTaps.count, vTaps.count, out.data(), rowValues);
+			StoreRow(out.data(), dst + static_cast<size_t>(y) * dw * 4, dw, luts);
+		}
+	}
+
+	void PremultiplyRgba8(uint8_t* rgba, size_t pixels)
+	{
+		Kernels().premultiply8(rgba, pixels);
+	}
+
+	void ApplyRoundedCorners(uint8_t* rgba, int width, int height, float radiusPx)
+	{
+		const float r = std::min(radiusPx, 0.5f * static_cast<float>(std::min(width, height)));
+		if (!(r > 0.0f)) return;
+
+		const int n = static_cast<int>(std::ceil(r));
+		const KernelTable& k = Kernels();
+
+		// Coverage of one corner (top-left), mirrored for the others
+		std::vector<uint8_t> left(n);
+		std::vector<uint8_t> right(n);
+
+		for (int y = 0; y < n; ++y)
+		{
+			for (int x = 0; x < n; ++x)
+			{
+				const float dx = r - (static_cast<float>(x) + 0.5f);
+				const float dy = r - (static_cast<float>(y) + 0.5f);
+
+				float cov = 1.0f;
+				if (dx > 0.0f && dy > 0.0f)
+					cov = std::clamp(r - std::sqrt(dx * dx + dy * dy) + 0.5f, 0.0f, 1.0f);
+
+				left[x] = static_cast<uint8_t>(std::lround(cov * 255.0f));
+				right[n - 1 - x] = left[x];
+			}
+
+			for (const int row : { y, height - 1 - y })
+			{
+				uint8_t* line = rgba + static_cast<size_t>(row) * width * 4;
+				k.multiplyAlpha(line, left.data(), static_cast<size_t>(n));
+				k.multiplyAlpha(line + static_cast<size_t>(width - n) * 4, right.data(), static_cast<size_t>(n));
+			}
+		}
+	}
+
+	void ColorHistogram(const uint8_t* rgba, size_t pixels, uint32_t* bins)
+	{
+		Kernels().histogram(rgba, pixels, bins);
+	}
+
+	void BoxBlurRgba8(uint8_t* rgba, int width, int height, int radius, int passes)
+	{
+		if (width <= 0 || height <= 0 || passes <= 0 || radius <= 0) return;
+		radius = std::min(radius, kMaxBlurRadius);
+
+		const uint32_t taps = 2 * static_cast<uint32_t>(radius) + 1;
+		const uint32_t inv = ((1u << 16) + taps - 1) / taps;
+		const KernelTable& k = Kernels();
+
+		// Columns are the SIMD-friendly direction, so rows are blurred as columns of the transpose
+		const size_t bytes = static_cast<size_t>(width) * height * 4;
+		std::vector<uint8_t> a(bytes);
+		std::vector<uint8_t> b(bytes);
+
+		for (int pass = 0; pass < passes; ++pass)
+		{
+			k.boxColumns(rgba, a.data(), static_cast<size_t>(width) * 4, static_cast<size_t>(width) * 4, height, radius, inv);
+			Transpose(a.data(), b.data(), width, height);
+			k.boxColumns(b.data(), a.data(), static_cast<size_t>(height) * 4, static_cast<size_t>(height) * 4, width, radius, inv);
+			Transpose(a.data(), rgba, height, width);
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Album art pixel kernels (RGBA8, rows tightly packed).
+//
+// Each kernel has a scalar reference and SSE2/AVX2 paths picked once at runtime
+// from CPUID. All arithmetic is fixed-point integer, so every path produces the
+// same bytes as the scalar reference; SetIsa() forces a path for verification
+// and benchmarks.
+// ------------------------------------------------------------
+namespace ImageKernels
+{
+    enum class Isa : uint8_t
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+    };
+
+    const char* IsaName(Isa isa);
+
+    // Best path this CPU (and OS) supports
+    Isa DetectIsa();
+
+    // Path in use; defaults to DetectIsa()
+    Isa ActiveIsa();
+
+    // Forces a path (clamped to DetectIsa()); not meant to be called while kernels run
+    void SetIsa(Isa isa);
+
+    // Straight-alpha sRGB `src` -> premultiplied sRGB `dst` at dw x dh. Separable Lanczos-3,
+    // filtered in linear light with premultiplied alpha so averages are sRGB-correct and
+    // transparent pixels do not bleed. Upscaling falls back to a plain Lanczos-3 interpolation.
+    void ResampleToPremultiplied(const uint8_t* src, int sw, int sh, uint8_t* dst, int dw, int dh);
+
+    // Straight -> premultiplied in place (sRGB space, rounded)
+    void PremultiplyRgba8(uint8_t* rgba, size_t pixels);
+
+    // Anti-aliased rounded-corner mask on straight-alpha pixels: scales alpha only
+    void ApplyRoundedCorners(uint8_t* rgba, int width, int height, float radiusPx);
+
+    // 5:5:5 RGB bins: (r >> 3) << 10 | (g >> 3) << 5 | (b >> 3)
+    inline constexpr uint32_t kHistogramBins = 1u << 15;
+
+    // Adds every pixel to its bin in `bins` (kHistogramBins + 1 counters, not cleared);
+    // pixels with alpha < 128 go to bins[kHistogramBins] instead
+    void ColorHistogram(const uint8_t* rgba, size_t pixels, uint32_t* bins);
+
+    // Largest radius whose box sums fit the 16-bit lanes of the SIMD paths
+    inline constexpr int kMaxBlurRadius = 127;
+
+    // `passes` separable box blurs of 2 * radius + 1 taps, edges clamped (three passes are
+    // close to a Gaussian). Works on any alpha mode; premultiplied input keeps edges clean.
+    void BoxBlurRgba8(uint8_t* rgba, int width, int height, int radius, int passes);
+}
@@ -0,0 +1,204 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::filesystem::path& path, uint64_t minSize)
+{
+	Close();
+
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	file_ = file;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file, &size))
+	{
+		Close();
+		return false;
+	}
+
+	size_ = static_cast<uint64_t>(size.QuadPart);
+	if (!(size_ < minSize ? Resize(minSize) : Map()))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close()
+{
+	Flush();
+	Unmap();
+
+	if (file_)
+	{
+		CloseHandle(static_cast<HANDLE>(file_));
+		file_ = nullptr;
+	}
+	size_ = 0;
+}
+
+bool MappedFile::Resize(uint64_t size)
+{
+	if (!file_) return false;
+
+	Unmap();
+
+	LARGE_INTEGER pos{};
+	pos.QuadPart = static_cast<LONGLONG>(size);
+	if (!SetFilePointerEx(static_cast<HANDLE>(file_), pos, nullptr, FILE_BEGIN) || !SetEndOfFile(static_cast<HANDLE>(file_)))
+	{
+		// Keep the old length mapped
+		Map();
+		return false;
+	}
+
+	size_ = size;
+	return Map();
+}
+
+bool MappedFile::Flush()
+{
+	if (!data_) return true;
+	return FlushViewOfFile(data_, 0) != 0;
+}
+
+bool MappedFile::Map()
+{
+	if (size_ == 0) return false;
+
+	const DWORD hi = static_cast<DWORD>(size_ >> 32);
+	const DWORD lo = static_cast<DWORD>(size_ & 0xFFFFFFFFu);
+
+	HANDLE mapping = CreateFileMappingW(static_cast<HANDLE>(file_), nullptr, PAGE_READWRITE, hi, lo, nullptr);
+	if (!mapping) return false;
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		return false;
+	}
+
+	mapping_ = mapping;
+	data_ = static_cast<uint8_t*>(view);
+	return true;
+}
+
+void MappedFile::Unmap()
+{
+	if (data_)
+	{
+		UnmapViewOfFile(data_);
+		data_ = nullptr;
+	}
+	if (mapping_)
+	{
+		CloseHandle(static_cast<HANDLE>(mapping_));
+		mapping_ = nullptr;
+	}
+}
+
+#else
+
+bool MappedFile::Open(const std::filesystem::path& path, uint64_t minSize)
+{
+	Close();
+
+	fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd_ < 0) return false;
+
+	struct stat st{};
+	if (::fstat(fd_, &st) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	size_ = static_cast<uint64_t>(st.st_size);
+	if (!(size_ < minSize ? Resize(minSize) : Map()))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close()
+{
+	Flush();
+	Unmap();
+
+	if (fd_ >= 0)
+	{
+		::close(fd_);
+		fd_ = -1;
+	}
+	size_ = 0;
+}
+
+bool MappedFile::Resize(uint64_t size)
+{
+	if (fd_ < 0) return false;
+
+	Unmap();
+
+	if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+	{
+		// Keep the old length mapped
+		Map();
+		return false;
+	}
+
+	size_ = size;
+	return Map();
+}
+
+bool MappedFile::Flush()
+{
+	if (!data_) return true;
+	return ::msync(data_, static_cast<size_t>(size_), MS_SYNC) == 0;
+}
+
+bool MappedFile::Map()
+{
+	if (size_ == 0) return false;
+
+	void* view = ::mmap(nullptr, static_cast<size_t>(size_), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+	if (view == MAP_FAILED) return false;
+
+	data_ = static_cast<uint8_t*>(view);
+	return true;
+}
+
+void MappedFile::Unmap()
+{
+	if (data_)
+	{
+		::munmap(data_, static_cast<size_t>(size_));
+		data_ = nullptr;
+	}
+}
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+
+// ------------------------------------------------------------
+// Read/write memory mapping of a whole file (Win32 file mapping, POSIX mmap).
+//
+// The mapping always covers the full file; Resize() changes the file length and
+// remaps, so pointers from Data() are invalidated by Resize() and Close().
+// Callers serialize access themselves.
+// ------------------------------------------------------------
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Opens (or creates) the file and maps it; grows it to at least minSize bytes
+    bool Open(const std::filesystem::path& path, uint64_t minSize);
+
+    // Flushes and unmaps
+    void Close();
+
+    // New file length (grow or shrink), then remap
+    bool Resize(uint64_t size);
+
+    // Writes dirty pages back to the file
+    bool Flush();
+
+    bool IsOpen() const { return data_ != nullptr; }
+    uint8_t* Data() { return data_; }
+    const uint8_t* Data() const { return data_; }
+    uint64_t Size() const { return size_; }
+
+private:
+    bool Map();
+    void Unmap();
+
+#ifdef _WIN32
+    void* file_ = nullptr;      // HANDLE
+    void* mapping_ = nullptr;   // HANDLE
+#else
+    int fd_ = -1;
+#endif
+    uint8_t* data_ = nullptr;
+    uint64_t size_ = 0;
+};
@@ -1,22 +1,30 @@
 #include "pch.h"
 #include "media.h"
+#include "triple_buffer.h"
+#include "async_slot.h"
+#include "media_scheduler.h"
+#include "media_recording.h"
+#include "album_cache.h"
+#include "image_kernels.h"
+#include "profiler.h"
 
 #include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.Graphics.Imaging.h>
 #include <winrt/Windows.Media.Control.h>
 #include <winrt/Windows.Storage.Streams.h>
 
 #include <filesystem>
-#include <fstream>
-#include <string_view>
 #include <vector>
 #include <mutex>
 #include <thread>
 #include <atomic>
-#include <condition_variable>
 #include <chrono>
 #include <algorithm>
+#include <optional>
 
 using namespace winrt;
+using namespace Windows::Foundation;
+using namespace Windows::Graphics::Imaging;
 using namespace Windows::Media::Control;
 using namespace Windows::Storage::Streams;
 
@@ -24,60 +32,22 @@ namespace
 {
 	constexpr uint32_t kMaxAlbumArtBytes = 8u * 1024u * 1024u; // 8MB hard cap
 
-	constexpr uint64_t Fnv1a64(std::string_view s) noexcept
-	{
-		uint64_t h = 14695981039346656037ull;
-		for (unsigned char c : s)
-		{
-			h ^= static_cast<uint64_t>(c);
-			h *= 1099511628211ull;
-		}
-		return h;
-	}
+	constexpr int kMinAlbumArtPx = 32;
+	constexpr int kMaxAlbumArtPx = 1024;
+	constexpr int kDefaultAlbumArtPx = 128;
 
-	std::string HashTrackStable(const std::string& t, const std::string& a, const std::string& al)
-	{
-		const std::string combined = t + '\n' + a + '\n' + al;
-		const uint64_t h = Fnv1a64(combined);
-		char buf[17]{};
-		snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
-		return std::string(buf);
-	}
+	// Backdrop: the cover at 64 px under three box passes of radius 6 (about a Gaussian
+	// with sigma 6.5 px, a tenth of the edge); stretched over the window it stays smooth
+	constexpr int kBackdropPx = 64;
+	constexpr int kBackdropBlurRadius = 6;
+	constexpr int kBackdropBlurPasses = 3;
 
-	int64_t HnsToSeconds(const Windows::Foundation::TimeSpan& ts) noexcept
+	void BuildBackdrop(const uint8_t* rgba, int width, int height, AlbumArtImage& image)
 	{
-		return ts.count() / 10'000'000;
-	}
-
-	bool WriteFileBytes(const std::filesystem::path& path, const std::vector<uint8_t>& bytes) noexcept
-	{
-		try
-		{
-			std::ofstream out(path, std::ios::binary);
-			if (!out.is_open()) return false;
-			out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
-			out.flush();
-			return out.good();
-		}
-		catch (...)
-		{
-			return false;
-		}
-	}
-
-	std::vector<uint8_t> ReadAllBytesFromIRandomAccessStream(
-		const IRandomAccessStream& stream,
-		uint32_t size)
-	{
-		DataReader reader(stream);
-		reader.InputStreamOptions(InputStreamOptions::None);
-
-		const uint32_t loaded = reader.LoadAsync(size).get();
-		if (loaded != size) return {};
-
-		std::vector<uint8_t> bytes(size);
-		reader.ReadBytes(bytes);
-		return bytes;
+		image.backdropSize = kBackdropPx;
+		image.backdrop.resize(static_cast<size_t>(kBackdropPx) * kBackdropPx * 4);
+		ImageKernels::ResampleToPremultiplied(rgba, width, height, image.backdrop.data(), kBackdropPx, kBackdropPx);
+		ImageKernels::BoxBlurRgba8(image.backdrop.data(), kBackdropPx, kBackdropPx, kBackdropBlurRadius, kBackdropBlurPasses);
 	}
 }
 
@@ -89,7 +59,6 @@ public:
 		try
 		{
 			cacheDir_ = std::filesystem::path(dataDir) / "RocketRhythm" / "album_cache";
-			std::filesystem::create_directories(cacheDir_);
 		}
 		catch (...)
 		{
@@ -101,25 +70,64 @@ public:
 
 	~MediaControllerGSMTC() override
 	{
-		stop_.store(true, std::memory_order_relaxed);
-		{
-			std::lock_guard lk(cvMutex_);
-			dirty_.store(true, std::memory_order_relaxed);
-		}
-		cv_.notify_all();
+		scheduler_.Stop();
 		if (worker_.joinable()) worker_.join();
 	}
 
-	// Game thread: cheap copy only
-	void Update() override
+	// Game thread: lock-free swap, no copy
+	bool Update() override
 	{
-		std::lock_guard lk(stateMutex_);
-		state_ = cachedState_;
+		return published_.Acquire();
 	}
 
 	const MediaState& GetState() const override
 	{
-		return state_;
+		return published_.ReadBuffer();
+	}
+
+	MediaStats GetStats() const override
+	{
+		MediaStats stats;
+		stats.fullRefreshes = fullRefreshes_.load(std::memory_order_relaxed);
+		stats.timelineRefreshes = timelineRefreshes_.load(std::memory_order_relaxed);
+		stats.events = scheduler_.EventCount();
+		stats.batches = scheduler_.BatchCount();
+		stats.completions = scheduler_.CompletionCount();
+
+		const AlbumCacheStats art = cache_.GetStats();
+		stats.artBlobs = art.blobs;
+		stats.artKeys = art.keys;
+		stats.artAlbumHits = art.albumHits;
+		stats.artDedupeHits = art.dedupeHits;
+		stats.artBytesSaved = art.bytesSaved;
+		stats.artPackBytes = art.packBytes;
+		stats.artDeadBytes = art.deadBytes;
+		return stats;
+	}
+
+	void SetRefreshWindows(std::chrono::milliseconds settle, std::chrono::milliseconds maxLatency) override
+	{
+		scheduler_.SetWindows(settle, maxLatency);
+	}
+
+	void SetAlbumCacheBudget(uint64_t maxBytes, size_t maxEntries) override
+	{
+		cache_.SetBudget(AlbumCacheBudget{ maxBytes, maxEntries });
+	}
+
+	void SetAlbumArtSize(int px) override
+	{
+		artTargetPx_.store(std::clamp(px, kMinAlbumArtPx, kMaxAlbumArtPx), std::memory_order_relaxed);
+	}
+
+	bool StartRecording(const std::string& path) override
+	{
+		return recorder_.Start(path);
+	}
+
+	void StopRecording() override
+	{
+		recorder_.Stop();
 	}
 
 private:
@@ -128,6 +136,13 @@ private:
 	// -------------------------
 	void WorkerLoop()
 	{
+		Tracer::SetThreadName("media worker");
+		batchAt_ = RefreshScheduler::Clock::now();
+
+		// Index load (or the one-time directory scan) stays off the game thread
+		if (!cacheDir_.empty() && !cache_.Open(cacheDir_))
+			cacheDir_.clear();
+
 		try
 		{
 			init_apartment(apartment_type::multi_threaded);
@@ -137,49 +152,26 @@ private:
 			// If apartment init fails, we'll still try; refresh may fail gracefully.
 		}
 
+		// The manager arrives as an Initial completion; the worker stays free meanwhile
 		try
 		{
-			manager_ = GlobalSystemMediaTransportControlsSessionManager::RequestAsync().get();
+			const uint64_t token = managerRequest_.Reset();
+			managerRequest_.Attach(token, RequestManagerAsync(token));
 		}
 		catch (...)
-		{
-			manager_ = nullptr;
-		}
-
-		if (manager_)
-		{
-			// Subscribe to current session changes
-			mgrSessionChangedRevoker_ = manager_.CurrentSessionChanged(auto_revoke, [this](const auto&, const auto&)
-			{
-				QueueRefresh(RefreshReason::SessionChanged);
-			});
-
-			// Attach initial session
-			AttachSession(manager_.GetCurrentSession());
-			QueueRefresh(RefreshReason::Initial);
-		}
-		else
 		{
 			Publish(MediaState{});
 		}
 
-		while (!stop_.load(std::memory_order_relaxed))
+		while (true)
 		{
-			// Wait until something changes
-			{
-				std::unique_lock lk(cvMutex_);
-				cv_.wait(lk, [this]
-				{
-					return stop_.load(std::memory_order_relaxed) || dirty_.load(std::memory_order_relaxed);
-				});
+			// Wait until something changes and the event burst has settled
+			const uint32_t reasons = scheduler_.WaitBatch();
+			if (scheduler_.Stopped()) break;
+			batchAt_ = RefreshScheduler::Clock::now();
 
-				dirty_.store(false, std::memory_order_relaxed);
-			}
-
-			if (stop_.load(std::memory_order_relaxed)) break;
-
-			// Coalesce reasons (not strictly needed, but good hygiene)
-			const uint32_t reasons = pendingReasons_.exchange(0, std::memory_order_relaxed);
+			if (reasons & static_cast<uint32_t>(RefreshReason::Initial))
+				ApplyManagerResult();
 
 			// If session changed, reattach before reading properties
 			if (reasons & static_cast<uint32_t>(RefreshReason::SessionChanged))
@@ -190,32 +182,88 @@ private:
 				}
 			}
 
-			RefreshOnce();
+			// Completions only patch the published state with what was fetched
+			if (reasons & static_cast<uint32_t>(RefreshReason::MetadataReady))
+				ApplyMetadataResult();
+			if (reasons & static_cast<uint32_t>(RefreshReason::AlbumArtReady))
+				ApplyAlbumArtResult();
+
+			const uint32_t refreshReasons = reasons & ~kCompletionReasons;
+			if (refreshReasons == 0) continue;
+
+			// Position/playback-only events don't touch metadata; skip the properties round
+			// trip. While a metadata fetch is in flight they keep publishing as well.
+			if ((refreshReasons & ~kTimelineOnlyReasons) == 0 && (haveMetadata_ || metadataPending_))
+				RefreshTimeline();
+			else
+				RefreshOnce();
 		}
 
-		// Clean detach on exit
+		// Clean detach on exit. Fetches superseded earlier were cancelled but may still be
+		// unwinding on the thread pool; wait for every one of them so none can outlive us
+		if (auto request = managerRequest_.Release()) request->Cancel();
+		if (auto fetch = metadataFetch_.Release()) fetch->Cancel();
+		if (auto fetch = artFetch_.Release()) fetch->Cancel();
+		managerRequest_.WaitIdle();
+		metadataFetch_.WaitIdle();
+		artFetch_.WaitIdle();
+
 		DetachSession();
 		manager_ = nullptr;
 	}
 
-	enum class RefreshReason : uint32_t
+	// Any thread (WinRT event callbacks)
+	void QueueRefresh(RefreshReason r)
 	{
-		None = 0,
-		Initial = 1u << 0,
-		SessionChanged = 1u << 1,
-		MediaChanged = 1u << 2,
-		PlaybackChanged = 1u << 3,
-		TimelineChanged = 1u << 4,
-	};
+		if (Tracer::IsActive()) Tracer::Instant(RefreshReasonName(r), "event", static_cast<uint32_t>(r));
+		recorder_.RecordEvent(static_cast<uint32_t>(r));
+		scheduler_.Post(static_cast<uint32_t>(r));
+	}
 
-	void QueueRefresh(RefreshReason r)
+	// Results of the worker's own async work: not events, and released without debouncing
+	void CompleteRefresh(RefreshReason r)
+	{
+		if (Tracer::IsActive()) Tracer::Instant(RefreshReasonName(r), "completion", static_cast<uint32_t>(r));
+		recorder_.RecordCompletion(static_cast<uint32_t>(r));
+		scheduler_.Complete(static_cast<uint32_t>(r));
+	}
+
+	IAsyncAction RequestManagerAsync(uint64_t token)
 	{
-		pendingReasons_.fetch_or(static_cast<uint32_t>(r), std::memory_order_relaxed);
+		const auto inFlight = managerRequest_.Track();
+
+		GlobalSystemMediaTransportControlsSessionManager manager{ nullptr };
+		try
+		{
+			manager = co_await GlobalSystemMediaTransportControlsSessionManager::RequestAsync();
+		}
+		catch (...)
 		{
-			std::lock_guard lk(cvMutex_);
-			dirty_.store(true, std::memory_order_relaxed);
+			manager = nullptr;
 		}
-		cv_.notify_one();
+
+		// Null is a result too: the worker publishes the empty state then
+		if (!managerResult_.Offer(managerRequest_, token, std::move(manager))) co_return;
+
+		CompleteRefresh(RefreshReason::Initial);
+	}
+
+	void ApplyManagerResult()
+	{
+		std::optional<GlobalSystemMediaTransportControlsSessionManager> result = managerResult_.Take(managerRequest_);
+		if (!result) return;
+
+		manager_ = std::move(*result);
+		if (!manager_) return; // the Initial refresh publishes the empty state
+
+		// Subscribe to current session changes
+		mgrSessionChangedRevoker_ = manager_.CurrentSessionChanged(auto_revoke, [this](const auto&, const auto&)
+		{
+			QueueRefresh(RefreshReason::SessionChanged);
+		});
+
+		// Attach initial session
+		AttachSession(manager_.GetCurrentSession());
 	}
 
 	void AttachSession(const GlobalSystemMediaTransportControlsSession& newSession)
@@ -223,6 +271,15 @@ private:
 		DetachSession();
 		session_ = newSession;
 
+		// Anything still fetching belongs to the old session
+		metadataFetch_.Reset();
+		metadataPending_ = false;
+		artFetch_.Reset();
+		lastTrackId_ = kNoTrack;
+		lastAlbumArtKey_ = 0;
+		lastAlbumArtImage_.reset();
+		lastAlbumArtPending_ = false;
+
 		if (!session_) return;
 
 		// Session event subscriptions
@@ -244,6 +301,7 @@ private:
 
 	void DetachSession()
 	{
+		haveMetadata_ = false;
 		// Revokers auto-unsubscribe on destruction/reset; resetting session_ also helps.
 		mediaChangedRevoker_ = {};
 		playbackChangedRevoker_ = {};
@@ -251,53 +309,155 @@ private:
 		session_ = nullptr;
 	}
 
+	static void ApplyPlaybackAndTimeline(
+		const GlobalSystemMediaTransportControlsSessionPlaybackInfo& playback,
+		const GlobalSystemMediaTransportControlsSessionTimelineProperties& timeline,
+		MediaState& out)
+	{
+		out.isPlaying = playback.PlaybackStatus() == GlobalSystemMediaTransportControlsSessionPlaybackStatus::Playing;
+
+		const auto rate = playback.PlaybackRate();
+		out.playbackRate = rate ? std::clamp(rate.Value(), 0.0, 16.0) : 1.0;
+
+		out.durationTicks = std::max<int64_t>(0, timeline.EndTime().count());
+		out.positionTicks = std::clamp<int64_t>(timeline.Position().count(), 0, out.durationTicks);
+
+		// Some players never fill LastUpdatedTime (or report it in the future); treat "now" as the anchor then
+		const auto now = std::chrono::system_clock::now();
+		auto updatedAt = std::chrono::time_point_cast<std::chrono::system_clock::duration>(clock::to_sys(timeline.LastUpdatedTime()));
+		if (updatedAt.time_since_epoch().count() <= 0 || updatedAt > now) updatedAt = now;
+		out.positionUpdatedAt = updatedAt;
+
+		out.durationSec = static_cast<int>(out.durationTicks / kTicksPerSecond);
+		out.positionSec = static_cast<int>(std::min(out.positionTicks / kTicksPerSecond, static_cast<int64_t>(out.durationSec)));
+		out.progress01 = out.durationTicks > 0 ? std::clamp(static_cast<float>(static_cast<double>(out.positionTicks) / static_cast<double>(out.durationTicks)), 0.0f, 1.0f) : 0.0f;
+	}
+
+	// Cheap path: patch playback/timeline into the last published state
+	void RefreshTimeline()
+	{
+		RR_PROFILE_SCOPE(ProfileStage::RefreshTimeline);
+
+		if (!manager_ || !session_)
+		{
+			RefreshOnce();
+			return;
+		}
+
+		try
+		{
+			MediaState local = lastPublished_;
+			ApplyPlaybackAndTimeline(session_.GetPlaybackInfo(), session_.GetTimelineProperties(), local);
+
+			timelineRefreshes_.fetch_add(1, std::memory_order_relaxed);
+			Publish(std::move(local));
+		}
+		catch (...)
+		{
+			RefreshOnce();
+		}
+	}
+
+	// Starts a metadata fetch (superseding one in flight); the worker moves on to the next
+	// batch and publishes the result once it comes back as MetadataReady
 	void RefreshOnce()
 	{
-		MediaState local{};
+		RR_PROFILE_SCOPE(ProfileStage::RefreshOnce);
 
+		haveMetadata_ = false;
+		metadataPending_ = false;
+		fullRefreshes_.fetch_add(1, std::memory_order_relaxed);
+
+		const uint64_t token = metadataFetch_.Reset();
 		if (!manager_ || !session_)
 		{
-			Publish(local);
+			Publish(MediaState{});
 			return;
 		}
 
 		try
 		{
-			const auto playback = session_.GetPlaybackInfo();
-			const auto timeline = session_.GetTimelineProperties();
-			const auto media = session_.TryGetMediaPropertiesAsync().get();
+			metadataFetch_.Attach(token, FetchMetadataAsync(session_, token));
+			metadataPending_ = true;
+		}
+		catch (...)
+		{
+			Publish(MediaState{});
+		}
+	}
+
+	IAsyncAction FetchMetadataAsync(GlobalSystemMediaTransportControlsSession session, uint64_t token)
+	{
+		// First local: released last, after the body's final use of `this`
+		const auto inFlight = metadataFetch_.Track();
+
+		// Spans the properties round trip, including the time spent suspended
+		RR_PROFILE_SCOPE(ProfileStage::FetchMetadata);
+
+		auto cancel = co_await get_cancellation_token();
+		cancel.enable_propagation();
+
+		MetadataResult result;
+		try
+		{
+			const auto media = co_await session.TryGetMediaPropertiesAsync();
+			result.title = to_string(media.Title());
+			result.artist = to_string(media.Artist());
+			result.album = to_string(media.AlbumTitle());
+			result.thumbnail = media.Thumbnail();
+			result.ok = true;
+		}
+		catch (...)
+		{
+			// Cancelled, or the player went away: an empty state unless superseded
+		}
 
-			local.isPlaying = playback.PlaybackStatus() == GlobalSystemMediaTransportControlsSessionPlaybackStatus::Playing;
+		// Dropped when stale: the session changed or a newer fetch started meanwhile
+		if (cancel() || !metadataResult_.Offer(metadataFetch_, token, std::move(result))) co_return;
 
-			local.title = to_string(media.Title());
-			local.artist = to_string(media.Artist());
-			local.album = to_string(media.AlbumTitle());
+		CompleteRefresh(RefreshReason::MetadataReady);
+	}
 
-			const int64_t dur = std::max<int64_t>(0, HnsToSeconds(timeline.EndTime()));
-			const int64_t pos = std::clamp<int64_t>(HnsToSeconds(timeline.Position()), 0, dur);
+	// Playback and timeline are read now, on the worker, so they are never older than
+	// the metadata they are published with
+	void ApplyMetadataResult()
+	{
+		std::optional<MetadataResult> result = metadataResult_.Take(metadataFetch_);
+		if (!result) return;
 
-			local.durationSec = static_cast<int>(dur);
-			local.positionSec = static_cast<int>(pos);
-			local.progress01 = local.durationSec > 0 ? std::clamp(local.positionSec / static_cast<float>(local.durationSec), 0.0f, 1.0f) : 0.0f;
+		metadataPending_ = false;
+		if (!result->ok || !session_)
+		{
+			Publish(MediaState{});
+			return;
+		}
 
-			// Album art: only on track change (or first load), and only if thumbnail exists
-			const std::string songKey = local.title + "|" + local.artist + "|" + local.album;
-			if (songKey != lastSongKey_)
-			{
-				lastSongKey_ = songKey;
-				local.hasAlbumArt = false;
-				local.albumArtPath.clear();
+		MediaState local{};
+		try
+		{
+			local.title = std::move(result->title);
+			local.artist = std::move(result->artist);
+			local.album = std::move(result->album);
 
-				TryCacheAlbumArt(media.Thumbnail(), local);
-				lastAlbumArtPath_ = local.albumArtPath;
-			}
-			else
+			ApplyPlaybackAndTimeline(session_.GetPlaybackInfo(), session_.GetTimelineProperties(), local);
+
+			local.trackId = ComputeTrackId(local.title, local.artist, local.album);
+
+			// Album art: only on track change (or first load), and only if thumbnail exists
+			if (local.trackId != lastTrackId_)
 			{
-				local.albumArtPath = lastAlbumArtPath_;
-				local.hasAlbumArt = !lastAlbumArtPath_.empty();
+				lastTrackId_ = local.trackId;
+				lastAlbumArtPending_ = StartAlbumArtFetch(result->thumbnail, local);
+				lastAlbumArtKey_ = local.albumArtKey;
 			}
 
-			Publish(local);
+			local.hasAlbumArt = lastAlbumArtKey_ != 0;
+			local.albumArtKey = lastAlbumArtKey_;
+			local.albumArtImage = lastAlbumArtImage_;
+			local.albumArtPending = lastAlbumArtPending_;
+
+			haveMetadata_ = true;
+			Publish(std::move(local));
 		}
 		catch (...)
 		{
@@ -305,89 +465,282 @@ private:
 		}
 	}
 
-	void TryCacheAlbumArt(const IRandomAccessStreamReference& thumbnail, MediaState& outState)
+	// Cache hit (this track, or another track of the same album): fills the art key
+	// right away and never opens the thumbnail stream. If the previous track
+	// shared that image its decoded pixels are reused as-is. Otherwise the load/decode
+	// runs as a cancellable coroutine on the thread pool and publishes the pixels later
+	// (AlbumArtReady), so neither the worker nor the render thread touches image data.
+	// Returns true when a load is in flight.
+	bool StartAlbumArtFetch(const IRandomAccessStreamReference& thumbnail, MediaState& outState)
 	{
-		if (!thumbnail || cacheDir_.empty())
-		{
-			outState.hasAlbumArt = false;
-			outState.albumArtPath.clear();
-			return;
-		}
+		RR_PROFILE_SCOPE(ProfileStage::CacheAlbumArt);
 
-		const auto hash = HashTrackStable(outState.title, outState.artist, outState.album);
-		const auto path = cacheDir_ / (hash + ".png");
-		outState.albumArtPath = path.string();
+		const uint64_t token = artFetch_.Reset();
+		auto previous = std::move(lastAlbumArtImage_);
+		lastAlbumArtImage_.reset();
 
-		try
+		if (!thumbnail || cacheDir_.empty()) return false;
+
+		// Index lookup only; the file itself is read on the thread pool
+		const uint64_t albumKey = ComputeAlbumKey(outState.artist, outState.album);
+		const std::optional<ArtHash> cached = cache_.Resolve(outState.trackId, albumKey);
+		if (cached)
 		{
-			if (std::filesystem::exists(path))
+			outState.albumArtKey = *cached;
+
+			if (previous && previous->artKey == *cached)
 			{
-				outState.hasAlbumArt = true;
-				return;
+				lastAlbumArtImage_ = std::move(previous);
+				return false;
 			}
 		}
+
+		try
+		{
+			artFetch_.Attach(token, LoadAlbumArtAsync(thumbnail, cached, outState.trackId, albumKey, token));
+			return true;
+		}
 		catch (...)
 		{
-			outState.hasAlbumArt = false;
-			outState.albumArtPath.clear();
-			return;
+			return false;
 		}
+	}
+
+	// Cached pixels at the display size are used as they are (no decode). Otherwise reads the
+	// cached blob (or downloads into the cache when it is not indexed or unreadable), decodes
+	// once at the display size, extracts the palette, blurs the backdrop and stores all of it
+	// for next time. Downloads are stored by content hash, so art already in the pack under
+	// another key is not written again.
+	IAsyncAction LoadAlbumArtAsync(IRandomAccessStreamReference thumbnail, std::optional<ArtHash> cached, TrackId trackId, uint64_t albumKey, uint64_t token)
+	{
+		// First local: released last, after the body's final use of `this`
+		const auto inFlight = artFetch_.Track();
+
+		// Spans the whole load, including the time spent suspended
+		RR_PROFILE_SCOPE(ProfileStage::FetchAlbumArt);
+
+		auto cancel = co_await get_cancellation_token();
+		cancel.enable_propagation();
+
+		// A new track or session (or shutdown) cancels this load; checked before every
+		// expensive stage, so a superseded load stops there and writes nothing to the cache
+		const auto superseded = [&] { return cancel() || !artFetch_.IsCurrent(token); };
+
+		// Everything below runs on the thread pool, never on the worker
+		co_await resume_background();
+		if (superseded()) co_return;
+
+		bool ok = false;
+		ArtHash hash = cached.value_or(kNoTrack);
+		const int targetPx = artTargetPx_.load(std::memory_order_relaxed);
+		std::vector<uint8_t> bytes;
+		std::shared_ptr<AlbumArtImage> image;
 
 		try
 		{
-			auto stream = thumbnail.OpenReadAsync().get();
-			const uint64_t size64 = stream.Size();
-			if (size64 == 0 || size64 > kMaxAlbumArtBytes)
+			if (cached)
 			{
-				outState.hasAlbumArt = false;
-				outState.albumArtPath.clear();
-				return;
+				auto pixels = std::make_shared<AlbumArtImage>();
+				if (cache_.ReadPixels(hash, targetPx, *pixels))
+				{
+					// Pixels stored before palettes (or backdrops) were: derive them from the small
+					// cached copy (premultiplied, which only matters for translucent art)
+					if (!pixels->palette.extracted)
+					{
+						if (superseded()) co_return;
+						RR_PROFILE_SCOPE(ProfileStage::ExtractPalette);
+						pixels->palette = ExtractPalette(pixels->rgba.data(), pixels->width, pixels->height);
+					}
+					if (pixels->backdrop.empty())
+					{
+						if (superseded()) co_return;
+						RR_PROFILE_SCOPE(ProfileStage::BlurBackdrop);
+						BuildBackdrop(pixels->rgba.data(), pixels->width, pixels->height, *pixels);
+					}
+
+					image = std::move(pixels);
+					ok = true;
+				}
+				else
+				{
+					// A blob that cannot be read is dropped from the cache; download it again
+					ok = cache_.Read(hash, bytes) && bytes.size() <= kMaxAlbumArtBytes;
+				}
 			}
 
-			const uint32_t size = static_cast<uint32_t>(size64);
-			const auto bytes = ReadAllBytesFromIRandomAccessStream(stream, size);
-			if (bytes.empty())
+			if (!ok)
 			{
-				outState.hasAlbumArt = false;
-				outState.albumArtPath.clear();
-				return;
+				if (superseded()) co_return;
+
+				auto stream = co_await thumbnail.OpenReadAsync();
+				const uint64_t size64 = stream.Size();
+				if (size64 > 0 && size64 <= kMaxAlbumArtBytes)
+				{
+					const uint32_t size = static_cast<uint32_t>(size64);
+
+					DataReader reader(stream);
+					reader.InputStreamOptions(InputStreamOptions::None);
+
+					const uint32_t loaded = co_await reader.LoadAsync(size);
+					if (loaded == size && !superseded())
+					{
+						bytes.resize(size);
+						reader.ReadBytes(bytes);
+
+						// One append to the pack (none if the image is already stored)
+						hash = cache_.Store(trackId, albumKey, bytes);
+						ok = true;
+					}
+				}
 			}
 
-			if (!WriteFileBytes(path, bytes))
+			if (ok && !image && !superseded())
 			{
-				outState.hasAlbumArt = false;
-				outState.albumArtPath.clear();
-				return;
+				RR_PROFILE_SCOPE(ProfileStage::DecodeAlbumArt);
+
+				InMemoryRandomAccessStream memory;
+				DataWriter writer(memory);
+				writer.WriteBytes(bytes);
+				co_await writer.StoreAsync();
+				writer.DetachStream();
+				memory.Seek(0);
+
+				const auto decoder = co_await BitmapDecoder::CreateAsync(memory);
+
+				// Square display: scale to the target edge, never upscale. The decoder hands over
+				// straight alpha near full size (WIC's Fant only pre-shrinks very large art, which
+				// Lanczos would otherwise spend most of its taps on); the resample kernel filters
+				// in linear light and premultiplies, so transparent edges do not bleed dark fringes.
+				const uint32_t target = static_cast<uint32_t>(targetPx);
+				const uint32_t srcWidth = decoder.OrientedPixelWidth();
+				const uint32_t srcHeight = decoder.OrientedPixelHeight();
+
+				BitmapTransform transform;
+				transform.ScaledWidth(srcWidth > target * 4 ? target * 2 : srcWidth);
+				transform.ScaledHeight(srcHeight > target * 4 ? target * 2 : srcHeight);
+				transform.InterpolationMode(BitmapInterpolationMode::Fant);
+
+				const auto provider = co_await decoder.GetPixelDataAsync(
+					BitmapPixelFormat::Rgba8, BitmapAlphaMode::Straight, transform,
+					ExifOrientationMode::RespectExifOrientation, ColorManagementMode::DoNotColorManage);
+				const auto pixels = provider.DetachPixelData();
+				if (superseded()) co_return;
+
+				const int decodedWidth = static_cast<int>(transform.ScaledWidth());
+				const int decodedHeight = static_cast<int>(transform.ScaledHeight());
+
+				if (pixels.size() == static_cast<size_t>(decodedWidth) * decodedHeight * 4)
+				{
+					image = std::make_shared<AlbumArtImage>();
+					image->width = std::min(decodedWidth, targetPx);
+					image->height = std::min(decodedHeight, targetPx);
+					image->premultiplied = true;
+
+					{
+						RR_PROFILE_SCOPE(ProfileStage::ExtractPalette);
+						image->palette = ExtractPalette(pixels.data(), decodedWidth, decodedHeight);
+					}
+					if (superseded()) co_return;
+					{
+						RR_PROFILE_SCOPE(ProfileStage::BlurBackdrop);
+						BuildBackdrop(pixels.data(), decodedWidth, decodedHeight, *image);
+					}
+
+					if (superseded()) co_return;
+					if (image->width == decodedWidth && image->height == decodedHeight)
+					{
+						image->rgba.assign(pixels.begin(), pixels.end());
+						ImageKernels::PremultiplyRgba8(image->rgba.data(), image->rgba.size() / 4);
+					}
+					else
+					{
+						RR_PROFILE_SCOPE(ProfileStage::ResampleAlbumArt);
+						image->rgba.resize(static_cast<size_t>(image->width) * image->height * 4);
+						ImageKernels::ResampleToPremultiplied(pixels.data(), decodedWidth, decodedHeight, image->rgba.data(), image->width, image->height);
+					}
+
+					image->opaque = true;
+					for (size_t i = 3; i < image->rgba.size(); i += 4)
+					{
+						if (image->rgba[i] != 255)
+						{
+							image->opaque = false;
+							break;
+						}
+					}
+
+					// Next load of this art at this size is a copy out of the pack
+					if (superseded()) co_return;
+					cache_.StorePixels(hash, targetPx, *image);
+				}
 			}
 
-			outState.hasAlbumArt = true;
+			if (image)
+			{
+				image->trackId = trackId;
+				image->artKey = hash;
+			}
 		}
 		catch (...)
 		{
-			outState.hasAlbumArt = false;
-			outState.albumArtPath.clear();
+			// Undecodable art still keeps its key; the overlay just shows the placeholder
+			image.reset();
 		}
+
+		// Dropped when stale: the track or session moved on while we were loading
+		if (!artResult_.Offer(artFetch_, token, AlbumArtResult{ ok ? hash : 0, std::move(image) })) co_return;
+
+		CompleteRefresh(RefreshReason::AlbumArtReady);
+	}
+
+	void ApplyAlbumArtResult()
+	{
+		std::optional<AlbumArtResult> result = artResult_.Take(artFetch_);
+		if (!result) return;
+
+		lastAlbumArtKey_ = result->key;
+		lastAlbumArtImage_ = std::move(result->image);
+		lastAlbumArtPending_ = false;
+		if (!haveMetadata_) return; // next full refresh picks it up
+
+		MediaState local = lastPublished_;
+		local.hasAlbumArt = lastAlbumArtKey_ != 0;
+		local.albumArtKey = lastAlbumArtKey_;
+		local.albumArtImage = lastAlbumArtImage_;
+		local.albumArtPending = false;
+		Publish(std::move(local));
 	}
 
-	void Publish(const MediaState& s)
+	// Worker thread: unchanged states are dropped so the game thread sees no new version
+	void Publish(MediaState s)
 	{
-		std::lock_guard lk(stateMutex_);
-		cachedState_ = s;
+		recorder_.RecordState(s, batchAt_);
+
+		s.version = lastPublished_.version;
+		if (s == lastPublished_) return;
+
+		s.version = lastPublished_.version + 1;
+		lastPublished_ = std::move(s);
+
+		published_.WriteBuffer() = lastPublished_;
+		published_.Publish();
+
+		if (Tracer::IsActive()) Tracer::Instant("Publish", "media", lastPublished_.version);
 	}
 
 	// Game-thread visible state
-	mutable MediaState state_{};
-	std::mutex stateMutex_;
-	MediaState cachedState_{};
+	TripleBuffer<MediaState> published_;
+	MediaState lastPublished_{};   // worker-only
+	bool haveMetadata_ = false;    // worker-only: lastPublished_ holds metadata of the current session
+
+	std::atomic<uint64_t> fullRefreshes_{0};
+	std::atomic<uint64_t> timelineRefreshes_{0};
 
 	// Event-driven worker sync
 	std::thread worker_;
-	std::atomic<bool> stop_{false};
-
-	std::condition_variable cv_;
-	std::mutex cvMutex_;
-	std::atomic<bool> dirty_{false};
-	std::atomic<uint32_t> pendingReasons_{0};
+	RefreshScheduler scheduler_;
+	MediaRecorder recorder_;
+	RefreshScheduler::Clock::time_point batchAt_{};   // worker-only: release time of the batch being handled
 
 	// WinRT objects live on worker thread
 	GlobalSystemMediaTransportControlsSessionManager manager_{nullptr};
@@ -402,8 +755,40 @@ private:
 
 	// Album art cache
 	std::filesystem::path cacheDir_;
-	std::string lastSongKey_;
-	std::string lastAlbumArtPath_;
+	AlbumCache cache_;
+	TrackId lastTrackId_ = kNoTrack;
+	uint64_t lastAlbumArtKey_ = 0;
+	std::shared_ptr<const AlbumArtImage> lastAlbumArtImage_;
+	bool lastAlbumArtPending_ = false;
+	std::atomic<int> artTargetPx_{kDefaultAlbumArtPx};
+
+	// In-flight art download (worker-owned) and its completion, handed back to the worker
+	struct AlbumArtResult
+	{
+		uint64_t key = 0;   // content hash, 0: no art
+		std::shared_ptr<const AlbumArtImage> image;   // null: not decodable
+	};
+
+	AsyncSlot<IAsyncAction> artFetch_;
+	AsyncResult<AlbumArtResult> artResult_;
+
+	// In-flight metadata fetch (worker-owned) and its completion
+	struct MetadataResult
+	{
+		bool ok = false;   // false: the properties call failed
+		std::string title;
+		std::string artist;
+		std::string album;
+		IRandomAccessStreamReference thumbnail{ nullptr };
+	};
+
+	AsyncSlot<IAsyncAction> metadataFetch_;
+	AsyncResult<MetadataResult> metadataResult_;
+	bool metadataPending_ = false;   // worker-only: a fetch for the current session is in flight
+
+	// Startup: the session manager request
+	AsyncSlot<IAsyncAction> managerRequest_;
+	AsyncResult<GlobalSystemMediaTransportControlsSessionManager> managerResult_;
 };
 
 std::unique_ptr<MediaController> CreateMediaController(const std::string& dataFolder)
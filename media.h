@@ -1,6 +1,31 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <vector>
+
+#include "palette.h"
+#include "track_id.h"
+
+inline constexpr int64_t kTicksPerSecond = 10'000'000;
+
+// Decoded album art, already scaled to the display size (RGBA8, rows tightly packed)
+struct AlbumArtImage
+{
+    TrackId trackId = kNoTrack;
+    uint64_t artKey = 0;          // content hash of the encoded file; shared by every track of an album
+    int width = 0;
+    int height = 0;
+    bool premultiplied = false;   // color already multiplied by alpha
+    bool opaque = false;          // every alpha is 255 (both alpha modes are then identical)
+    ArtPalette palette;           // extracted from the full decode, before scaling
+    std::vector<uint8_t> rgba;
+
+    // Heavily blurred copy for the window backdrop (premultiplied, backdropSize squared); empty if none
+    int backdropSize = 0;
+    std::vector<uint8_t> backdrop;
+};
 
 struct MediaState
 {
@@ -8,19 +33,76 @@ struct MediaState
     std::string title;
     std::string artist;
     std::string album;
+    TrackId trackId = kNoTrack;   // hash of title/artist/album
     int durationSec = 0;
     int positionSec = 0;
     float progress01 = 0.0f;
-    std::string albumArtPath;
+
+    // Timeline as reported by the player (100ns ticks). positionTicks was valid at
+    // positionUpdatedAt; while playing, the live position advances at playbackRate.
+    int64_t durationTicks = 0;
+    int64_t positionTicks = 0;
+    std::chrono::system_clock::time_point positionUpdatedAt{};
+    double playbackRate = 1.0;
     bool hasAlbumArt = false;
+    uint64_t albumArtKey = 0;     // content hash of the art (0: unknown yet); equal keys share one texture
+
+    // Pixels for the current track once decoded off-thread. While albumArtPending is set
+    // the renderer keeps showing the previous art.
+    std::shared_ptr<const AlbumArtImage> albumArtImage;
+    bool albumArtPending = false;
+
+    // Bumped by the publisher whenever any other field changes
+    uint64_t version = 0;
+
+    bool operator==(const MediaState&) const = default;
+};
+
+// Worker counters (monotonic, read from any thread)
+struct MediaStats
+{
+    uint64_t fullRefreshes     = 0;   // metadata + timeline
+    uint64_t timelineRefreshes = 0;   // timeline/playback only (metadata fetch avoided)
+    uint64_t events            = 0;   // WinRT events received
+    uint64_t batches           = 0;   // worker wakeups after debouncing
+    uint64_t completions       = 0;   // album art results handed back by the worker itself
+
+    // Album art cache de-duplication
+    uint64_t artBlobs          = 0;   // stored images
+    uint64_t artKeys           = 0;   // tracks mapped onto them
+    uint64_t artAlbumHits      = 0;   // art found through the album key, download skipped
+    uint64_t artDedupeHits     = 0;   // downloaded bytes matched an image already stored
+    uint64_t artBytesSaved     = 0;
+    uint64_t artPackBytes      = 0;   // art.pack on disk
+    uint64_t artDeadBytes      = 0;   // awaiting compaction
 };
 
 class MediaController
 {
 public:
     virtual ~MediaController() = default;
-    virtual void Update() = 0;               // now cheap / non-blocking
+
+    // Game thread: picks up the latest published state without blocking.
+    // Returns true when GetState() changed (new version) since the previous call.
+    virtual bool Update() = 0;
     virtual const MediaState& GetState() const = 0;
+
+    bool ChangedSince(uint64_t version) const { return GetState().version != version; }
+
+    virtual MediaStats GetStats() const { return {}; }
+
+    // Debounce window for event bursts and the cap on how long a pending event may wait
+    virtual void SetRefreshWindows(std::chrono::milliseconds /*settle*/, std::chrono::milliseconds /*maxLatency*/) {}
+
+    // Size/entry budget of the on-disk album art cache (LRU eviction)
+    virtual void SetAlbumCacheBudget(uint64_t /*maxBytes*/, size_t /*maxEntries*/) {}
+
+    // Edge length (px) the album art is drawn at; decodes target this size
+    virtual void SetAlbumArtSize(int /*px*/) {}
+
+    // Records refresh events and states to a .rrmr file (see media_recording.h)
+    virtual bool StartRecording(const std::string& /*path*/) { return false; }
+    virtual void StopRecording() {}
 };
 
-std::unique_ptr<MediaController> CreateMediaController(const std::string& dataFolder);
\ No newline at end of file
+std::unique_ptr<MediaController> CreateMediaController(const std::string& dataFolder);
@@ -0,0 +1,193 @@
+#include "media_recording.h"
+
+#include <cstring>
+#include <string>
+
+namespace
+{
+	constexpr char kMagic[4] = { 'R', 'R', 'M', 'R' };
+
+	// Windows and the Linux benchmark hosts are both little-endian; values are written as-is
+	template <typename T>
+	void Put(std::ostream& out, T value)
+	{
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void PutString(std::ostream& out, const std::string& s)
+	{
+		Put<uint32_t>(out, static_cast<uint32_t>(s.size()));
+		out.write(s.data(), static_cast<std::streamsize>(s.size()));
+	}
+
+	template <typename T>
+	bool Get(std::istream& in, T& value)
+	{
+		return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	bool GetString(std::istream& in, std::string& s)
+	{
+		constexpr uint32_t kMaxString = 1u << 20;
+
+		uint32_t size = 0;
+		if (!Get(in, size) || size > kMaxString) return false;
+
+		s.resize(size);
+		return static_cast<bool>(in.read(s.data(), size));
+	}
+
+	void PutState(std::ostream& out, const MediaState& s)
+	{
+		Put<uint8_t>(out, s.isPlaying ? 1 : 0);
+		Put<uint8_t>(out, s.hasAlbumArt ? 1 : 0);
+		PutString(out, s.title);
+		PutString(out, s.artist);
+		PutString(out, s.album);
+		Put<uint64_t>(out, s.trackId);
+		Put<int32_t>(out, s.durationSec);
+		Put<int32_t>(out, s.positionSec);
+		Put<float>(out, s.progress01);
+		Put<int64_t>(out, s.durationTicks);
+		Put<int64_t>(out, s.positionTicks);
+		Put<int64_t>(out, std::chrono::duration_cast<std::chrono::nanoseconds>(s.positionUpdatedAt.time_since_epoch()).count());
+		Put<double>(out, s.playbackRate);
+	}
+
+	bool GetState(std::istream& in, MediaState& s)
+	{
+		uint8_t playing = 0, hasArt = 0;
+		int32_t duration = 0, position = 0;
+		int64_t updatedNs = 0;
+
+		const bool ok =
+			Get(in, playing) && Get(in, hasArt) &&
+			GetString(in, s.title) && GetString(in, s.artist) && GetString(in, s.album) &&
+			Get(in, s.trackId) && Get(in, duration) && Get(in, position) && Get(in, s.progress01) &&
+			Get(in, s.durationTicks) && Get(in, s.positionTicks) && Get(in, updatedNs) && Get(in, s.playbackRate);
+		if (!ok) return false;
+
+		s.isPlaying = playing != 0;
+		s.hasAlbumArt = hasArt != 0;
+		s.durationSec = duration;
+		s.positionSec = position;
+		s.positionUpdatedAt = std::chrono::system_clock::time_point(
+			std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(updatedNs)));
+		return true;
+	}
+}
+
+void WriteMediaRecordingHeader(std::ostream& out)
+{
+	out.write(kMagic, sizeof(kMagic));
+	Put<uint32_t>(out, kMediaRecordingVersion);
+}
+
+void WriteMediaRecord(std::ostream& out, const MediaRecord& record)
+{
+	Put<uint8_t>(out, static_cast<uint8_t>(record.kind));
+	Put<int64_t>(out, record.atNs);
+
+	if (record.kind == MediaRecord::Kind::Event || record.kind == MediaRecord::Kind::Completion)
+		Put<uint32_t>(out, record.reasons);
+	else
+		PutState(out, record.state);
+}
+
+bool ReadMediaRecording(std::istream& in, std::vector<MediaRecord>& out)
+{
+	char magic[4] = {};
+	uint32_t version = 0;
+	if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) return false;
+	if (!Get(in, version) || version != kMediaRecordingVersion) return false;
+
+	while (true)
+	{
+		MediaRecord r;
+		uint8_t kind = 0;
+		if (!Get(in, kind) || !Get(in, r.atNs)) break;
+
+		r.kind = static_cast<MediaRecord::Kind>(kind);
+		if (r.kind == MediaRecord::Kind::Event || r.kind == MediaRecord::Kind::Completion)
+		{
+			if (!Get(in, r.reasons)) break;
+		}
+		else if (r.kind == MediaRecord::Kind::State)
+		{
+			if (!GetState(in, r.state)) break;
+		}
+		else break; // corrupt
+
+		out.push_back(std::move(r));
+	}
+
+	return true;
+}
+
+// ------------------------------------------------------------
+// MediaRecorder
+// ------------------------------------------------------------
+
+bool MediaRecorder::Start(const std::filesystem::path& path)
+{
+	std::lock_guard lk(mutex_);
+	if (active_.load(std::memory_order_relaxed)) return false;
+
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+
+	file_.open(path, std::ios::binary | std::ios::trunc);
+	if (!file_) return false;
+
+	WriteMediaRecordingHeader(file_);
+	start_ = Clock::now();
+	active_.store(true, std::memory_order_relaxed);
+	return true;
+}
+
+void MediaRecorder::Stop()
+{
+	std::lock_guard lk(mutex_);
+	active_.store(false, std::memory_order_relaxed);
+	if (file_.is_open()) file_.close();
+}
+
+void MediaRecorder::RecordEvent(uint32_t reasons)
+{
+	if (!IsActive()) return;
+
+	MediaRecord r;
+	r.kind = MediaRecord::Kind::Event;
+	r.reasons = reasons;
+	Write(r, Clock::now());
+}
+
+void MediaRecorder::RecordCompletion(uint32_t reasons)
+{
+	if (!IsActive()) return;
+
+	MediaRecord r;
+	r.kind = MediaRecord::Kind::Completion;
+	r.reasons = reasons;
+	Write(r, Clock::now());
+}
+
+void MediaRecorder::RecordState(const MediaState& state, Clock::time_point at)
+{
+	if (!IsActive()) return;
+
+	MediaRecord r;
+	r.kind = MediaRecord::Kind::State;
+	r.state = state;
+	r.state.version = 0;
+	Write(r, at);
+}
+
+void MediaRecorder::Write(MediaRecord& record, Clock::time_point at)
+{
+	std::lock_guard lk(mutex_);
+	if (!active_.load(std::memory_order_relaxed)) return;
+
+	record.atNs = std::chrono::duration_cast<std::chrono::nanoseconds>(at - start_).count();
+	WriteMediaRecord(file_, record);
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "media.h"
+
+// ------------------------------------------------------------
+// Media pipeline recording (.rrmr)
+//
+// Little-endian binary stream:
+//   header  "RRMR" u32 version
+//   record  u8 kind, i64 atNs (steady clock, relative to the start of the recording)
+//     Event: u32 reasons                 (RefreshReason bits, as posted to the scheduler)
+//     Completion: u32 reasons            (the worker's own async work, e.g. album art ready)
+//     State: MediaState (without version) as read by a refresh, before de-duplication;
+//            atNs is the release time of the batch that produced it
+//
+// A truncated tail (crash while recording) is ignored by the reader.
+// ------------------------------------------------------------
+
+inline constexpr uint32_t kMediaRecordingVersion = 3;
+
+struct MediaRecord
+{
+    enum class Kind : uint8_t
+    {
+        Event = 1,
+        State = 2,
+        Completion = 3
+    };
+
+    Kind kind = Kind::Event;
+    int64_t atNs = 0;
+    uint32_t reasons = 0;   // Event, Completion
+    MediaState state{};     // State
+};
+
+void WriteMediaRecordingHeader(std::ostream& out);
+void WriteMediaRecord(std::ostream& out, const MediaRecord& record);
+
+// Returns false if the stream is not a recording of a supported version
+bool ReadMediaRecording(std::istream& in, std::vector<MediaRecord>& out);
+
+// Thread-safe recorder; a no-op (one relaxed load) while inactive
+class MediaRecorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    bool Start(const std::filesystem::path& path);
+    void Stop();
+    bool IsActive() const { return active_.load(std::memory_order_relaxed); }
+
+    void RecordEvent(uint32_t reasons);
+    void RecordCompletion(uint32_t reasons);
+    void RecordState(const MediaState& state, Clock::time_point at);
+
+private:
+    void Write(MediaRecord& record, Clock::time_point at);
+
+    std::atomic<bool> active_{false};
+    std::mutex mutex_;
+    std::ofstream file_;
+    Clock::time_point start_{};
+};
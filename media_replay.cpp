@@ -0,0 +1,311 @@
+#include "media_replay.h"
+
+#include <algorithm>
+
+namespace
+{
+	using Clock = RefreshScheduler::Clock;
+
+	// Longer than the largest rr_media_max_latency_ms, so the tail batch is always released
+	constexpr auto kTailDrain = std::chrono::seconds(3);
+
+	// The worker side of the pipeline: turns a batch into a refresh against the recorded player state
+	class ReplayRefresher
+	{
+	public:
+		explicit ReplayRefresher(const std::vector<MediaRecord>& records)
+			: records_(records)
+		{
+		}
+
+		// Returns true when the batch published a new state
+		bool OnBatch(uint32_t reasons, int64_t atNs, MediaReplayStats& stats)
+		{
+			++stats.batches;
+			AdvanceSource(atNs);
+
+			if (reasons & static_cast<uint32_t>(RefreshReason::SessionChanged))
+				haveMetadata_ = false;
+
+			MediaState next = published_;
+
+			// A recorded metadata fetch completing: the state read then carries its result
+			if (reasons & static_cast<uint32_t>(RefreshReason::MetadataReady))
+			{
+				next = source_;
+				haveMetadata_ = source_.trackId != kNoTrack;
+			}
+
+			if (reasons & static_cast<uint32_t>(RefreshReason::AlbumArtReady))
+			{
+				next.hasAlbumArt = source_.hasAlbumArt;
+			}
+
+			const uint32_t refreshReasons = reasons & ~kCompletionReasons;
+			if (refreshReasons != 0)
+			{
+				if ((refreshReasons & ~kTimelineOnlyReasons) == 0 && haveMetadata_)
+				{
+					++stats.timelineRefreshes;
+					next.isPlaying = source_.isPlaying;
+					next.durationSec = source_.durationSec;
+					next.positionSec = source_.positionSec;
+					next.progress01 = source_.progress01;
+					next.durationTicks = source_.durationTicks;
+					next.positionTicks = source_.positionTicks;
+					next.positionUpdatedAt = source_.positionUpdatedAt;
+					next.playbackRate = source_.playbackRate;
+				}
+				else
+				{
+					++stats.fullRefreshes;
+					next = source_;
+					haveMetadata_ = source_.trackId != kNoTrack;
+				}
+			}
+
+			// Same rule as MediaControllerGSMTC::Publish
+			next.version = published_.version;
+			if (next == published_) return false;
+
+			next.version = published_.version + 1;
+			published_ = std::move(next);
+			++stats.publishes;
+			return true;
+		}
+
+		const MediaState& Published() const { return published_; }
+
+	private:
+		// Player state = latest recorded refresh result at or before `atNs`
+		void AdvanceSource(int64_t atNs)
+		{
+			for (; nextRecord_ < records_.size() && records_[nextRecord_].atNs <= atNs; ++nextRecord_)
+			{
+				if (records_[nextRecord_].kind == MediaRecord::Kind::State)
+					source_ = records_[nextRecord_].state;
+			}
+		}
+
+		const std::vector<MediaRecord>& records_;
+		size_t nextRecord_ = 0;
+		MediaState source_{};
+		MediaState published_{};
+		bool haveMetadata_ = false;
+	};
+
+	// A batch with no event in it was released by a completion alone
+	bool HasEvents(uint32_t reasons)
+	{
+		return (reasons & ~kCompletionReasons) != 0;
+	}
+
+	void FillLatencies(std::vector<double>& latenciesMs, MediaReplayStats& stats)
+	{
+		if (latenciesMs.empty()) return;
+
+		auto percentile = [&](double p)
+		{
+			const auto nth = latenciesMs.begin() + static_cast<ptrdiff_t>(p * static_cast<double>(latenciesMs.size() - 1));
+			std::nth_element(latenciesMs.begin(), nth, latenciesMs.end());
+			return *nth;
+		};
+
+		stats.latencyP50Ms = percentile(0.50);
+		stats.latencyP99Ms = percentile(0.99);
+		stats.latencyMaxMs = *std::max_element(latenciesMs.begin(), latenciesMs.end());
+	}
+
+	std::vector<MediaRecord> SortedByTime(std::vector<MediaRecord> records)
+	{
+		std::stable_sort(records.begin(), records.end(), [](const auto& a, const auto& b) { return a.atNs < b.atNs; });
+		return records;
+	}
+}
+
+// ------------------------------------------------------------
+// Deterministic replay
+// ------------------------------------------------------------
+
+MediaReplayStats SimulateMediaReplay(const std::vector<MediaRecord>& input, std::chrono::milliseconds settle, std::chrono::milliseconds maxLatency)
+{
+	const std::vector<MediaRecord> records = SortedByTime(input);
+
+	ReplayRefresher refresher(records);
+	MediaReplayStats stats;
+	std::vector<double> latenciesMs;
+
+	// Virtual clock: record timestamps mapped onto an arbitrary epoch
+	const Clock::time_point epoch{};
+	auto at = [&](int64_t ns) { return epoch + std::chrono::nanoseconds(ns); };
+
+	uint32_t pending = 0;
+	int64_t firstNs = 0;
+	int64_t lastNs = 0;
+
+	auto releaseAt = [&](int64_t releaseNs)
+	{
+		if (refresher.OnBatch(pending, releaseNs, stats) && HasEvents(pending))
+			latenciesMs.push_back(static_cast<double>(releaseNs - firstNs) / 1e6);
+		pending = 0;
+	};
+
+	auto release = [&]
+	{
+		releaseAt(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			RefreshScheduler::ReleaseTime(at(firstNs), at(lastNs), settle, maxLatency) - epoch).count());
+	};
+
+	for (const MediaRecord& r : records)
+	{
+		if (r.kind == MediaRecord::Kind::State) continue;
+
+		// The pending batch would have been released before this record arrived
+		if (pending != 0 && at(r.atNs) >= RefreshScheduler::ReleaseTime(at(firstNs), at(lastNs), settle, maxLatency))
+			release();
+
+		if (pending == 0) firstNs = r.atNs;
+		pending |= r.reasons;
+
+		if (r.kind == MediaRecord::Kind::Completion)
+		{
+			// Released on the spot, without waiting out the settle window
+			++stats.completions;
+			releaseAt(r.atNs);
+			continue;
+		}
+
+		++stats.events;
+		lastNs = r.atNs;
+	}
+
+	if (pending != 0) release();
+
+	FillLatencies(latenciesMs, stats);
+	return stats;
+}
+
+// ------------------------------------------------------------
+// Real-time replay
+// ------------------------------------------------------------
+
+ReplayMediaController::ReplayMediaController(std::vector<MediaRecord> records, double speed)
+	: records_(SortedByTime(std::move(records)))
+	, speed_(speed > 0.0 ? speed : 1.0)
+	, start_(Clock::now())
+{
+	worker_ = std::thread([this] { WorkerLoop(); });
+	feeder_ = std::thread([this] { FeedLoop(); });
+}
+
+ReplayMediaController::~ReplayMediaController()
+{
+	scheduler_.Stop();
+	if (feeder_.joinable()) feeder_.join();
+	if (worker_.joinable()) worker_.join();
+}
+
+bool ReplayMediaController::Update()
+{
+	if (!published_.Acquire()) return false;
+
+	const MediaState& latest = published_.ReadBuffer();
+	if (latest.version == state_.version) return false;
+
+	state_ = latest;
+	return true;
+}
+
+const MediaState& ReplayMediaController::GetState() const
+{
+	return state_;
+}
+
+MediaStats ReplayMediaController::GetStats() const
+{
+	std::lock_guard lk(statsMutex_);
+
+	MediaStats s;
+	s.fullRefreshes = stats_.fullRefreshes;
+	s.timelineRefreshes = stats_.timelineRefreshes;
+	s.events = scheduler_.EventCount();
+	s.batches = scheduler_.BatchCount();
+	s.completions = scheduler_.CompletionCount();
+	return s;
+}
+
+void ReplayMediaController::SetRefreshWindows(std::chrono::milliseconds settle, std::chrono::milliseconds maxLatency)
+{
+	scheduler_.SetWindows(settle, maxLatency);
+}
+
+MediaReplayStats ReplayMediaController::GetReplayStats() const
+{
+	std::lock_guard lk(statsMutex_);
+	return stats_;
+}
+
+void ReplayMediaController::FeedLoop()
+{
+	// Sleeps in short slices so the destructor never waits on a long gap in the recording
+	auto sleepUntil = [this](Clock::time_point tp)
+	{
+		while (!scheduler_.Stopped() && Clock::now() < tp)
+			std::this_thread::sleep_for(std::min<Clock::duration>(tp - Clock::now(), std::chrono::milliseconds(10)));
+	};
+
+	for (const MediaRecord& r : records_)
+	{
+		if (r.kind == MediaRecord::Kind::State) continue;
+
+		sleepUntil(start_ + std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(r.atNs) / speed_)));
+		if (scheduler_.Stopped()) return;
+
+		if (r.kind == MediaRecord::Kind::Completion)
+			scheduler_.Complete(r.reasons);
+		else
+			scheduler_.Post(r.reasons);
+	}
+
+	fed_.store(true, std::memory_order_release);
+
+	// Unblock the worker once the tail batch has had time to be released and handled
+	sleepUntil(Clock::now() + kTailDrain);
+	scheduler_.Stop();
+}
+
+void ReplayMediaController::WorkerLoop()
+{
+	ReplayRefresher refresher(records_);
+	std::vector<double> latenciesMs;
+
+	while (true)
+	{
+		Clock::time_point firstEvent{};
+		const uint32_t reasons = scheduler_.WaitBatch(&firstEvent);
+		if (scheduler_.Stopped()) break;
+
+		// Recorded timeline of this batch (undo the replay speed)
+		const auto now = Clock::now();
+		const int64_t atNs = static_cast<int64_t>(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_).count()) * speed_);
+
+		bool published;
+		{
+			std::lock_guard lk(statsMutex_);
+			published = refresher.OnBatch(reasons, atNs, stats_);
+		}
+
+		if (published)
+		{
+			published_.WriteBuffer() = refresher.Published();
+			published_.Publish();
+			if (HasEvents(reasons)) latenciesMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - firstEvent).count());
+		}
+	}
+
+	std::lock_guard lk(statsMutex_);
+	stats_.events = scheduler_.EventCount();
+	stats_.completions = scheduler_.CompletionCount();
+	FillLatencies(latenciesMs, stats_);
+	finished_.store(fed_.load(std::memory_order_acquire), std::memory_order_release);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "media.h"
+#include "media_recording.h"
+#include "media_scheduler.h"
+#include "triple_buffer.h"
+
+// ------------------------------------------------------------
+// Replay of a media recording (.rrmr) through the refresh pipeline
+//
+// Recorded events (and the worker's recorded completions, e.g. album art ready)
+// are posted to a RefreshScheduler; every released batch performs
+// a "refresh" that reads the latest recorded player state at that point in time,
+// and publishes it with the same de-duplication as the GSMTC controller. No WinRT,
+// so recordings taken in game can be replayed on Linux.
+// ------------------------------------------------------------
+
+struct MediaReplayStats
+{
+    uint64_t events            = 0;
+    uint64_t completions       = 0;   // worker's own async results, not events
+    uint64_t batches           = 0;
+    uint64_t fullRefreshes     = 0;
+    uint64_t timelineRefreshes = 0;
+    uint64_t publishes         = 0;   // states that changed (new version)
+
+    // Oldest event of a batch -> publish of the state it produced (batches holding
+    // only completions have no event to measure from)
+    double latencyP50Ms = 0.0;
+    double latencyP99Ms = 0.0;
+    double latencyMaxMs = 0.0;
+};
+
+// Deterministic replay on a virtual clock (no threads, no sleeping); refresh work is
+// treated as instantaneous, so latencies only reflect the debounce windows.
+MediaReplayStats SimulateMediaReplay(const std::vector<MediaRecord>& records,
+                                     std::chrono::milliseconds settle = RefreshScheduler::kDefaultSettle,
+                                     std::chrono::milliseconds maxLatency = RefreshScheduler::kDefaultMaxLatency);
+
+// Real-time replay with the live scheduler and worker thread; usable as the
+// overlay's MediaController. `speed` scales the recorded event spacing.
+class ReplayMediaController final : public MediaController
+{
+public:
+    explicit ReplayMediaController(std::vector<MediaRecord> records, double speed = 1.0);
+    ~ReplayMediaController() override;
+
+    bool Update() override;
+    const MediaState& GetState() const override;
+    MediaStats GetStats() const override;
+    void SetRefreshWindows(std::chrono::milliseconds settle, std::chrono::milliseconds maxLatency) override;
+
+    // All events were posted and the last batch was handled
+    bool Finished() const { return finished_.load(std::memory_order_acquire); }
+
+    // Valid once Finished()
+    MediaReplayStats GetReplayStats() const;
+
+private:
+    void FeedLoop();
+    void WorkerLoop();
+
+    std::vector<MediaRecord> records_;
+    double speed_;
+
+    RefreshScheduler scheduler_;
+    std::thread feeder_;
+    std::thread worker_;
+    std::atomic<bool> fed_{false};
+    std::atomic<bool> finished_{false};
+    RefreshScheduler::Clock::time_point start_{};
+
+    TripleBuffer<MediaState> published_;
+    MediaState state_{};   // game thread
+
+    mutable std::mutex statsMutex_;
+    MediaReplayStats stats_{};
+    std::vector<double> latenciesMs_;
+};
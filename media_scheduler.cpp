@@ -0,0 +1,97 @@
+#include "media_scheduler.h"
+#include "trace_writer.h"
+
+#include <algorithm>
+
+const char* RefreshReasonName(RefreshReason r)
+{
+	switch (r)
+	{
+		case RefreshReason::Initial:         return "Initial";
+		case RefreshReason::SessionChanged:  return "SessionChanged";
+		case RefreshReason::MediaChanged:    return "MediaChanged";
+		case RefreshReason::PlaybackChanged: return "PlaybackChanged";
+		case RefreshReason::TimelineChanged: return "TimelineChanged";
+		case RefreshReason::AlbumArtReady:   return "AlbumArtReady";
+		case RefreshReason::MetadataReady:   return "MetadataReady";
+		default:                             return "Refresh";
+	}
+}
+
+RefreshScheduler::Clock::time_point RefreshScheduler::ReleaseTime(Clock::time_point firstEvent, Clock::time_point lastEvent,
+	std::chrono::milliseconds settle, std::chrono::milliseconds maxLatency)
+{
+	return std::min(lastEvent + settle, firstEvent + maxLatency);
+}
+
+void RefreshScheduler::Post(uint32_t reasons)
+{
+	events_.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard lk(mutex_);
+		const auto now = Clock::now();
+		if (pending_ == 0) firstEvent_ = now;
+		lastEvent_ = now;
+		pending_ |= reasons;
+	}
+	cv_.notify_one();
+}
+
+void RefreshScheduler::Complete(uint32_t reasons)
+{
+	completions_.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard lk(mutex_);
+		if (pending_ == 0) firstEvent_ = Clock::now();
+		pending_ |= reasons;
+		releaseNow_ = true;
+	}
+	cv_.notify_one();
+}
+
+void RefreshScheduler::Stop()
+{
+	{
+		std::lock_guard lk(mutex_);
+		stop_.store(true, std::memory_order_relaxed);
+	}
+	cv_.notify_all();
+}
+
+void RefreshScheduler::SetWindows(std::chrono::milliseconds settle, std::chrono::milliseconds maxLatency)
+{
+	settleMs_.store(std::max<int64_t>(0, settle.count()), std::memory_order_relaxed);
+	maxLatencyMs_.store(std::max<int64_t>(0, maxLatency.count()), std::memory_order_relaxed);
+	cv_.notify_one();
+}
+
+uint32_t RefreshScheduler::WaitBatch(Clock::time_point* firstEvent)
+{
+	std::unique_lock lk(mutex_);
+
+	cv_.wait(lk, [this] { return stop_.load(std::memory_order_relaxed) || pending_ != 0; });
+
+	// Settle: keep absorbing the burst until it goes quiet or the latency cap is hit
+	while (!stop_.load(std::memory_order_relaxed) && !releaseNow_)
+	{
+		const std::chrono::milliseconds settle{settleMs_.load(std::memory_order_relaxed)};
+		const std::chrono::milliseconds maxLatency{maxLatencyMs_.load(std::memory_order_relaxed)};
+
+		const auto deadline = ReleaseTime(firstEvent_, lastEvent_, settle, maxLatency);
+		if (Clock::now() >= deadline) break;
+
+		cv_.wait_until(lk, deadline);
+	}
+
+	if (stop_.load(std::memory_order_relaxed)) return 0;
+
+	const uint32_t reasons = pending_;
+	pending_ = 0;
+	releaseNow_ = false;
+	if (firstEvent) *firstEvent = firstEvent_;
+	batches_.fetch_add(1, std::memory_order_relaxed);
+
+	// Span from the first coalesced request to the batch release
+	if (Tracer::IsActive()) Tracer::Complete("Coalesce", "media", firstEvent_, Clock::now());
+	return reasons;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// Why the media worker should refresh (bit flags, OR-ed by the scheduler)
+enum class RefreshReason : uint32_t
+{
+    None = 0,
+    Initial = 1u << 0,
+    SessionChanged = 1u << 1,
+    MediaChanged = 1u << 2,
+    PlaybackChanged = 1u << 3,
+    TimelineChanged = 1u << 4,
+    AlbumArtReady = 1u << 5,
+    MetadataReady = 1u << 6,
+};
+
+// Position/playback-only events: served by a timeline refresh once metadata is known
+inline constexpr uint32_t kTimelineOnlyReasons =
+    static_cast<uint32_t>(RefreshReason::PlaybackChanged) |
+    static_cast<uint32_t>(RefreshReason::TimelineChanged);
+
+// Posted by the worker's own async work (RefreshScheduler::Complete); they hand a
+// result back and never trigger a refresh by themselves
+inline constexpr uint32_t kCompletionReasons =
+    static_cast<uint32_t>(RefreshReason::AlbumArtReady) |
+    static_cast<uint32_t>(RefreshReason::MetadataReady);
+
+const char* RefreshReasonName(RefreshReason r);
+
+// Debounces/coalesces refresh requests from event callbacks (any thread) into
+// batches for a single worker thread.
+//
+// A batch is released once no new request arrived for `settle`, or once the
+// oldest pending request is `maxLatency` old, whichever comes first. A settle
+// window of 0 releases every wakeup immediately (no debouncing). Completions of
+// the worker's own async work are not events: they release the batch at once and
+// are counted on their own.
+class RefreshScheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds kDefaultSettle{40};
+    static constexpr std::chrono::milliseconds kDefaultMaxLatency{150};
+
+    // Any thread
+    void Post(uint32_t reasons);
+    void Complete(uint32_t reasons);
+    void Stop();
+    void SetWindows(std::chrono::milliseconds settle, std::chrono::milliseconds maxLatency);
+
+    // Worker thread: blocks until a batch is ready. Returns the OR of all reasons
+    // posted since the last batch, or 0 once stopped. `firstEvent` receives the
+    // arrival time of the oldest request in the batch.
+    uint32_t WaitBatch(Clock::time_point* firstEvent = nullptr);
+
+    // When a batch whose requests arrived between `firstEvent` and `lastEvent` is released
+    static Clock::time_point ReleaseTime(Clock::time_point firstEvent, Clock::time_point lastEvent,
+                                         std::chrono::milliseconds settle, std::chrono::milliseconds maxLatency);
+
+    bool Stopped() const { return stop_.load(std::memory_order_relaxed); }
+
+    uint64_t EventCount() const { return events_.load(std::memory_order_relaxed); }
+    uint64_t BatchCount() const { return batches_.load(std::memory_order_relaxed); }
+    uint64_t CompletionCount() const { return completions_.load(std::memory_order_relaxed); }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    uint32_t pending_ = 0;
+    bool releaseNow_ = false;   // a completion is pending
+    Clock::time_point firstEvent_{};
+    Clock::time_point lastEvent_{};
+
+    std::atomic<bool> stop_{false};
+    std::atomic<int64_t> settleMs_{kDefaultSettle.count()};
+    std::atomic<int64_t> maxLatencyMs_{kDefaultMaxLatency.count()};
+
+    std::atomic<uint64_t> events_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> completions_{0};
+};
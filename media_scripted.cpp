@@ -0,0 +1,188 @@
+#include "media_scripted.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+	std::vector<std::string> SplitTabs(const std::string& line)
+	{
+		std::vector<std::string> out;
+		size_t start = 0;
+		while (true)
+		{
+			const size_t tab = line.find('\t', start);
+			out.emplace_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+			if (tab == std::string::npos) break;
+			start = tab + 1;
+		}
+		return out;
+	}
+
+	bool ParseInt(const std::string& s, int& out)
+	{
+		std::istringstream ss(s);
+		return static_cast<bool>(ss >> out);
+	}
+
+	bool ParseDouble(const std::string& s, double& out)
+	{
+		std::istringstream ss(s);
+		return static_cast<bool>(ss >> out);
+	}
+}
+
+ScriptedMediaController::ScriptedMediaController(std::vector<ScriptedMediaEvent> events)
+	: events_(std::move(events))
+	, start_(std::chrono::steady_clock::now())
+	, startWall_(std::chrono::system_clock::now())
+{
+	std::stable_sort(events_.begin(), events_.end(), [](const auto& a, const auto& b) { return a.atSec < b.atSec; });
+}
+
+bool ScriptedMediaController::Update()
+{
+	if (manualTime_) return false;
+
+	const double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+	return Step(t);
+}
+
+const MediaState& ScriptedMediaController::GetState() const
+{
+	return state_;
+}
+
+bool ScriptedMediaController::AdvanceTo(double scriptTimeSec)
+{
+	manualTime_ = true;
+	return Step(scriptTimeSec);
+}
+
+bool ScriptedMediaController::Step(double scriptTimeSec)
+{
+	if (scriptTimeSec < now_) return false;
+
+	while (next_ < events_.size() && events_[next_].atSec <= scriptTimeSec)
+	{
+		const auto& e = events_[next_++];
+		UpdatePosition(e.atSec);
+		Apply(e);
+	}
+
+	UpdatePosition(scriptTimeSec);
+
+	if (!changed_) return false;
+
+	changed_ = false;
+	++state_.version;
+	return true;
+}
+
+void ScriptedMediaController::Apply(const ScriptedMediaEvent& e)
+{
+	now_ = e.atSec;
+	changed_ = true;
+
+	const uint64_t version = state_.version;
+
+	switch (e.type)
+	{
+		case ScriptedMediaEvent::Type::Track:
+			state_ = MediaState{};
+			state_.isPlaying = true;
+			state_.title = e.title;
+			state_.artist = e.artist;
+			state_.album = e.album;
+			state_.trackId = ComputeTrackId(e.title, e.artist, e.album);
+			state_.durationSec = std::max(0, e.durationSec);
+			anchorPositionSec_ = 0;
+			break;
+
+		case ScriptedMediaEvent::Type::Play:
+			state_.isPlaying = !state_.title.empty();
+			anchorPositionSec_ = state_.positionSec;
+			break;
+
+		case ScriptedMediaEvent::Type::Pause:
+			state_.isPlaying = false;
+			anchorPositionSec_ = state_.positionSec;
+			break;
+
+		case ScriptedMediaEvent::Type::Seek:
+			anchorPositionSec_ = std::clamp(e.positionSec, 0, state_.durationSec);
+			break;
+
+		case ScriptedMediaEvent::Type::Stop:
+			state_ = MediaState{};
+			anchorPositionSec_ = 0;
+			break;
+	}
+
+	anchorSec_ = e.atSec;
+	state_.positionSec = anchorPositionSec_;
+	state_.version = version;
+
+	// Timeline as a real player reports it: exact at the anchor, extrapolated by the consumer
+	state_.durationTicks = static_cast<int64_t>(state_.durationSec) * kTicksPerSecond;
+	state_.positionTicks = static_cast<int64_t>(anchorPositionSec_) * kTicksPerSecond;
+	const auto scriptEpoch = manualTime_ ? std::chrono::system_clock::time_point{} : startWall_;
+	state_.positionUpdatedAt = scriptEpoch + std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(anchorSec_));
+	state_.playbackRate = 1.0;
+}
+
+void ScriptedMediaController::UpdatePosition(double scriptTimeSec)
+{
+	now_ = std::max(now_, scriptTimeSec);
+
+	int pos = anchorPositionSec_;
+	if (state_.isPlaying)
+		pos += static_cast<int>(now_ - anchorSec_);
+
+	pos = std::clamp(pos, 0, std::max(0, state_.durationSec));
+	if (pos != state_.positionSec) changed_ = true;
+
+	state_.positionSec = pos;
+	state_.progress01 = state_.durationSec > 0 ? std::clamp(state_.positionSec / static_cast<float>(state_.durationSec), 0.0f, 1.0f) : 0.0f;
+}
+
+std::vector<ScriptedMediaEvent> ScriptedMediaController::ParseScript(std::istream& in)
+{
+	std::vector<ScriptedMediaEvent> events;
+	std::string line;
+
+	while (std::getline(in, line))
+	{
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		if (line.empty() || line[0] == '#') continue;
+
+		const auto f = SplitTabs(line);
+		if (f.size() < 2) continue;
+
+		ScriptedMediaEvent e;
+		if (!ParseDouble(f[0], e.atSec)) continue;
+
+		const std::string& cmd = f[1];
+		if (cmd == "track")
+		{
+			if (f.size() < 6 || !ParseInt(f[5], e.durationSec)) continue;
+			e.type = ScriptedMediaEvent::Type::Track;
+			e.title = f[2];
+			e.artist = f[3];
+			e.album = f[4];
+		}
+		else if (cmd == "play")  e.type = ScriptedMediaEvent::Type::Play;
+		else if (cmd == "pause") e.type = ScriptedMediaEvent::Type::Pause;
+		else if (cmd == "stop")  e.type = ScriptedMediaEvent::Type::Stop;
+		else if (cmd == "seek")
+		{
+			if (f.size() < 3 || !ParseInt(f[2], e.positionSec)) continue;
+			e.type = ScriptedMediaEvent::Type::Seek;
+		}
+		else continue;
+
+		events.push_back(std::move(e));
+	}
+
+	return events;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "media.h"
+
+// A timed event in a media script.
+struct ScriptedMediaEvent
+{
+    enum class Type
+    {
+        Track,  // new track (starts playing from 0)
+        Play,
+        Pause,
+        Seek,
+        Stop    // session gone
+    };
+
+    double atSec = 0.0;
+    Type type = Type::Track;
+
+    // Track
+    std::string title;
+    std::string artist;
+    std::string album;
+    int durationSec = 0;
+
+    // Seek
+    int positionSec = 0;
+};
+
+// MediaController that replays a script of timed track/playback events.
+// Used to drive the overlay without a real media session (profiling, regression runs).
+class ScriptedMediaController final : public MediaController
+{
+public:
+    explicit ScriptedMediaController(std::vector<ScriptedMediaEvent> events);
+
+    // Advances by wall clock time since construction.
+    bool Update() override;
+    const MediaState& GetState() const override;
+
+    // Deterministic stepping; switches the controller to manual time, where script
+    // time 0 is the system_clock epoch (positionUpdatedAt no longer depends on when
+    // the controller was created). Returns true when the state changed.
+    bool AdvanceTo(double scriptTimeSec);
+
+    bool Finished() const { return next_ >= events_.size(); }
+
+    // Tab separated, one event per line, '#' starts a comment:
+    //   <sec>  track  <title>  <artist>  <album>  <durationSec>
+    //   <sec>  play | pause | stop
+    //   <sec>  seek   <positionSec>
+    static std::vector<ScriptedMediaEvent> ParseScript(std::istream& in);
+
+private:
+    bool Step(double scriptTimeSec);
+    void Apply(const ScriptedMediaEvent& e);
+    void UpdatePosition(double scriptTimeSec);
+
+    std::vector<ScriptedMediaEvent> events_;
+    size_t next_ = 0;
+
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::system_clock::time_point startWall_;   // script time 0 on the wall clock (real time only)
+    bool manualTime_ = false;
+    double now_ = 0.0;
+
+    // Position anchor (position at `anchorSec_` script time)
+    double anchorSec_ = 0.0;
+    int anchorPositionSec_ = 0;
+
+    MediaState state_{};
+    bool changed_ = false;
+};
@@ -1,6 +1,8 @@
-#include "pch.h"
 #include "notification.h"
 
+#include <algorithm>
+#include <cstdio>
+
 using Clock = std::chrono::steady_clock;
 using Ms    = std::chrono::milliseconds;
 
@@ -9,7 +11,36 @@ std::vector<ImGuiToast> ImGui::notifications;
 
 static float ToMs(const Clock::duration& d)
 {
-    return std::chrono::duration_cast<Ms>(d).count();
+    return static_cast<float>(std::chrono::duration_cast<Ms>(d).count());
+}
+
+std::string format_notification(std::string_view fmt, std::initializer_list<std::string> args)
+{
+    std::string out;
+    out.reserve(fmt.size());
+
+    auto next = args.begin();
+    for (size_t i = 0; i < fmt.size(); ++i)
+    {
+        const char c = fmt[i];
+        const bool doubled = i + 1 < fmt.size() && fmt[i + 1] == c;
+
+        if ((c == '{' || c == '}') && doubled)
+        {
+            out += c;
+            ++i;
+        }
+        else if (c == '{' && i + 1 < fmt.size() && fmt[i + 1] == '}')
+        {
+            if (next != args.end()) out += *next++;
+            ++i;
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    return out;
 }
 
 ImVec4 ImGuiToast::get_color() const
@@ -24,14 +55,15 @@ ImVec4 ImGuiToast::get_color() const
     return { 1.f, 1.f, 1.f, 1.f };
 }
 
-Clock::duration ImGuiToast::elapsed() const
+Clock::duration ImGuiToast::elapsed(Clock::time_point now) const
 {
-    return Clock::now() - creation_time;
+    // A toast inserted from another thread after the frame time was taken
+    return now > creation_time ? now - creation_time : Clock::duration::zero();
 }
 
-NotifyPhase ImGuiToast::get_phase() const
+NotifyPhase ImGuiToast::get_phase(Clock::time_point now) const
 {
-    const float t = ToMs(elapsed());
+    const float t = ToMs(elapsed(now));
     const float fade = NOTIFY_FADE_IN_OUT_TIME;
     const float total = fade + dismiss_time + fade;
 
@@ -42,12 +74,12 @@ NotifyPhase ImGuiToast::get_phase() const
     return NotifyPhase::FadeIn;
 }
 
-float ImGuiToast::get_opacity() const
+float ImGuiToast::get_opacity(Clock::time_point now) const
 {
-    const float t = ToMs(elapsed());
+    const float t = ToMs(elapsed(now));
     constexpr float fade = NOTIFY_FADE_IN_OUT_TIME;
 
-    switch (get_phase())
+    switch (get_phase(now))
     {
         case NotifyPhase::FadeIn:
             return t / fade * NOTIFY_OPACITY;
@@ -71,7 +103,7 @@ namespace ImGui
             if (n.content == toast.content)
             {
                 n.creation_time = Clock::now();
-                n.repeats = std::min(n.repeats + 1, 999);
+                n.repeats = static_cast<uint16_t>(std::min(n.repeats + 1, 999));
                 return;
             }
         }
@@ -79,7 +111,7 @@ namespace ImGui
         notifications.emplace_back(std::move(toast));
     }
 
-    void render_notifications()
+    size_t render_notifications(Clock::time_point now)
     {
         std::scoped_lock lock(g_notification_mutex);
 
@@ -89,7 +121,7 @@ namespace ImGui
         for (size_t i = 0; i < notifications.size();)
         {
             auto& toast = notifications[i];
-            const NotifyPhase phase = toast.get_phase();
+            const NotifyPhase phase = toast.get_phase(now);
 
             if (phase == NotifyPhase::Expired)
             {
@@ -97,7 +129,7 @@ namespace ImGui
                 continue;
             }
 
-            const float opacity = toast.get_opacity();
+            const float opacity = toast.get_opacity(now);
             const ImVec4 color = toast.get_color();
 
             SetNextWindowBgAlpha(opacity);
@@ -108,7 +140,10 @@ namespace ImGui
                 { 1.f, 0.f }
             );
 
-            if (Begin(std::format("##TOAST{}", i).c_str(), nullptr, notify_default_toast_flags))
+            char window_id[32];
+            std::snprintf(window_id, sizeof(window_id), "##TOAST%zu", i);
+
+            if (Begin(window_id, nullptr, notify_default_toast_flags))
             {
                 PushTextWrapPos(GetWindowWidth());
 
@@ -124,7 +159,7 @@ namespace ImGui
 
                 y_offset += GetWindowHeight() + NOTIFY_PADDING_MESSAGE_Y;
 
-                const float elapsed = ToMs(toast.elapsed());
+                const float elapsed = ToMs(toast.elapsed(now));
                 float bar_width = GetWindowWidth();
 
                 if (phase == NotifyPhase::Wait)
@@ -151,5 +186,7 @@ namespace ImGui
             End();
             ++i;
         }
+
+        return notifications.size();
     }
 }
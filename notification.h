@@ -1,12 +1,16 @@
 #pragma once
 
-#include <imgui/imgui.h>
+#include "IMGUI/imgui.h"
 
 #include <chrono>
+#include <cstdint>
+#include <initializer_list>
 #include <mutex>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
-#include <format>
 
 // ==============================
 // Timing
@@ -59,6 +63,26 @@ enum class NotifyPhase : uint8_t
     Expired
 };
 
+// ==============================
+// Formatting
+// ==============================
+
+// Fills each "{}" in `fmt` with the next argument ("{{" and "}}" are literal braces).
+// The subset of std::format the toasts use, without depending on <format>.
+std::string format_notification(std::string_view fmt, std::initializer_list<std::string> args);
+
+template <typename T>
+std::string notification_arg(const T& value)
+{
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+inline std::string notification_arg(const std::string& value) { return value; }
+inline std::string notification_arg(std::string_view value) { return std::string(value); }
+inline std::string notification_arg(const char* value) { return value ? value : ""; }
+
 // ==============================
 // Toast
 // ==============================
@@ -80,15 +104,16 @@ public:
         Args&&... args
     )
         : type(t)
-        , content(std::vformat(fmt, std::make_format_args(args...)))
+        , content(format_notification(fmt, { notification_arg(args)... }))
         , dismiss_time(dismiss)
         , creation_time(NotifyClock::now())
     {}
 
+    // `now` is the frame time, so every part of a toast agrees on it
     ImVec4 get_color() const;
-    NotifyClock::duration elapsed() const;
-    NotifyPhase get_phase() const;
-    float get_opacity() const;
+    NotifyClock::duration elapsed(NotifyClock::time_point now) const;
+    NotifyPhase get_phase(NotifyClock::time_point now) const;
+    float get_opacity(NotifyClock::time_point now) const;
 };
 
 // ==============================
@@ -101,7 +126,9 @@ namespace ImGui
     extern std::vector<ImGuiToast> notifications;
 
     void insert_notification(ImGuiToast toast);
-    void render_notifications();
+
+    // Returns how many toasts are on screen
+    size_t render_notifications(NotifyClock::time_point now);
 }
 
 // ==============================
@@ -0,0 +1,58 @@
+#include "null_renderer.h"
+
+NullRenderer::NullRenderer(ImVec2 displaySize)
+{
+    IMGUI_CHECKVERSION();
+    mPrevious = ImGui::GetCurrentContext();
+    mContext = ImGui::CreateContext();
+    ImGui::SetCurrentContext(mContext);
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.LogFilename = nullptr;
+    io.DisplaySize = displaySize;
+
+    // The atlas has to be built before the first frame; it is never uploaded
+    unsigned char* pixels = nullptr;
+    int width = 0;
+    int height = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    io.Fonts->TexID = FakeTexture(1);
+}
+
+NullRenderer::~NullRenderer()
+{
+    ImGui::DestroyContext(mContext);
+    ImGui::SetCurrentContext(mPrevious);
+}
+
+void NullRenderer::SetDisplaySize(ImVec2 size)
+{
+    ImGui::GetIO().DisplaySize = size;
+}
+
+void NullRenderer::BeginFrame(float deltaSec)
+{
+    ImGui::GetIO().DeltaTime = deltaSec > 0.0f ? deltaSec : 1.0f / 60.0f;
+    ImGui::NewFrame();
+}
+
+const NullFrameStats& NullRenderer::EndFrame()
+{
+    ImGui::Render();
+
+    mLast = NullFrameStats{};
+    const ImDrawData* data = ImGui::GetDrawData();
+    if (data && data->Valid)
+    {
+        mLast.drawLists = data->CmdListsCount;
+        mLast.vertices = data->TotalVtxCount;
+        mLast.indices = data->TotalIdxCount;
+        for (int i = 0; i < data->CmdListsCount; ++i)
+        {
+            mLast.drawCmds += data->CmdLists[i]->CmdBuffer.Size;
+        }
+    }
+    ++mFrames;
+    return mLast;
+}
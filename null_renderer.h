@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+
+#include "IMGUI/imgui.h"
+
+// ------------------------------------------------------------
+// Headless Dear ImGui host: a context whose frames are built and
+// rendered into draw lists that nobody draws.
+//
+// Stands in for BakkesMod's D3D11 backend when the overlay runs outside
+// the game (benchmarks, tests). Textures are never sampled, so any
+// non-null ImTextureID works for images.
+// ------------------------------------------------------------
+
+// What ImGui::Render() produced for one frame
+struct NullFrameStats
+{
+    int drawLists = 0;
+    int drawCmds = 0;
+    int vertices = 0;
+    int indices = 0;
+};
+
+class NullRenderer
+{
+public:
+    // Creates and activates its own ImGui context (default font, no imgui.ini)
+    explicit NullRenderer(ImVec2 displaySize = ImVec2(1920.0f, 1080.0f));
+    ~NullRenderer();
+
+    NullRenderer(const NullRenderer&) = delete;
+    NullRenderer& operator=(const NullRenderer&) = delete;
+
+    void SetDisplaySize(ImVec2 size);
+
+    // ImGui::NewFrame() with `deltaSec` (> 0) as the frame's delta time
+    void BeginFrame(float deltaSec);
+
+    // ImGui::Render(); counts what would have been submitted
+    const NullFrameStats& EndFrame();
+
+    const NullFrameStats& LastFrame() const { return mLast; }
+    uint64_t Frames() const { return mFrames; }
+
+    // Placeholder texture handle for images drawn by the host
+    static ImTextureID FakeTexture(uintptr_t id) { return reinterpret_cast<ImTextureID>(id); }
+
+private:
+    ImGuiContext* mContext = nullptr;
+    ImGuiContext* mPrevious = nullptr;
+    NullFrameStats mLast{};
+    uint64_t mFrames = 0;
+};
@@ -0,0 +1,270 @@
+#include "overlay_core.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+// ------------------------------------------------------------
+// Text
+// ------------------------------------------------------------
+
+std::string FormatTimeSeconds(int seconds)
+{
+    if (seconds <= 0) return "0:00";
+    const int minutes = seconds / 60;
+    const int secs = seconds % 60;
+
+    char buf[16]{};
+    snprintf(buf, sizeof(buf), "%d:%02d", minutes, secs);
+    return std::string(buf);
+}
+
+float ComputeMarqueeOffset(float overflow, float speedPxPerSec, float waitTimeSec, float timeSec)
+{
+    if (overflow <= 0.0f || speedPxPerSec <= 0.0f) return 0.0f;
+
+    const float moveTime = overflow / speedPxPerSec;
+
+    // cycle = wait -> move -> wait -> move back
+    const float cycle = waitTimeSec + moveTime + waitTimeSec + moveTime;
+    const float phase = fmodf(timeSec, cycle);
+
+    if (phase < waitTimeSec)
+        return 0.0f;
+    if (phase < waitTimeSec + moveTime)
+        return (phase - waitTimeSec) * speedPxPerSec;
+    if (phase < waitTimeSec + moveTime + waitTimeSec)
+        return overflow;
+    return overflow - (phase - (waitTimeSec + moveTime + waitTimeSec)) * speedPxPerSec;
+}
+
+float ComputeMarqueeIdleTime(float overflow, float speedPxPerSec, float waitTimeSec, float timeSec)
+{
+    if (overflow <= 0.0f || speedPxPerSec <= 0.0f) return std::numeric_limits<float>::infinity();
+
+    const float moveTime = overflow / speedPxPerSec;
+    const float cycle = waitTimeSec + moveTime + waitTimeSec + moveTime;
+    const float phase = fmodf(timeSec, cycle);
+
+    if (phase < waitTimeSec)
+        return waitTimeSec - phase;
+    if (phase < waitTimeSec + moveTime)
+        return 0.0f;
+    if (phase < waitTimeSec + moveTime + waitTimeSec)
+        return waitTimeSec + moveTime + waitTimeSec - phase;
+    return 0.0f;
+}
+
+void DrawPingPongMarqueeText(
+    const char* text,
+    const ImVec4& color,
+    float availableWidth,
+    float speedPxPerSec,
+    float waitTimeSec,
+    ImFont* font
+)
+{
+    if (font) ImGui::PushFont(font);
+
+    TextRun run;
+    BuildTextRun(run, ImGui::GetFont(), ImGui::GetFontSize(), text ? text : "");
+    DrawPingPongMarqueeText(run, color, availableWidth, speedPxPerSec, waitTimeSec, static_cast<float>(ImGui::GetTime()));
+
+    if (font) ImGui::PopFont();
+}
+
+void DrawPingPongMarqueeText(
+    const TextRun& run,
+    const ImVec4& color,
+    float availableWidth,
+    float speedPxPerSec,
+    float waitTimeSec,
+    float timeSec
+)
+{
+    if (run.text.empty())
+    {
+        ImGui::Dummy(ImVec2(availableWidth, ImGui::GetTextLineHeight()));
+        return;
+    }
+
+    ImDrawList* dl = ImGui::GetWindowDrawList();
+    const ImVec2 pos = ImGui::GetCursorScreenPos();
+    const float lineH = ImGui::GetTextLineHeight();
+
+    // Reserve space for one line
+    ImGui::Dummy(ImVec2(availableWidth, lineH));
+
+    const float overflow = run.width - availableWidth;
+
+    dl->PushClipRect(pos, ImVec2(pos.x + availableWidth, pos.y + lineH), true);
+
+    const float offset = ComputeMarqueeOffset(overflow, speedPxPerSec, waitTimeSec, timeSec);
+    DrawTextRun(dl, run, ImVec2(pos.x - offset, pos.y), ImGui::GetColorU32(color));
+
+    dl->PopClipRect();
+}
+
+void DrawTextLine(const TextRun& run, const ImVec4& color)
+{
+    const ImVec2 pos = ImGui::GetCursorScreenPos();
+    ImGui::Dummy(ImVec2(run.width, ImGui::GetTextLineHeight()));
+    DrawTextRun(ImGui::GetWindowDrawList(), run, pos, ImGui::GetColorU32(color));
+}
+
+// ------------------------------------------------------------
+// Scaling
+// ------------------------------------------------------------
+
+float ComputeAutoScaleFactor(const ImVec2& displaySize, float dpiScale, float minScale, float maxScale)
+{
+    constexpr float baseWidth = 1920.0f;
+    constexpr float baseHeight = 1080.0f;
+
+    const float heightRatio = displaySize.y / baseHeight;
+    const float widthRatio = displaySize.x / baseWidth;
+
+    const float resolutionScale = std::min(heightRatio, widthRatio);
+
+    float autoScale = resolutionScale * dpiScale;
+    autoScale = std::clamp(autoScale, minScale, maxScale);
+    return autoScale;
+}
+
+float ComputeEffectiveScaleFactor(const WindowStyle& style, float autoScale)
+{
+    float scale = style.enableAutoScaling ? autoScale : 1.0f;
+    scale *= style.uiScale;
+
+    return std::clamp(scale, 0.5f, 3.0f);
+}
+
+// ------------------------------------------------------------
+// Window layout
+// ------------------------------------------------------------
+
+OverlayLayout ComputeOverlayLayout(const WindowStyle& style, float scaleFactor, const ImVec2& displaySize)
+{
+    OverlayLayout layout;
+
+    // Base size at scale=1 (approx)
+    if (style.showAlbumArt)
+    {
+        layout.baseWidth  = style.albumArtSize + 15.0f + 235.0f + 15.0f;
+        layout.baseHeight = std::max(style.albumArtSize + 20.0f, 140.0f);
+    }
+
+    const float scaledW = layout.baseWidth * scaleFactor;
+    layout.windowPos = ImVec2((displaySize.x - scaledW) * 0.5f, 25.0f * scaleFactor);
+
+    const float minW = layout.baseWidth * 0.5f;
+    const float minH = layout.baseHeight * 0.5f;
+    layout.minSize = ImVec2(minW * scaleFactor, minH * scaleFactor);
+
+    return layout;
+}
+
+float ComputeContentScale(const OverlayLayout& layout, const ImVec2& windowSize)
+{
+    const float dynamicScaleX = windowSize.x / layout.baseWidth;
+    const float dynamicScaleY = windowSize.y / layout.baseHeight;
+    const float dynamicScale = std::min(dynamicScaleX, dynamicScaleY);
+    return std::clamp(dynamicScale, 0.5f, 3.0f);
+}
+
+float ComputeFontScale(float contentScale)
+{
+    float fontScale = contentScale;
+    if (contentScale > 1.5f) fontScale *= 0.95f;
+    return fontScale;
+}
+
+float ComputeAlbumColumnWidth(const WindowStyle& style, float contentScale)
+{
+    return (style.albumArtSize + 15.0f) * contentScale;
+}
+
+// ------------------------------------------------------------
+// Layout metrics
+// ------------------------------------------------------------
+
+OverlayMetrics ComputeOverlayMetrics(const WindowStyle& style, const ImVec2& displaySize, float dpiScale)
+{
+    OverlayMetrics m;
+
+    const float autoScale = style.enableAutoScaling ? ComputeAutoScaleFactor(displaySize, dpiScale, style.minScale, style.maxScale) : 1.0f;
+    m.scale = ComputeEffectiveScaleFactor(style, autoScale);
+    m.layout = ComputeOverlayLayout(style, m.scale, displaySize);
+
+    m.windowRounding = style.windowRounding * m.scale;
+    m.windowPadding = ImVec2(10.0f * m.scale, 10.0f * m.scale);
+    m.itemSpacing = ImVec2(4.0f * m.scale, 2.0f * m.scale);
+    m.framePadding = ImVec2(4.0f * m.scale, 2.0f * m.scale);
+
+    m.progressBarHeight = style.progressBarHeight * m.scale;
+    m.progressBarRounding = std::min(style.progressBarRounding * m.scale, m.progressBarHeight * 0.5f);
+    m.timeLabelGap = 4.0f * m.scale;
+    m.progressBarSpacing = 12.0f * m.scale;
+
+    m.marqueeSpeedPx = style.marqueeSpeedPx * m.scale;
+    return m;
+}
+
+void UpdateContentMetrics(OverlayMetrics& metrics, const WindowStyle& style, const ImVec2& windowSize)
+{
+    if (windowSize.x == metrics.windowSize.x && windowSize.y == metrics.windowSize.y) return;
+
+    metrics.windowSize = windowSize;
+    metrics.contentScale = ComputeContentScale(metrics.layout, windowSize);
+    metrics.fontScale = ComputeFontScale(metrics.contentScale);
+    metrics.albumColumnWidth = ComputeAlbumColumnWidth(style, metrics.contentScale);
+}
+
+// ------------------------------------------------------------
+// Playback position smoothing
+// ------------------------------------------------------------
+
+double PlaybackPositionSmoother::GetDisplayPosition(const MediaState& state, std::chrono::system_clock::time_point now)
+{
+    const double durationSec = static_cast<double>(state.durationTicks) / kTicksPerSecond;
+    if (durationSec <= 0.0)
+    {
+        mHaveDisplay = false;
+        return 0.0;
+    }
+
+    double target = static_cast<double>(state.positionTicks) / kTicksPerSecond;
+    if (state.isPlaying)
+        target += std::chrono::duration<double>(now - state.positionUpdatedAt).count() * state.playbackRate;
+    target = std::clamp(target, 0.0, durationSec);
+
+    const double dt = std::chrono::duration<double>(now - mLastNow).count();
+    mLastNow = now;
+
+    // Snap on new track, pause (position is exact) or clock weirdness
+    if (!mHaveDisplay || state.trackId != mLastTrackId || !state.isPlaying || dt < 0.0)
+    {
+        mHaveDisplay = true;
+        mLastTrackId = state.trackId;
+        mDisplayedSec = target;
+        return mDisplayedSec;
+    }
+
+    const double previous = mDisplayedSec;
+    double displayed = previous + dt * state.playbackRate;
+
+    const double error = target - displayed;
+    if (std::abs(error) > kSnapSec)
+    {
+        displayed = target;
+    }
+    else
+    {
+        displayed += error * std::min(1.0, dt / kConvergeSec);
+        displayed = std::max(displayed, previous);
+    }
+
+    mDisplayedSec = std::clamp(displayed, 0.0, durationSec);
+    return mDisplayedSec;
+}
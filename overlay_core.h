@@ -0,0 +1,140 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+#include "IMGUI/imgui.h"
+#include "media.h"
+#include "text_cache.h"
+#include "window_style.h"
+
+// ------------------------------------------------------------
+// Platform-neutral overlay logic.
+// Nothing in here may depend on WinRT, Win32 or BakkesMod so it
+// can be built and profiled outside of Rocket League.
+// ------------------------------------------------------------
+
+// "m:ss" for whole seconds (negative/zero -> "0:00")
+std::string FormatTimeSeconds(int seconds);
+
+// Horizontal offset of a ping-pong marquee at time `timeSec`:
+// wait -> move -> wait -> move back, for text overflowing its box by `overflow` px.
+float ComputeMarqueeOffset(float overflow, float speedPxPerSec, float waitTimeSec, float timeSec);
+
+// Seconds until that offset changes again: 0 while the text moves, the rest of the
+// pause while it waits at either end, infinity if it never moves.
+float ComputeMarqueeIdleTime(float overflow, float speedPxPerSec, float waitTimeSec, float timeSec);
+
+// Scrolls by ImGui::GetTime()
+void DrawPingPongMarqueeText(
+    const char* text,
+    const ImVec4& color,
+    float availableWidth,
+    float speedPxPerSec,
+    float waitTimeSec,
+    ImFont* font = nullptr
+);
+
+// Same for a cached run (measured in the current font) at marquee time `timeSec`; only
+// the offset changes per frame
+void DrawPingPongMarqueeText(
+    const TextRun& run,
+    const ImVec4& color,
+    float availableWidth,
+    float speedPxPerSec,
+    float waitTimeSec,
+    float timeSec
+);
+
+// One line of text at the cursor, like ImGui::TextColored, from a cached run
+void DrawTextLine(const TextRun& run, const ImVec4& color);
+
+// ---------------------------
+// Scaling
+// ---------------------------
+
+// Resolution (relative to 1080p) times DPI, clamped to the style's min/max.
+float ComputeAutoScaleFactor(const ImVec2& displaySize, float dpiScale, float minScale, float maxScale);
+
+// Auto scale (or 1.0 when disabled) times the manual multiplier.
+float ComputeEffectiveScaleFactor(const WindowStyle& style, float autoScale);
+
+// ---------------------------
+// Window layout
+// ---------------------------
+struct OverlayLayout
+{
+    float  baseWidth  = 360.0f;   // at scale 1
+    float  baseHeight = 130.0f;
+    ImVec2 windowPos;             // initial position (top center)
+    ImVec2 minSize;
+};
+
+OverlayLayout ComputeOverlayLayout(const WindowStyle& style, float scaleFactor, const ImVec2& displaySize);
+
+// Scale of the window contents relative to the base layout (follows manual resizing).
+float ComputeContentScale(const OverlayLayout& layout, const ImVec2& windowSize);
+float ComputeFontScale(float contentScale);
+float ComputeAlbumColumnWidth(const WindowStyle& style, float contentScale);
+
+// ---------------------------
+// Layout metrics
+// ---------------------------
+
+// Everything the overlay derives from the scale factor and the style. Computed when the
+// display, DPI or style changes, so a frame reads plain values instead of recomputing
+// them (and querying the DPI) per draw call.
+struct OverlayMetrics
+{
+    float scale = 1.0f;   // auto scale (or 1) times the manual multiplier
+    OverlayLayout layout;
+
+    // Window style vars
+    float  windowRounding = 0.0f;
+    ImVec2 windowPadding;
+    ImVec2 itemSpacing;
+    ImVec2 framePadding;
+
+    // Progress bar
+    float progressBarHeight = 0.0f;
+    float progressBarRounding = 0.0f;   // at most half the height
+    float timeLabelGap = 0.0f;          // between the bar and the time labels
+    float progressBarSpacing = 0.0f;    // below the time labels
+
+    float marqueeSpeedPx = 0.0f;
+
+    // Follows the window size (manual resizing); see UpdateContentMetrics
+    ImVec2 windowSize{ -1.0f, -1.0f };
+    float contentScale = 1.0f;
+    float fontScale = 1.0f;
+    float albumColumnWidth = 0.0f;
+};
+
+// `dpiScale` is only used with auto scaling on
+OverlayMetrics ComputeOverlayMetrics(const WindowStyle& style, const ImVec2& displaySize, float dpiScale);
+
+// Recomputes the window-size dependent part when `windowSize` differs from the last one
+void UpdateContentMetrics(OverlayMetrics& metrics, const WindowStyle& style, const ImVec2& windowSize);
+
+// ---------------------------
+// Playback position smoothing
+// ---------------------------
+class PlaybackPositionSmoother
+{
+public:
+    // Continuous display position in seconds, extrapolated from the last timeline
+    // update (position + elapsed * rate).
+    //
+    // Drift policy: the displayed position advances at the playback rate and is
+    // pulled towards the extrapolated target over kConvergeSec, never moving
+    // backwards while playing. Errors above kSnapSec (seek, skip, stall) snap.
+    double GetDisplayPosition(const MediaState& state, std::chrono::system_clock::time_point now);
+
+    static constexpr double kSnapSec     = 0.75;
+    static constexpr double kConvergeSec = 0.5;
+
+private:
+    bool   mHaveDisplay = false;
+    double mDisplayedSec = 0.0;
+    std::chrono::system_clock::time_point mLastNow{};
+    TrackId mLastTrackId = kNoTrack;
+};
@@ -0,0 +1,526 @@
+#include "overlay_view.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <string_view>
+
+#include "profiler.h"
+
+OverlayView::OverlayView(const WindowStyle& style)
+    : mStyle(style)
+{
+}
+
+void OverlayView::SetMediaState(const MediaState& state)
+{
+    const TrackId previousTrack = mMediaState.trackId;
+    mMediaState = state;
+    mRedraw.Invalidate();
+
+    if (mMediaState.trackId != previousTrack) mAnimations.Marquee().Restart();
+}
+
+void OverlayView::SetFont(ImFont* font)
+{
+    mFont = font;
+
+    // Runs laid out before this were measured in the previous font
+    mTextCache.Clear();
+}
+
+void OverlayView::Clear()
+{
+    mLayers.Clear();
+    mTextCache.Clear();
+}
+
+// ------------------------------------------------------------
+// Frame
+// ------------------------------------------------------------
+
+const FrameTime& OverlayView::BeginFrame(uint64_t frameIndex, Clock::time_point now, std::chrono::system_clock::time_point wallNow)
+{
+    // The one clock tick of the frame; every animation reads its time from here
+    mAnimations.Pulse().SetRunning(mMediaState.isPlaying && mStyle.enablePulse);
+    mWallNow = wallNow;
+    return mAnimations.BeginFrame(frameIndex, now);
+}
+
+void OverlayView::Draw(const OverlayArt& art)
+{
+    const FrameTime& frame = mAnimations.Frame();
+    const OverlayMetrics& metrics = GetLayoutMetrics();
+    const OverlayLayout& layout = metrics.layout;
+
+    ImGui::SetNextWindowPos(layout.windowPos, ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSizeConstraints(layout.minSize, ImVec2(FLT_MAX, FLT_MAX));
+
+    // The blurred cover replaces the flat background when it is available
+    const bool backdrop = WantsBackdrop(art);
+
+    ImVec4 bg = mStyle.backgroundColor;
+    bg.w = backdrop ? 0.0f : bg.w * mStyle.windowOpacity;
+
+    ImGui::PushStyleColor(ImGuiCol_WindowBg, bg);
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowRounding, metrics.windowRounding);
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, metrics.windowPadding);
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, metrics.itemSpacing);
+    ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, metrics.framePadding);
+
+    if (mFont) ImGui::PushFont(mFont);
+
+    if (ImGui::Begin("##RocketRhythmWindow", nullptr,
+        ImGuiWindowFlags_NoCollapse |
+        ImGuiWindowFlags_NoTitleBar |
+        ImGuiWindowFlags_NoScrollbar))
+    {
+        UpdateContentMetrics(mMetrics, mStyle, ImGui::GetWindowSize());
+        ImGui::SetWindowFontScale(metrics.fontScale);
+
+        // An idle frame replays the previous one. Style edits (from any path) and hover are
+        // part of the key; moving or resizing the window is handled by the layer itself
+        const uint64_t generation = mRedraw.Poll(frame.now, mAnimations.NextChangeSec());
+        const uint64_t key = LayerKey{}.Add(generation).Add(mStyle).Add(ImGui::IsWindowHovered()).Add(metrics.scale).Add(backdrop).Value();
+        mLayers.Draw(RetainedLayer::Frame, key, [&] {
+            mRedraw.BeginRedraw();
+            DrawContents(metrics, art, backdrop);
+        });
+    }
+    ImGui::End();
+
+    if (mFont) ImGui::PopFont();
+    ImGui::PopStyleVar(4);
+    ImGui::PopStyleColor(1);
+}
+
+// Everything inside the overlay window. Runs only when mRedraw (or a layout change) asks
+// for it; animated parts declare when they next need a frame.
+void OverlayView::DrawContents(const OverlayMetrics& metrics, const OverlayArt& art, bool backdrop)
+{
+    // The lines drawn below register again
+    mAnimations.Marquee().ClearLines();
+
+    if (backdrop) DrawBackdrop(art, metrics.scale);
+
+    if (!HasMusic())
+    {
+        DrawNoMusicState();
+        return;
+    }
+
+    if (mStyle.showAlbumArt)
+    {
+        ImGui::Columns(2, "music_columns", false);
+        ImGui::SetColumnWidth(0, metrics.albumColumnWidth);
+
+        DrawAlbumArt(art, metrics.contentScale);
+
+        ImGui::NextColumn();
+        DrawMusicStateCompact(art);
+        ImGui::Columns(1);
+    }
+    else
+    {
+        DrawMusicStateCompact(art);
+    }
+}
+
+// ------------------------------------------------------------
+// Layout metrics
+// ------------------------------------------------------------
+
+// Recomputed on a display size change or after InvalidateLayoutMetrics(). The DPI is only
+// queried then, and only with auto scaling on.
+const OverlayMetrics& OverlayView::GetLayoutMetrics()
+{
+    const ImVec2 display = ImGui::GetIO().DisplaySize;
+    if (mMetricsDirty || display.x != mMetricsDisplaySize.x || display.y != mMetricsDisplaySize.y)
+    {
+        const float dpiScale = mStyle.enableAutoScaling && mDpiScale ? mDpiScale() : 1.0f;
+        mMetrics = ComputeOverlayMetrics(mStyle, display, dpiScale);
+        mMetricsDisplaySize = display;
+        mMetricsDirty = false;
+        ++mMetricsComputes;
+    }
+    return mMetrics;
+}
+
+// ------------------------------------------------------------
+// Colors and playback position
+// ------------------------------------------------------------
+
+// The palette was extracted when the art was decoded; this only converts a color.
+ImVec4 OverlayView::GetAccentColor(const OverlayArt& art, bool secondary) const
+{
+    const ImVec4& configured = secondary ? mStyle.accentColor2 : mStyle.accentColor;
+    if (!mStyle.accentFromAlbumArt) return configured;
+
+    const auto accentOf = [&](const ArtPalette* palette) {
+        if (!palette || !palette->usable) return configured;
+
+        const uint8_t* rgb = secondary ? palette->accent2 : palette->accent;
+        return ImVec4(rgb[0] / 255.0f, rgb[1] / 255.0f, rgb[2] / 255.0f, configured.w);
+    };
+
+    const ImVec4 front = accentOf(art.current.palette);
+    const float t = mAnimations.ArtFade().Value();
+    if (t >= 1.0f) return front;
+
+    const ImVec4 back = accentOf(art.previous.palette);
+    return ImVec4(back.x + (front.x - back.x) * t, back.y + (front.y - back.y) * t, back.z + (front.z - back.z) * t, configured.w);
+}
+
+double OverlayView::GetCurrentDisplayPosition()
+{
+    return mPositionSmoother.GetDisplayPosition(mMediaState, mWallNow);
+}
+
+// ------------------------------------------------------------
+// Drawing (album art)
+// ------------------------------------------------------------
+
+// Draws only; the caller owns the layout around it
+void OverlayView::PaintAlbumArtPlaceholder(ImDrawList* dl, ImVec2 pos, float scale)
+{
+    const float size = mStyle.albumArtSize * scale;
+
+    const ImU32 top = ImGui::GetColorU32(ImVec4(0.15f, 0.15f, 0.18f, 1.0f));
+    const ImU32 bot = ImGui::GetColorU32(ImVec4(0.12f, 0.12f, 0.15f, 1.0f));
+    dl->AddRectFilledMultiColor(pos, ImVec2(pos.x + size, pos.y + size), top, top, bot, bot);
+
+    const float cx = pos.x + size * 0.5f;
+    const float cy = pos.y + size * 0.5f;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const float radius = size * 0.25f + i * (8.0f * scale);
+        const ImU32 ring = ImGui::GetColorU32(ImVec4(0.3f, 0.3f, 0.35f, 0.2f));
+        dl->AddCircle(ImVec2(cx, cy), radius, ring, 0, 1.5f);
+    }
+
+    const ImU32 note = ImGui::GetColorU32(mStyle.accentColor);
+    const float fontSize = ImGui::GetFontSize() * 2.0f;
+    const float off = 15.0f * scale;
+    dl->AddText(ImGui::GetFont(), fontSize, ImVec2(cx - off, cy - off), note, "♪");
+
+    const ImU32 border = ImGui::GetColorU32(mStyle.accentColor);
+    dl->AddRect(pos, ImVec2(pos.x + size, pos.y + size), border, mStyle.albumArtRounding * scale, 0, 2.0f);
+}
+
+// True when the blurred cover replaces the flat background this frame (the blur was done
+// when the art was decoded)
+bool OverlayView::WantsBackdrop(const OverlayArt& art) const
+{
+    if (!mStyle.albumArtBackdrop || !HasMusic()) return false;
+
+    const bool front = art.current.backdrop != nullptr;
+    const bool back = mAnimations.ArtFade().Active() && art.previous.backdrop;
+    return front || back;
+}
+
+// Textured quads over the window, center-cropped to its aspect and darkened so the text
+// stays readable. Drawn before the contents, so they sit where WindowBg would be. During a
+// crossfade the old backdrop (or the flat background) is drawn under the new one.
+void OverlayView::DrawBackdrop(const OverlayArt& art, float scale)
+{
+    const ImVec2 pos = ImGui::GetWindowPos();
+    const ImVec2 size = ImGui::GetWindowSize();
+    if (size.x <= 0.0f || size.y <= 0.0f) return;
+
+    ImVec2 uv0(0.0f, 0.0f);
+    ImVec2 uv1(1.0f, 1.0f);
+    const float aspect = size.x / size.y;
+    if (aspect > 1.0f)
+    {
+        uv0.y = 0.5f - 0.5f / aspect;
+        uv1.y = 0.5f + 0.5f / aspect;
+    }
+    else
+    {
+        uv0.x = 0.5f - 0.5f * aspect;
+        uv1.x = 0.5f + 0.5f * aspect;
+    }
+
+    const float fade = mAnimations.ArtFade().Value();
+    ImTextureID top = art.current.backdrop;
+    ImTextureID under = fade < 1.0f ? art.previous.backdrop : nullptr;
+    float topAlpha = fade;
+    if (!top)
+    {
+        // Fading out to the flat background
+        top = under;
+        under = nullptr;
+        topAlpha = 1.0f - fade;
+    }
+
+    const ImVec2 end(pos.x + size.x, pos.y + size.y);
+    const float rounding = mStyle.windowRounding * scale;
+
+    constexpr float kShade = 0.45f;
+    const float opacity = mStyle.windowOpacity;
+
+    const auto paint = [&] {
+        ImDrawList* dl = ImGui::GetWindowDrawList();
+        if (topAlpha < 1.0f)
+        {
+            if (under)
+            {
+                dl->AddImageRounded(under, pos, end, uv0, uv1, ImGui::GetColorU32(ImVec4(kShade, kShade, kShade, opacity)), rounding);
+            }
+            else
+            {
+                ImVec4 bg = mStyle.backgroundColor;
+                bg.w *= opacity;
+                dl->AddRectFilled(pos, end, ImGui::GetColorU32(bg), rounding);
+            }
+        }
+
+        if (top)
+            dl->AddImageRounded(top, pos, end, uv0, uv1, ImGui::GetColorU32(ImVec4(kShade, kShade, kShade, opacity * topAlpha)), rounding);
+    };
+
+    // Static between crossfades
+    if (fade >= 1.0f)
+        mLayers.Draw(RetainedLayer::Backdrop, LayerKey{}.Add(top).Add(rounding).Add(opacity).Add(mStyle.backgroundColor).Value(), paint);
+    else
+        paint();
+}
+
+void OverlayView::DrawAlbumArt(const OverlayArt& art, float scale)
+{
+    RR_PROFILE_SCOPE(ProfileStage::DrawAlbumArt);
+
+    const ImVec2 pos = ImGui::GetCursorScreenPos();
+    const float size = mStyle.albumArtSize * scale;
+
+    // Decode once at the largest size the art can be drawn at with this scale (rounded up to
+    // 32 px so small scale changes reuse the stored pixels); smaller sizes just sample it
+    const float maxSize = std::max(mStyle.albumArtSize, kAlbumArtSizeMax) * scale;
+    mAlbumArtRequestPx = (static_cast<int>(std::ceil(maxSize)) + 31) / 32 * 32;
+
+    // Crossfade: the replaced art (or the placeholder) underneath, the new art on top
+    const float fade = mAnimations.ArtFade().Value();
+    ImTextureID top = art.current.image;
+    ImTextureID under = fade < 1.0f ? art.previous.image : nullptr;
+    float topAlpha = fade;
+    if (!top)
+    {
+        // Fading out to the placeholder
+        top = under;
+        under = nullptr;
+        topAlpha = 1.0f - fade;
+    }
+
+    const ImVec2 end(pos.x + size, pos.y + size);
+    const float rounding = mStyle.albumArtRounding * scale;
+
+    const auto paint = [&] {
+        ImDrawList* dl = ImGui::GetWindowDrawList();
+        if (!top)
+        {
+            PaintAlbumArtPlaceholder(dl, pos, scale);
+            return;
+        }
+
+        if (topAlpha < 1.0f)
+        {
+            if (under) dl->AddImage(under, pos, end);
+            else PaintAlbumArtPlaceholder(dl, pos, scale);
+        }
+
+        dl->AddImage(top, pos, end, ImVec2(0, 0), ImVec2(1, 1), ImGui::GetColorU32(ImVec4(1, 1, 1, topAlpha)));
+        dl->AddRect(pos, end, ImGui::GetColorU32(ImVec4(1, 1, 1, 0.10f)), rounding, 0, 1.0f);
+    };
+
+    // Static between crossfades
+    if (fade >= 1.0f)
+        mLayers.Draw(RetainedLayer::AlbumArt, LayerKey{}.Add(top).Add(size).Add(rounding).Add(mStyle.accentColor).Value(), paint);
+    else
+        paint();
+
+    // Layout: the art's box (the placeholder only moves the cursor), then the gap to the text column
+    if (top) ImGui::Dummy(ImVec2(size, size));
+    ImGui::SetCursorPos(ImVec2(ImGui::GetCursorPos().x + size + 15.0f * scale, ImGui::GetCursorPos().y));
+}
+
+// ------------------------------------------------------------
+// Drawing (progress bar)
+// ------------------------------------------------------------
+
+void OverlayView::DrawProgressBar(const OverlayArt& art)
+{
+    RR_PROFILE_SCOPE(ProfileStage::DrawProgressBar);
+
+    if (!mStyle.showProgressBar || mMediaState.durationSec <= 0) return;
+
+    const double currentPosExact = GetCurrentDisplayPosition();
+    const int currentPos = static_cast<int>(currentPosExact);
+
+    float progress = mMediaState.durationTicks > 0
+        ? static_cast<float>(currentPosExact * kTicksPerSecond / static_cast<double>(mMediaState.durationTicks))
+        : 0.0f;
+    progress = std::clamp(progress, 0.0f, 1.0f);
+
+    ImDrawList* dl = ImGui::GetWindowDrawList();
+    const ImVec2 pos = ImGui::GetCursorScreenPos();
+    const float width  = ImGui::GetContentRegionAvail().x;
+    const float height = mMetrics.progressBarHeight;
+
+    const ImU32 bgCol = ImGui::GetColorU32(ImVec4(0.15f, 0.15f, 0.20f, 0.8f));
+
+    const float bgRounding = mMetrics.progressBarRounding;
+
+    // Background
+    mLayers.Draw(RetainedLayer::ProgressTrack, LayerKey{}.Add(width).Add(height).Add(bgRounding).Add(bgCol).Value(), [&] {
+        ImGui::GetWindowDrawList()->AddRectFilled(pos, ImVec2(pos.x + width, pos.y + height), bgCol, bgRounding);
+    });
+
+    // Fill
+    if (progress > 0.0f)
+    {
+        const float fillWidth = width * progress;
+
+        ImVec4 fillColor = GetAccentColor(art);
+        if (mMediaState.isPlaying && mStyle.enablePulse)
+        {
+            const float pulse = 0.8f + 0.2f * sinf(mAnimations.Pulse().Phase());
+            fillColor.x *= pulse;
+            fillColor.y *= pulse;
+            fillColor.z *= pulse;
+        }
+
+        const float fillRounding = std::min(mMetrics.progressBarRounding, fillWidth * 0.5f);
+
+        const ImU32 fillCol = ImGui::GetColorU32(fillColor);
+        dl->AddRectFilled(pos, ImVec2(pos.x + fillWidth, pos.y + height), fillCol, fillRounding);
+
+        const ImU32 highlight = ImGui::GetColorU32(ImVec4(1, 1, 1, 0.20f));
+        dl->AddLine(ImVec2(pos.x, pos.y + 1), ImVec2(pos.x + fillWidth, pos.y + 1), highlight, 1.0f);
+    }
+
+    // Time labels
+    const float yText = pos.y + height + mMetrics.timeLabelGap;
+    const ImU32 textCol = ImGui::GetColorU32(mStyle.textColorDim);
+
+    if (mStyle.timeDisplayMode == WindowStyle::TimeDisplayMode::Corners)
+    {
+        const TextRun& leftTime  = mTextCache.Get(TextSlot::TimeLeft, FormatTimeSeconds(currentPos));
+        const TextRun& rightTime = mTextCache.Get(TextSlot::TimeRight, FormatTimeSeconds(mMediaState.durationSec));
+
+        DrawTextRun(dl, leftTime, ImVec2(pos.x, yText), textCol);
+        DrawTextRun(dl, rightTime, ImVec2(pos.x + width - rightTime.width, yText), textCol);
+    }
+    else // CenterSlash
+    {
+        const TextRun& timeText = mTextCache.Get(TextSlot::TimeCenter,
+            FormatTimeSeconds(currentPos) + " / " + FormatTimeSeconds(mMediaState.durationSec));
+
+        const float x = pos.x + (width - timeText.width) * 0.5f;
+        DrawTextRun(dl, timeText, ImVec2(x, yText), textCol);
+    }
+
+    // Reserve space (text line + spacing)
+    ImGui::Dummy(ImVec2(width, ImGui::GetTextLineHeight() + mMetrics.progressBarSpacing));
+
+    // Next redraw: when the label reaches the next second or the fill has grown by a
+    // quarter pixel, whichever comes first (the pulse wakes every frame on its own)
+    if (mMediaState.isPlaying && mMediaState.playbackRate > 0.0)
+    {
+        const double rate = mMediaState.playbackRate;
+        const double toNextSecond = (std::floor(currentPosExact) + 1.0 - currentPosExact) / rate;
+        const double fillPxPerSec = width * rate * kTicksPerSecond / static_cast<double>(std::max<int64_t>(mMediaState.durationTicks, 1));
+        const double toFillStep = fillPxPerSec > 0.0 ? 0.25 / fillPxPerSec : toNextSecond;
+        mRedraw.WakeIn(std::min(toNextSecond, toFillStep));
+    }
+}
+
+// ------------------------------------------------------------
+// Drawing (music state)
+// ------------------------------------------------------------
+
+void OverlayView::DrawMusicStateCompact(const OverlayArt& art)
+{
+    RR_PROFILE_SCOPE(ProfileStage::DrawMusicState);
+
+    if (mFont) ImGui::PushFont(mFont);
+
+    const float speed = mMetrics.marqueeSpeedPx;
+    const float wait  = mStyle.marqueeWaitSec;
+
+    // Title
+    if (!mMediaState.title.empty())
+    {
+        ImVec4 c = mStyle.textColor;
+        if (mMediaState.isPlaying && mStyle.enablePulse)
+        {
+            const float pulse = 0.9f + 0.1f * sinf(mAnimations.Pulse().Phase());
+            c.w *= pulse;
+        }
+
+        DrawMetadataLine(TextSlot::Title, RetainedLayer::Title, mMediaState.title, c, speed, wait, mMediaState.isPlaying && mStyle.enablePulse);
+    }
+
+    // Artist
+    if (!mMediaState.artist.empty())
+        DrawMetadataLine(TextSlot::Artist, RetainedLayer::Artist, mMediaState.artist, mStyle.textColorDim, speed, wait, false);
+
+    // Album
+    if (mStyle.showAlbumInfo && !mMediaState.album.empty())
+        DrawMetadataLine(TextSlot::Album, RetainedLayer::Album, mMediaState.album, mStyle.textColorFaint, speed, wait, false);
+
+    ImGui::Spacing();
+
+    if (mStyle.showProgressBar && mMediaState.durationSec > 0)
+        DrawProgressBar(art);
+
+    if (mFont) ImGui::PopFont();
+}
+
+// One metadata line. A line that neither scrolls nor pulses is a retained layer; the
+// others are drawn from the cached run every frame.
+void OverlayView::DrawMetadataLine(TextSlot slot, RetainedLayer layer, const std::string& text, const ImVec4& color, float speed, float wait, bool pulsing)
+{
+    const TextRun& run = mTextCache.Get(slot, text);
+    const float avail = ImGui::GetContentRegionAvail().x;
+    const bool marquee = mStyle.enableMarquee;
+
+    if (pulsing || (marquee && run.width > avail))
+    {
+        if (marquee)
+        {
+            DrawPingPongMarqueeText(run, color, avail, speed, wait, mAnimations.Marquee().Time());
+            mAnimations.Marquee().AddLine(run.width - avail, speed, wait);
+        }
+        else
+        {
+            DrawTextLine(run, color);
+        }
+        return;
+    }
+
+    const ImVec2 pos = ImGui::GetCursorScreenPos();
+    const ImU32 col = ImGui::GetColorU32(color);
+    mLayers.Draw(layer, LayerKey{}.Add(std::string_view(run.text)).Add(col).Value(), [&] {
+        DrawTextRun(ImGui::GetWindowDrawList(), run, pos, col);
+    });
+    ImGui::Dummy(ImVec2(marquee ? avail : run.width, ImGui::GetTextLineHeight()));
+}
+
+void OverlayView::DrawNoMusicState()
+{
+    const ImVec2 ws = ImGui::GetWindowSize();
+    const ImVec2 center(ws.x * 0.5f, ws.y * 0.5f);
+
+    auto mainText = "No Music Playing";
+    auto subText  = "Play a song to see track info";
+
+    const float mainW = ImGui::CalcTextSize(mainText).x;
+    const float subW  = ImGui::CalcTextSize(subText).x;
+
+    ImGui::SetCursorPos(ImVec2(center.x - mainW * 0.5f, center.y - 20));
+    ImGui::TextColored(mStyle.textColorFaint, "%s", mainText);
+
+    ImGui::SetCursorPos(ImVec2(center.x - subW * 0.5f, center.y + 10));
+    ImGui::TextColored(mStyle.textColorFaint, "%s", subText);
+}
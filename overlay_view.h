@@ -0,0 +1,126 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include "IMGUI/imgui.h"
+#include "animation.h"
+#include "media.h"
+#include "overlay_core.h"
+#include "redraw_scheduler.h"
+#include "retained_draw.h"
+#include "text_cache.h"
+#include "window_style.h"
+
+// ------------------------------------------------------------
+// The overlay window: layout, metadata lines, progress bar, album art and backdrop.
+//
+// Everything the overlay draws, on top of Dear ImGui only. The host (the plugin, or
+// the headless null-renderer build) feeds it media states, hands over the textures of
+// the art on screen each frame and calls Draw() once per rendered frame; textures,
+// fonts and the DPI query stay with the host.
+// ------------------------------------------------------------
+
+// Textures and palette of one cover on screen; the host owns them
+struct OverlayArtLayer
+{
+    ImTextureID image = nullptr;
+    ImTextureID backdrop = nullptr;        // blurred copy, nullptr if there is none
+    const ArtPalette* palette = nullptr;
+};
+
+// `current` fades in over `previous` while Animations().ArtFade() runs
+struct OverlayArt
+{
+    OverlayArtLayer current;
+    OverlayArtLayer previous;
+};
+
+class OverlayView
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // `style` is the host's; edits to it are picked up by the next redraw (call
+    // InvalidateLayoutMetrics() when scale-related fields change)
+    explicit OverlayView(const WindowStyle& style);
+
+    // A new version of the media state (MediaController::Update returned true)
+    void SetMediaState(const MediaState& state);
+    const MediaState& GetMediaState() const { return mMediaState; }
+    bool HasMusic() const { return !mMediaState.title.empty() || !mMediaState.artist.empty(); }
+
+    // Font of the window contents; nullptr uses ImGui's current font
+    void SetFont(ImFont* font);
+
+    // Queried when the metrics are recomputed with auto scaling on; 1.0 when unset
+    void SetDpiScaleSource(std::function<float()> source) { mDpiScale = std::move(source); }
+
+    // Once per rendered frame, before the host updates its art: ticks the frame clock.
+    // `wallNow` extrapolates the playback position (MediaState::positionUpdatedAt).
+    const FrameTime& BeginFrame(uint64_t frameIndex, Clock::time_point now, std::chrono::system_clock::time_point wallNow);
+
+    // The overlay window (Begin/End included)
+    void Draw(const OverlayArt& art);
+
+    // Scale-derived sizes; recomputed when the display size changes or after
+    // InvalidateLayoutMetrics() (style edit, config load, rr_uiscale)
+    const OverlayMetrics& GetLayoutMetrics();
+    const OverlayMetrics& Metrics() const { return mMetrics; }
+    void InvalidateLayoutMetrics() { mMetricsDirty = true; }
+    uint64_t MetricsComputes() const { return mMetricsComputes; }
+
+    // Edge (px, rounded up to 32) the art should be decoded at for the current scale;
+    // 0 until the art was drawn once
+    int AlbumArtRequestPx() const { return mAlbumArtRequestPx; }
+
+    AnimationTimeline& Animations() { return mAnimations; }
+    const AnimationTimeline& Animations() const { return mAnimations; }
+    RedrawScheduler& Redraw() { return mRedraw; }
+    RetainedDrawCache& Layers() { return mLayers; }
+
+    // Drops recordings and laid-out text (unload, font reload)
+    void Clear();
+
+private:
+    ImVec4 GetAccentColor(const OverlayArt& art, bool secondary = false) const;
+    double GetCurrentDisplayPosition();
+
+    bool WantsBackdrop(const OverlayArt& art) const;
+    void DrawContents(const OverlayMetrics& metrics, const OverlayArt& art, bool backdrop);
+    void DrawNoMusicState();
+    void PaintAlbumArtPlaceholder(ImDrawList* dl, ImVec2 pos, float scale);
+    void DrawAlbumArt(const OverlayArt& art, float scale);
+    void DrawBackdrop(const OverlayArt& art, float scale);
+
+    void DrawMusicStateCompact(const OverlayArt& art);
+    void DrawMetadataLine(TextSlot slot, RetainedLayer layer, const std::string& text, const ImVec4& color, float speed, float wait, bool pulsing);
+    void DrawProgressBar(const OverlayArt& art);
+
+    const WindowStyle& mStyle;
+    MediaState mMediaState;
+    ImFont* mFont = nullptr;
+
+    // Laid-out metadata and time labels, rebuilt when the text, font or scale changes
+    TextRunCache mTextCache;
+
+    // Recorded draw commands of the parts of the overlay that did not change
+    RetainedDrawCache mLayers;
+
+    // When the window contents have to be laid out again instead of replayed
+    RedrawScheduler mRedraw;
+
+    // Frame clock plus pulse, marquee and crossfade timing
+    AnimationTimeline mAnimations;
+
+    PlaybackPositionSmoother mPositionSmoother;
+    std::chrono::system_clock::time_point mWallNow{};
+
+    std::function<float()> mDpiScale;
+    OverlayMetrics mMetrics;
+    ImVec2 mMetricsDisplaySize{ -1.0f, -1.0f };
+    bool mMetricsDirty = true;
+    uint64_t mMetricsComputes = 0;
+
+    int mAlbumArtRequestPx = 0;
+};
@@ -0,0 +1,313 @@
+#include "palette.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "image_kernels.h"
+
+namespace
+{
+	constexpr int kClusters = 8;
+	constexpr int kRefinePasses = 3;
+
+	// Below this Oklab chroma a cluster is grey; art without a colorful cluster keeps the configured accents
+	constexpr float kMinChroma = 0.035f;
+
+	// Oklab distance the second accent keeps from the first
+	constexpr float kMinAccentDistance = 0.12f;
+
+	// Lightness range the accents are moved into (they are drawn on a dark background)
+	constexpr float kAccentMinL = 0.62f;
+	constexpr float kAccentMaxL = 0.90f;
+	constexpr float kAccent2MinL = 0.52f;
+
+	struct Lab
+	{
+		float L = 0.0f;
+		float a = 0.0f;
+		float b = 0.0f;
+	};
+
+	float SrgbToLinear(float c)
+	{
+		return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float LinearToSrgb(float c)
+	{
+		return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+	}
+
+	Lab LinearToOklab(float r, float g, float b)
+	{
+		const float l = std::cbrt(0.4122214708f * r + 0.5363325363f * g + 0.0514459929f * b);
+		const float m = std::cbrt(0.2119034982f * r + 0.6806995451f * g + 0.1073969566f * b);
+		const float s = std::cbrt(0.0883024619f * r + 0.2817188376f * g + 0.6299787005f * b);
+
+		return Lab{
+			0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+			1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+			0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s,
+		};
+	}
+
+	std::array<float, 3> OklabToLinear(const Lab& c)
+	{
+		const float l = c.L + 0.3963377774f * c.a + 0.2158037573f * c.b;
+		const float m = c.L - 0.1055613458f * c.a - 0.0638541728f * c.b;
+		const float s = c.L - 0.0894841775f * c.a - 1.2914855480f * c.b;
+
+		const float l3 = l * l * l;
+		const float m3 = m * m * m;
+		const float s3 = s * s * s;
+
+		return {
+			+4.0767416621f * l3 - 3.3077115913f * m3 + 0.2309699292f * s3,
+			-1.2684380046f * l3 + 2.6097574011f * m3 - 0.3413193965f * s3,
+			-0.0041960863f * l3 - 0.7034186147f * m3 + 1.7076147010f * s3,
+		};
+	}
+
+	// Oklab of every 5:5:5 bin centre, built once
+	const std::vector<Lab>& BinColors()
+	{
+		static const std::vector<Lab> table = [] {
+			std::array<float, 32> linear{};
+			for (int i = 0; i < 32; ++i) linear[i] = SrgbToLinear((i * 8 + 4) / 255.0f);
+
+			std::vector<Lab> t(ImageKernels::kHistogramBins);
+			for (uint32_t bin = 0; bin < ImageKernels::kHistogramBins; ++bin)
+				t[bin] = LinearToOklab(linear[bin >> 10], linear[(bin >> 5) & 31], linear[bin & 31]);
+			return t;
+		}();
+		return table;
+	}
+
+	struct Sample
+	{
+		Lab color;
+		float weight = 0.0f;
+	};
+
+	struct Cluster
+	{
+		Lab color;
+		float weight = 0.0f;
+	};
+
+	float Axis(const Lab& c, int axis)
+	{
+		return axis == 0 ? c.L : axis == 1 ? c.a : c.b;
+	}
+
+	float Distance2(const Lab& x, const Lab& y)
+	{
+		const float dL = x.L - y.L;
+		const float da = x.a - y.a;
+		const float db = x.b - y.b;
+		return dL * dL + da * da + db * db;
+	}
+
+	Cluster Mean(const Sample* begin, const Sample* end)
+	{
+		Cluster c;
+		double L = 0.0, a = 0.0, b = 0.0, w = 0.0;
+		for (const Sample* s = begin; s != end; ++s)
+		{
+			L += s->color.L * s->weight;
+			a += s->color.a * s->weight;
+			b += s->color.b * s->weight;
+			w += s->weight;
+		}
+		if (w > 0.0) c.color = Lab{ static_cast<float>(L / w), static_cast<float>(a / w), static_cast<float>(b / w) };
+		c.weight = static_cast<float>(w);
+		return c;
+	}
+
+	// Weighted spread of a box along each axis; the box splits along the widest
+	struct Spread
+	{
+		float total = 0.0f;
+		int axis = 0;
+	};
+
+	Spread Measure(const Sample* begin, const Sample* end)
+	{
+		const Cluster mean = Mean(begin, end);
+
+		double var[3] = {};
+		for (const Sample* s = begin; s != end; ++s)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				const double d = Axis(s->color, axis) - Axis(mean.color, axis);
+				var[axis] += d * d * s->weight;
+			}
+		}
+
+		Spread spread;
+		spread.axis = static_cast<int>(std::max_element(var, var + 3) - var);
+		spread.total = static_cast<float>(var[0] + var[1] + var[2]);
+		return spread;
+	}
+
+	// Median-cut style boxes on the samples (reordered in place), then weighted k-means refinement
+	std::vector<Cluster> FindClusters(std::vector<Sample>& samples)
+	{
+		struct Box
+		{
+			size_t begin = 0;
+			size_t end = 0;
+			Spread spread;
+		};
+
+		std::vector<Box> boxes{ Box{ 0, samples.size(), Measure(samples.data(), samples.data() + samples.size()) } };
+
+		while (boxes.size() < kClusters)
+		{
+			const auto widest = std::max_element(boxes.begin(), boxes.end(), [](const Box& x, const Box& y) { return x.spread.total < y.spread.total; });
+			if (widest->end - widest->begin < 2 || !(widest->spread.total > 0.0f)) break;
+
+			// Split at the weighted mean of the widest axis (a linear partition, not a sort)
+			Box box = *widest;
+			const int axis = box.spread.axis;
+			const float cut = Axis(Mean(samples.data() + box.begin, samples.data() + box.end).color, axis);
+			const auto mid = std::partition(samples.begin() + box.begin, samples.begin() + box.end,
+				[axis, cut](const Sample& x) { return Axis(x.color, axis) < cut; });
+
+			// Keep both halves non-empty
+			size_t split = static_cast<size_t>(mid - samples.begin());
+			split = std::clamp(split, box.begin + 1, box.end - 1);
+
+			const Sample* base = samples.data();
+			*widest = Box{ box.begin, split, Measure(base + box.begin, base + split) };
+			boxes.push_back(Box{ split, box.end, Measure(base + split, base + box.end) });
+		}
+
+		std::vector<Cluster> clusters;
+		clusters.reserve(boxes.size());
+		for (const Box& box : boxes) clusters.push_back(Mean(samples.data() + box.begin, samples.data() + box.end));
+
+		std::vector<double> sums(clusters.size() * 4);
+		for (int pass = 0; pass < kRefinePasses; ++pass)
+		{
+			std::fill(sums.begin(), sums.end(), 0.0);
+			for (const Sample& s : samples)
+			{
+				size_t best = 0;
+				float bestD = Distance2(s.color, clusters[0].color);
+				for (size_t c = 1; c < clusters.size(); ++c)
+				{
+					const float d = Distance2(s.color, clusters[c].color);
+					if (d < bestD)
+					{
+						bestD = d;
+						best = c;
+					}
+				}
+
+				double* sum = sums.data() + best * 4;
+				sum[0] += s.color.L * s.weight;
+				sum[1] += s.color.a * s.weight;
+				sum[2] += s.color.b * s.weight;
+				sum[3] += s.weight;
+			}
+
+			for (size_t c = 0; c < clusters.size(); ++c)
+			{
+				const double* sum = sums.data() + c * 4;
+				clusters[c].weight = static_cast<float>(sum[3]);
+				if (sum[3] > 0.0)
+					clusters[c].color = Lab{ static_cast<float>(sum[0] / sum[3]), static_cast<float>(sum[1] / sum[3]), static_cast<float>(sum[2] / sum[3]) };
+			}
+		}
+
+		return clusters;
+	}
+
+	float Chroma(const Lab& c)
+	{
+		return std::sqrt(c.a * c.a + c.b * c.b);
+	}
+
+	// Population matters, but a small vivid area beats a large dull one
+	float AccentScore(const Cluster& c, float totalWeight)
+	{
+		const float chroma = Chroma(c.color);
+		if (chroma < kMinChroma || totalWeight <= 0.0f) return 0.0f;
+
+		const float share = c.weight / totalWeight;
+		const float lightness = (c.color.L < 0.25f || c.color.L > 0.95f) ? 0.3f : 1.0f;
+		return std::sqrt(share) * chroma * lightness;
+	}
+
+	// Moves the lightness into [minL, maxL] and reduces chroma until the color is in the sRGB gamut
+	void ToSrgb8(Lab c, float minL, float maxL, uint8_t out[3])
+	{
+		c.L = std::clamp(c.L, minL, maxL);
+
+		std::array<float, 3> rgb = OklabToLinear(c);
+		for (int i = 0; i < 8; ++i)
+		{
+			if (std::all_of(rgb.begin(), rgb.end(), [](float v) { return v >= 0.0f && v <= 1.0f; })) break;
+			c.a *= 0.85f;
+			c.b *= 0.85f;
+			rgb = OklabToLinear(c);
+		}
+
+		for (int i = 0; i < 3; ++i)
+			out[i] = static_cast<uint8_t>(std::lround(std::clamp(LinearToSrgb(std::clamp(rgb[i], 0.0f, 1.0f)), 0.0f, 1.0f) * 255.0f));
+	}
+}
+
+ArtPalette ExtractPalette(const uint8_t* rgba, int width, int height)
+{
+	ArtPalette palette;
+	if (!rgba || width <= 0 || height <= 0) return palette;
+
+	std::vector<uint32_t> bins(ImageKernels::kHistogramBins + 1, 0);
+	ImageKernels::ColorHistogram(rgba, static_cast<size_t>(width) * height, bins.data());
+
+	const std::vector<Lab>& colors = BinColors();
+
+	std::vector<Sample> samples;
+	float totalWeight = 0.0f;
+	for (uint32_t bin = 0; bin < ImageKernels::kHistogramBins; ++bin)
+	{
+		if (!bins[bin]) continue;
+		samples.push_back(Sample{ colors[bin], static_cast<float>(bins[bin]) });
+		totalWeight += static_cast<float>(bins[bin]);
+	}
+
+	palette.extracted = true;
+	if (samples.empty()) return palette;
+
+	const std::vector<Cluster> clusters = FindClusters(samples);
+
+	std::vector<float> scores(clusters.size());
+	for (size_t i = 0; i < clusters.size(); ++i) scores[i] = AccentScore(clusters[i], totalWeight);
+
+	const size_t first = static_cast<size_t>(std::max_element(scores.begin(), scores.end()) - scores.begin());
+	if (!(scores[first] > 0.0f)) return palette;
+
+	// Second accent: best remaining cluster that is far enough from the first, else a darker first
+	Lab second = clusters[first].color;
+	second.L -= 0.15f;
+
+	float secondScore = 0.0f;
+	for (size_t i = 0; i < clusters.size(); ++i)
+	{
+		if (i == first || scores[i] <= secondScore) continue;
+		if (Distance2(clusters[i].color, clusters[first].color) < kMinAccentDistance * kMinAccentDistance) continue;
+
+		secondScore = scores[i];
+		second = clusters[i].color;
+	}
+
+	ToSrgb8(clusters[first].color, kAccentMinL, kAccentMaxL, palette.accent);
+	ToSrgb8(second, kAccent2MinL, kAccentMaxL, palette.accent2);
+	palette.usable = true;
+	return palette;
+}
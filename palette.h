@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+// ------------------------------------------------------------
+// Accent colors picked from album art.
+//
+// The opaque pixels are binned into a 5:5:5 histogram (ImageKernels::ColorHistogram)
+// and the populated bins are clustered in Oklab: median-cut style boxes (split
+// along the widest axis at its weighted mean), then a few weighted k-means
+// passes. The accent is the cluster with the best mix of population and chroma,
+// the second accent the best one that is visibly different from it; both are
+// lifted to a lightness that reads on the dark overlay. Runs where the art is
+// decoded, never on the game thread.
+// ------------------------------------------------------------
+
+struct ArtPalette
+{
+    bool extracted = false;   // extraction ran on this art
+    bool usable = false;      // colorful enough to drive the accents (grey covers are not)
+    uint8_t accent[3] = {};   // sRGB
+    uint8_t accent2[3] = {};
+};
+
+// Straight-alpha RGBA8, rows tightly packed
+ArtPalette ExtractPalette(const uint8_t* rgba, int width, int height);
@@ -0,0 +1,197 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	struct Sample
+	{
+		ProfileStage stage;
+		uint64_t ns;
+	};
+
+	// Single-producer (owning thread) / single-consumer (Collect) ring
+	struct SampleRing
+	{
+		static constexpr uint32_t kCapacity = 4096;
+
+		std::array<Sample, kCapacity> samples{};
+		std::atomic<uint32_t> head{0};   // producer
+		std::atomic<uint32_t> tail{0};   // consumer
+		std::atomic<bool> orphaned{false};
+	};
+
+	// Per-stage window of recent samples used for the percentiles
+	struct StageWindow
+	{
+		static constexpr size_t kSize = 512;
+
+		std::array<uint64_t, kSize> ns{};
+		size_t next = 0;
+		size_t filled = 0;
+		uint64_t total = 0;
+	};
+
+	std::atomic<bool> gEnabled{false};
+	std::atomic<uint64_t> gDropped{0};
+
+	std::mutex gRegistryMutex;
+	std::vector<std::shared_ptr<SampleRing>> gRings;
+	std::array<StageWindow, kProfileStageCount> gWindows;
+
+	// Registers on first use, flags the ring for removal when the thread exits
+	struct ThreadRing
+	{
+		std::shared_ptr<SampleRing> ring = std::make_shared<SampleRing>();
+
+		ThreadRing()
+		{
+			std::lock_guard lk(gRegistryMutex);
+			gRings.push_back(ring);
+		}
+
+		~ThreadRing()
+		{
+			ring->orphaned.store(true, std::memory_order_release);
+		}
+	};
+
+	SampleRing& LocalRing()
+	{
+		thread_local ThreadRing local;
+		return *local.ring;
+	}
+
+	void Drain(SampleRing& ring)
+	{
+		const uint32_t head = ring.head.load(std::memory_order_acquire);
+		uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+
+		for (; tail != head; ++tail)
+		{
+			const Sample& s = ring.samples[tail % SampleRing::kCapacity];
+			auto& w = gWindows[static_cast<size_t>(s.stage)];
+			w.ns[w.next] = s.ns;
+			w.next = (w.next + 1) % StageWindow::kSize;
+			w.filled = std::min(w.filled + 1, StageWindow::kSize);
+			++w.total;
+		}
+
+		ring.tail.store(tail, std::memory_order_release);
+	}
+}
+
+const char* ProfileStageName(ProfileStage stage)
+{
+	switch (stage)
+	{
+		case ProfileStage::RenderCanvas:        return "RenderCanvas";
+		case ProfileStage::RenderWindow:        return "RenderWindow";
+		case ProfileStage::DrawAlbumArt:        return "DrawAlbumArt";
+		case ProfileStage::DrawMusicState:      return "DrawMusicStateCompact";
+		case ProfileStage::DrawProgressBar:     return "DrawProgressBar";
+		case ProfileStage::RenderNotifications: return "render_notifications";
+		case ProfileStage::RefreshOnce:         return "RefreshOnce";
+		case ProfileStage::RefreshTimeline:     return "RefreshTimeline";
+		case ProfileStage::FetchMetadata:       return "FetchMetadataAsync";
+		case ProfileStage::CacheAlbumArt:       return "StartAlbumArtFetch";
+		case ProfileStage::FetchAlbumArt:       return "LoadAlbumArtAsync";
+		case ProfileStage::DecodeAlbumArt:      return "DecodeAlbumArt";
+		case ProfileStage::ExtractPalette:      return "ExtractPalette";
+		case ProfileStage::BlurBackdrop:        return "BlurBackdrop";
+		case ProfileStage::ResampleAlbumArt:    return "ResampleAlbumArt";
+		case ProfileStage::UploadAlbumArt:      return "UploadAlbumArt";
+		case ProfileStage::Count:               break;
+	}
+	return "?";
+}
+
+namespace Profiler
+{
+	void SetEnabled(bool enabled)
+	{
+		gEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool IsEnabled()
+	{
+		return gEnabled.load(std::memory_order_relaxed);
+	}
+
+	void Record(ProfileStage stage, Clock::duration elapsed)
+	{
+		SampleRing& ring = LocalRing();
+
+		const uint32_t head = ring.head.load(std::memory_order_relaxed);
+		const uint32_t tail = ring.tail.load(std::memory_order_acquire);
+		if (head - tail >= SampleRing::kCapacity)
+		{
+			gDropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+		ring.samples[head % SampleRing::kCapacity] = Sample{ stage, static_cast<uint64_t>(std::max<int64_t>(0, ns)) };
+		ring.head.store(head + 1, std::memory_order_release);
+	}
+
+	std::array<ProfileStats, kProfileStageCount> Collect()
+	{
+		std::array<ProfileStats, kProfileStageCount> out{};
+		std::array<uint64_t, StageWindow::kSize> scratch{};
+
+		std::lock_guard lk(gRegistryMutex);
+
+		for (auto it = gRings.begin(); it != gRings.end();)
+		{
+			const bool orphaned = (*it)->orphaned.load(std::memory_order_acquire);
+			Drain(**it);
+			it = orphaned ? gRings.erase(it) : it + 1;
+		}
+
+		for (size_t i = 0; i < kProfileStageCount; ++i)
+		{
+			const auto& w = gWindows[i];
+			out[i].count = w.total;
+			if (w.filled == 0) continue;
+
+			std::copy_n(w.ns.begin(), w.filled, scratch.begin());
+			const auto begin = scratch.begin();
+			const auto end = scratch.begin() + static_cast<ptrdiff_t>(w.filled);
+
+			auto percentile = [&](double p)
+			{
+				const auto nth = begin + static_cast<ptrdiff_t>(p * static_cast<double>(w.filled - 1));
+				std::nth_element(begin, nth, end);
+				return static_cast<double>(*nth) / 1000.0;
+			};
+
+			out[i].p50Us = percentile(0.50);
+			out[i].p99Us = percentile(0.99);
+			out[i].maxUs = static_cast<double>(*std::max_element(begin, end)) / 1000.0;
+		}
+
+		return out;
+	}
+
+	uint64_t DroppedSamples()
+	{
+		return gDropped.load(std::memory_order_relaxed);
+	}
+
+	void Reset()
+	{
+		std::lock_guard lk(gRegistryMutex);
+
+		// Discard whatever is still queued, then clear the windows
+		for (auto& ring : gRings)
+			Drain(*ring);
+
+		gWindows = {};
+		gDropped.store(0, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "trace_writer.h"
+
+// ------------------------------------------------------------
+// Frame-stage profiler
+//
+// RR_PROFILE_SCOPE(stage) times the enclosing scope and pushes the sample into a
+// lock-free ring owned by the calling thread. Collect() (game thread) drains all
+// rings into per-stage windows and reports p50/p99/max.
+//
+// Build with RR_ENABLE_PROFILER=0 to compile every scope out entirely; otherwise a
+// disabled profiler (rr_profile 0) costs two relaxed loads per scope, the profiler
+// flag and the trace flag. While a trace capture is running (rr_trace_start) every
+// scope is also emitted as a trace event.
+// ------------------------------------------------------------
+
+#ifndef RR_ENABLE_PROFILER
+#define RR_ENABLE_PROFILER 1
+#endif
+
+enum class ProfileStage : uint8_t
+{
+    RenderCanvas,
+    RenderWindow,
+    DrawAlbumArt,
+    DrawMusicState,
+    DrawProgressBar,
+    RenderNotifications,
+    RefreshOnce,
+    RefreshTimeline,
+    FetchMetadata,
+    CacheAlbumArt,
+    FetchAlbumArt,
+    DecodeAlbumArt,
+    ExtractPalette,
+    BlurBackdrop,
+    ResampleAlbumArt,
+    UploadAlbumArt,
+
+    Count
+};
+
+inline constexpr size_t kProfileStageCount = static_cast<size_t>(ProfileStage::Count);
+
+const char* ProfileStageName(ProfileStage stage);
+
+struct ProfileStats
+{
+    uint64_t count = 0;     // samples seen since Reset()
+    double   p50Us = 0.0;   // over the most recent window
+    double   p99Us = 0.0;
+    double   maxUs = 0.0;
+};
+
+namespace Profiler
+{
+    using Clock = std::chrono::steady_clock;
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled();
+
+    // Any thread; never blocks (drops the sample if this thread's ring is full)
+    void Record(ProfileStage stage, Clock::duration elapsed);
+
+    // Single consumer (game thread)
+    std::array<ProfileStats, kProfileStageCount> Collect();
+    uint64_t DroppedSamples();
+    void Reset();
+}
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(ProfileStage stage)
+        : mStage(stage)
+        , mActive(Profiler::IsEnabled() || Tracer::IsActive())
+    {
+        if (mActive) mStart = Profiler::Clock::now();
+    }
+
+    ~ProfileScope()
+    {
+        if (!mActive) return;
+
+        const auto end = Profiler::Clock::now();
+        if (Profiler::IsEnabled()) Profiler::Record(mStage, end - mStart);
+        if (Tracer::IsActive()) Tracer::Complete(ProfileStageName(mStage), "stage", mStart, end);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileStage mStage;
+    bool mActive;
+    Profiler::Clock::time_point mStart{};
+};
+
+#define RR_PROFILE_CONCAT_(a, b) a##b
+#define RR_PROFILE_CONCAT(a, b) RR_PROFILE_CONCAT_(a, b)
+
+#if RR_ENABLE_PROFILER
+#define RR_PROFILE_SCOPE(stage) ProfileScope RR_PROFILE_CONCAT(rrProfileScope_, __LINE__)(stage)
+#else
+#define RR_PROFILE_SCOPE(stage) ((void)0)
+#endif
@@ -0,0 +1,48 @@
+#include "redraw_scheduler.h"
+
+void RedrawScheduler::WakeAt(Clock::time_point when)
+{
+    if (when < mWakeAt) mWakeAt = when;
+}
+
+void RedrawScheduler::WakeIn(double seconds)
+{
+    if (seconds <= 0.0)
+    {
+        WakeNextFrame();
+        return;
+    }
+
+    // Far-off wake-ups (a paused marquee with no overflow) are just dropped
+    constexpr double kMaxSec = 3600.0;
+    if (seconds > kMaxSec) return;
+
+    WakeAt(mNow + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+}
+
+uint64_t RedrawScheduler::Poll(Clock::time_point now, double animationIdleSec)
+{
+    mNow = now;
+    ++mFrames;
+    WakeIn(animationIdleSec);
+
+    if (mDirty || now >= mWakeAt)
+    {
+        mDirty = false;
+        mWakeAt = Clock::time_point::max();
+        ++mGeneration;
+    }
+    return mGeneration;
+}
+
+void RedrawScheduler::BeginRedraw()
+{
+    mWakeAt = Clock::time_point::max();
+
+    // Not asked for by Poll, so the layout changed (resize, style edit). ImGui settles
+    // some of it a frame late (column offsets), so the next frame is drawn as well.
+    if (mGeneration == mDrawnGeneration) WakeNextFrame();
+    mDrawnGeneration = mGeneration;
+
+    ++mRedraws;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+// ------------------------------------------------------------
+// Dirty tracking for the overlay window.
+//
+// While playback is paused (or the pulse and marquee are off) nothing on the overlay
+// moves, and a frame can replay the previous frame's output instead of laying the
+// window out again. The scheduler decides when that is no longer true: something
+// called Invalidate() (media update, new album art), a wake-up time declared by the
+// last redraw passed (the next second of the time label), or a running animation
+// changes (AnimationTimeline: the end of a marquee pause, every frame while something
+// fades or pulses). Only what actually moves forces redraws.
+//
+// Poll() returns a generation that changes whenever a redraw is due; it is meant to
+// key the retained layer holding the window contents.
+// ------------------------------------------------------------
+
+class RedrawScheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Next frame redraws
+    void Invalidate() { mDirty = true; }
+
+    // Wake-ups, declared while drawing; the earliest one wins
+    void WakeAt(Clock::time_point when);
+    void WakeIn(double seconds);
+    void WakeNextFrame() { WakeAt(mNow); }
+
+    // Once per frame, before drawing: the generation of what should be on screen.
+    // `animationIdleSec` is when the first running animation changes (AnimationTimeline).
+    uint64_t Poll(Clock::time_point now, double animationIdleSec = std::numeric_limits<double>::infinity());
+
+    // The contents are being drawn (because of Poll or a layout change): forgets the
+    // wake-ups, which the drawing declares again
+    void BeginRedraw();
+
+    uint64_t Frames() const { return mFrames; }
+    uint64_t Redraws() const { return mRedraws; }
+    void ResetStats() { mFrames = mRedraws = 0; }
+
+private:
+    bool mDirty = true;
+    Clock::time_point mWakeAt = Clock::time_point::max();
+    Clock::time_point mNow{};
+    uint64_t mGeneration = 0;
+    uint64_t mDrawnGeneration = 0;
+
+    uint64_t mFrames = 0;
+    uint64_t mRedraws = 0;
+};
@@ -0,0 +1,160 @@
+#include "retained_draw.h"
+
+#include "IMGUI/imgui_internal.h"
+
+namespace
+{
+    // Appends every command of `src` to `dst`, moved by `delta`. One vertex block for
+    // the whole layer; each command keeps its texture and (moved) clip rect.
+    size_t AppendDrawList(ImDrawList* dst, const ImDrawList& src, ImVec2 delta)
+    {
+        const int vtxCount = src.VtxBuffer.Size;
+        if (vtxCount == 0) return 0;
+
+        bool vtxWritten = false;
+        unsigned int base = 0;
+
+        for (const ImDrawCmd& cmd : src.CmdBuffer)
+        {
+            if (cmd.ElemCount == 0 || cmd.UserCallback) continue;
+
+            dst->PushClipRect(ImVec2(cmd.ClipRect.x + delta.x, cmd.ClipRect.y + delta.y), ImVec2(cmd.ClipRect.z + delta.x, cmd.ClipRect.w + delta.y));
+            dst->PushTextureID(cmd.TextureId);
+
+            if (!vtxWritten)
+            {
+                dst->PrimReserve(static_cast<int>(cmd.ElemCount), vtxCount);
+                base = dst->_VtxCurrentIdx;   // after PrimReserve, which may start a new vertex offset
+
+                ImDrawVert* out = dst->_VtxWritePtr;
+                for (const ImDrawVert& v : src.VtxBuffer)
+                {
+                    *out = v;
+                    out->pos.x += delta.x;
+                    out->pos.y += delta.y;
+                    ++out;
+                }
+                dst->_VtxWritePtr = out;
+                dst->_VtxCurrentIdx += static_cast<unsigned int>(vtxCount);
+                vtxWritten = true;
+            }
+            else
+            {
+                dst->PrimReserve(static_cast<int>(cmd.ElemCount), 0);
+            }
+
+            const ImDrawIdx* in = src.IdxBuffer.Data + cmd.IdxOffset;
+            ImDrawIdx* out = dst->_IdxWritePtr;
+            for (unsigned int i = 0; i < cmd.ElemCount; ++i)
+                out[i] = static_cast<ImDrawIdx>(base + cmd.VtxOffset + in[i]);
+            dst->_IdxWritePtr += cmd.ElemCount;
+
+            dst->PopTextureID();
+            dst->PopClipRect();
+        }
+
+        return static_cast<size_t>(vtxCount);
+    }
+}
+
+void RetainedDrawCache::ListDeleter::operator()(ImDrawList* list) const
+{
+    IM_DELETE(list);
+}
+
+RetainedDrawCache::RetainedDrawCache() = default;
+
+RetainedDrawCache::~RetainedDrawCache() = default;
+
+void RetainedDrawCache::Clear()
+{
+    for (Layer& layer : mLayers) layer = Layer{};
+    mRecorders.clear();
+}
+
+// Between frames only: a recording in progress would lose its scratch list
+void RetainedDrawCache::SetEnabled(bool enabled)
+{
+    mEnabled = enabled;
+    Clear();
+}
+
+// Window pos is floored by ImGui, so a moved layer lands on the same pixel grid
+uint64_t RetainedDrawCache::WithLayout(uint64_t key) const
+{
+    const ImGuiWindow* window = ImGui::GetCurrentWindowRead();
+    const ImVec2 origin = window->Pos;
+    const ImVec2 cursor = window->DC.CursorPos;
+    const ImVec4 clip = window->DrawList->_ClipRectStack.back();
+    const ImFont* font = ImGui::GetFont();
+
+    return LayerKey{}
+        .Add(key)
+        .Add(window->Size)
+        .Add(ImVec2(cursor.x - origin.x, cursor.y - origin.y))
+        .Add(ImVec4(clip.x - origin.x, clip.y - origin.y, clip.z - origin.x, clip.w - origin.y))
+        .Add(font)
+        .Add(ImGui::GetFontSize())
+        .Add(font->ContainerAtlas->TexID)
+        .Add(font->Glyphs.Data)
+        .Add(ImGui::GetStyle().Alpha)
+        .Add(window->DrawList->Flags)
+        .Value();
+}
+
+bool RetainedDrawCache::Replay(RetainedLayer layer, uint64_t key)
+{
+    const Layer& l = mLayers[static_cast<size_t>(layer)];
+    if (!l.list || l.key != key) return false;
+
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    const ImVec2 delta(window->Pos.x - l.windowPos.x, window->Pos.y - l.windowPos.y);
+
+    ++mStats.replayedLayers;
+    mStats.replayedVertices += AppendDrawList(window->DrawList, *l.list, delta);
+
+    // Items laid out by the recording still count towards the window's content size
+    window->DC.CursorMaxPos = ImMax(window->DC.CursorMaxPos, ImVec2(window->Pos.x + l.contentMax.x, window->Pos.y + l.contentMax.y));
+    return true;
+}
+
+void RetainedDrawCache::BeginRecord()
+{
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    ImDrawList* windowList = window->DrawList;
+
+    const size_t depth = mWindowLists.size();
+    if (mRecorders.size() <= depth)
+        mRecorders.emplace_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+    mWindowLists.push_back(windowList);
+
+    // Same clip rect, texture and flags as the window's list at this point
+    ImDrawList& recorder = *mRecorders[depth];
+    recorder._Data = ImGui::GetDrawListSharedData();
+    recorder.Clear();
+    recorder.Flags = windowList->Flags;
+
+    const ImVec4 clip = windowList->_ClipRectStack.back();
+    recorder.PushClipRect(ImVec2(clip.x, clip.y), ImVec2(clip.z, clip.w));
+    recorder.PushTextureID(windowList->_TextureIdStack.back());
+
+    window->DrawList = &recorder;
+}
+
+void RetainedDrawCache::EndRecord(RetainedLayer layer, uint64_t key)
+{
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    window->DrawList = mWindowLists.back();
+    mWindowLists.pop_back();
+    const ImDrawList& recorder = *mRecorders[mWindowLists.size()];
+
+    // Compact copy of what was drawn; the recorder keeps its capacity for the next layer
+    Layer& l = mLayers[static_cast<size_t>(layer)];
+    l.key = key;
+    l.windowPos = window->Pos;
+    l.contentMax = ImVec2(window->DC.CursorMaxPos.x - window->Pos.x, window->DC.CursorMaxPos.y - window->Pos.y);
+    l.list.reset(recorder.CloneOutput());
+
+    ++mStats.recordedLayers;
+    mStats.recordedVertices += AppendDrawList(window->DrawList, *l.list, ImVec2(0.0f, 0.0f));
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "IMGUI/imgui.h"
+#include "track_id.h"
+
+// ------------------------------------------------------------
+// Retained draw layers.
+//
+// Most overlay frames differ only in the progress fill, the time labels and the
+// marquee offset, yet every vertex went through ImGui again. A retained layer is a
+// piece of the window's drawing (backdrop, album art, static text lines, progress
+// track) recorded once into its own ImDrawList and appended to the window's draw
+// list on later frames: a vertex copy instead of path building, tessellation and
+// glyph lookups. The layer is recorded again when its key changes.
+//
+// Keys cover what the caller draws (textures, colors, sizes); Draw() adds the
+// layout around it itself (window size, cursor and clip rect relative to the
+// window, font, font atlas). Moving the window only translates the replay.
+//
+// Only drawing goes into a layer. Layout calls (Dummy, SetCursorPos) stay outside
+// the paint callback so they run every frame. The exception is Frame, the whole
+// window contents while the overlay is idle: a replay restores the content extent
+// the recording reached, nothing else. Layers nest, so the per-element layers are
+// still used while Frame records.
+// ------------------------------------------------------------
+
+enum class RetainedLayer : uint8_t
+{
+    Backdrop,
+    AlbumArt,
+    Title,
+    Artist,
+    Album,
+    ProgressTrack,
+    Frame,   // everything inside the window, see RedrawScheduler
+
+    Count
+};
+
+// FNV-1a over the values that decide what a layer looks like
+class LayerKey
+{
+public:
+    template <typename T>
+    LayerKey& Add(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "LayerKey::Add takes plain values");
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        mHash = Fnv1a64Append(mHash, std::string_view(reinterpret_cast<const char*>(bytes), sizeof(T)));
+        return *this;
+    }
+
+    LayerKey& Add(std::string_view text)
+    {
+        mHash = Fnv1a64Append(Add(text.size()).mHash, text);
+        return *this;
+    }
+
+    uint64_t Value() const { return mHash; }
+
+private:
+    uint64_t mHash = kFnv1a64Offset;
+};
+
+struct RetainedDrawStats
+{
+    uint64_t recordedLayers = 0;
+    uint64_t recordedVertices = 0;
+    uint64_t replayedLayers = 0;
+    uint64_t replayedVertices = 0;   // vertices copied instead of generated
+};
+
+class RetainedDrawCache
+{
+public:
+    RetainedDrawCache();
+    ~RetainedDrawCache();
+
+    RetainedDrawCache(const RetainedDrawCache&) = delete;
+    RetainedDrawCache& operator=(const RetainedDrawCache&) = delete;
+
+    // Draws `layer` into the current window: a replay while `key` (plus the layout
+    // around it) matches the recording, otherwise `paint()` is recorded first.
+    // `paint` draws through ImGui::GetWindowDrawList(); layout it does is not replayed.
+    template <typename Paint>
+    void Draw(RetainedLayer layer, uint64_t key, Paint&& paint)
+    {
+        if (!mEnabled)
+        {
+            paint();
+            return;
+        }
+
+        const uint64_t fullKey = WithLayout(key);
+        if (Replay(layer, fullKey)) return;
+
+        BeginRecord();
+        paint();
+        EndRecord(layer, fullKey);
+    }
+
+    // Drops every recording (unload, or a renderer/font reset)
+    void Clear();
+
+    // Disabled, every Draw() paints directly (immediate mode, for comparisons); the
+    // recordings are dropped either way
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return mEnabled; }
+
+    const RetainedDrawStats& Stats() const { return mStats; }
+    void ResetStats() { mStats = {}; }
+
+private:
+    struct ListDeleter
+    {
+        void operator()(ImDrawList* list) const;
+    };
+
+    struct Layer
+    {
+        uint64_t key = 0;
+        ImVec2 windowPos;    // where it was recorded
+        ImVec2 contentMax;   // furthest cursor position reached, relative to windowPos
+        std::unique_ptr<ImDrawList, ListDeleter> list;
+    };
+
+    uint64_t WithLayout(uint64_t key) const;
+    bool Replay(RetainedLayer layer, uint64_t key);
+    void BeginRecord();
+    void EndRecord(RetainedLayer layer, uint64_t key);
+
+    std::array<Layer, static_cast<size_t>(RetainedLayer::Count)> mLayers;
+
+    // Scratch lists the window draws into while layers are recorded, one per nesting
+    // depth; they keep their capacity
+    std::vector<std::unique_ptr<ImDrawList, ListDeleter>> mRecorders;
+    std::vector<ImDrawList*> mWindowLists;   // what each recording swapped out
+
+    RetainedDrawStats mStats;
+    bool mEnabled = true;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+// ------------------------------------------------------------
+// Minimal test harness for the core tests: TEST() registers a case,
+// CHECK() records a failure and keeps going, REQUIRE() ends the case.
+// Every test executable links check_main.cpp, which runs all cases
+// and returns non-zero when any check failed.
+// ------------------------------------------------------------
+
+namespace check
+{
+    struct TestCase
+    {
+        const char* name;
+        void (*fn)();
+    };
+
+    std::vector<TestCase>& Registry();
+    void Fail(const char* file, int line, const char* expr);
+
+    struct Registrar
+    {
+        Registrar(const char* name, void (*fn)()) { Registry().push_back({ name, fn }); }
+    };
+
+    struct RequireFailed {};
+}
+
+#define TEST(name)                                                   \
+    static void name();                                              \
+    static const ::check::Registrar name##_registrar(#name, &name);  \
+    static void name()
+
+#define CHECK(expr)                                                  \
+    do { if (!(expr)) ::check::Fail(__FILE__, __LINE__, #expr); } while (0)
+
+#define REQUIRE(expr)                                                \
+    do {                                                             \
+        if (!(expr))                                                 \
+        {                                                            \
+            ::check::Fail(__FILE__, __LINE__, #expr);                \
+            throw ::check::RequireFailed{};                          \
+        }                                                            \
+    } while (0)
@@ -0,0 +1,47 @@
+#include "check.h"
+
+#include <exception>
+
+namespace
+{
+    int gFailures = 0;
+}
+
+std::vector<check::TestCase>& check::Registry()
+{
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+void check::Fail(const char* file, int line, const char* expr)
+{
+    ++gFailures;
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+}
+
+int main()
+{
+    int failedCases = 0;
+    for (const check::TestCase& test : check::Registry())
+    {
+        const int before = gFailures;
+        try
+        {
+            test.fn();
+        }
+        catch (const check::RequireFailed&)
+        {
+        }
+        catch (const std::exception& e)
+        {
+            check::Fail(test.name, 0, e.what());
+        }
+
+        const bool ok = gFailures == before;
+        if (!ok) ++failedCases;
+        std::printf("[%s] %s\n", ok ? "  OK  " : " FAIL ", test.name);
+    }
+
+    std::printf("%zu cases, %d failed\n", check::Registry().size(), failedCases);
+    return failedCases ? 1 : 0;
+}
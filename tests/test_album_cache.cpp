@@ -0,0 +1,193 @@
+// AlbumCache: key resolution, de-duplication, the display-size pixel copies and eviction.
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "album_cache.h"
+#include "check.h"
+#include "temp_dir.h"
+#include "track_id.h"
+
+namespace
+{
+    std::vector<uint8_t> Bytes(uint8_t seed, size_t size)
+    {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i) bytes[i] = static_cast<uint8_t>(seed + i * 7);
+        return bytes;
+    }
+
+    AlbumArtImage Pixels(int px, uint8_t seed)
+    {
+        AlbumArtImage image;
+        image.width = px;
+        image.height = px;
+        image.premultiplied = true;
+        image.opaque = true;
+        image.palette.extracted = true;
+        image.palette.usable = true;
+        image.palette.accent[0] = seed;
+        image.palette.accent2[2] = seed;
+        image.rgba = Bytes(seed, static_cast<size_t>(px) * px * 4);
+        image.backdropSize = 64;
+        image.backdrop = Bytes(static_cast<uint8_t>(seed + 1), 64 * 64 * 4);
+        return image;
+    }
+}
+
+TEST(StoreResolvesByTrackAndAlbum)
+{
+    TempDir dir;
+    AlbumCache cache;
+    REQUIRE(cache.Open(dir.Path()));
+
+    const TrackId track1 = ComputeTrackId("One", "Artist", "Album");
+    const TrackId track2 = ComputeTrackId("Two", "Artist", "Album");
+    const uint64_t album = ComputeAlbumKey("Artist", "Album");
+
+    CHECK(!cache.Resolve(track1, album));
+
+    const std::vector<uint8_t> cover = Bytes(1, 5000);
+    const ArtHash hash = cache.Store(track1, album, cover);
+    CHECK(hash == ComputeArtHash(std::string_view(reinterpret_cast<const char*>(cover.data()), cover.size())));
+
+    CHECK(cache.Resolve(track1, album) == hash);
+
+    // Another track of the album shares the blob without a download
+    CHECK(cache.Resolve(track2, album) == hash);
+    CHECK(cache.GetStats().albumHits == 1);
+
+    std::vector<uint8_t> out;
+    CHECK(cache.Read(hash, out));
+    CHECK(out == cover);
+}
+
+TEST(SameBytesAreStoredOnce)
+{
+    TempDir dir;
+    AlbumCache cache;
+    REQUIRE(cache.Open(dir.Path()));
+
+    const std::vector<uint8_t> cover = Bytes(3, 4000);
+    const ArtHash a = cache.Store(ComputeTrackId("A", "X", ""), 0, cover);
+    const ArtHash b = cache.Store(ComputeTrackId("B", "Y", ""), 0, cover);
+
+    CHECK(a == b);
+    const AlbumCacheStats stats = cache.GetStats();
+    CHECK(stats.blobs == 1);
+    CHECK(stats.dedupeHits == 1);
+    CHECK(stats.bytesSaved == cover.size());
+}
+
+TEST(PixelsRoundTripPerDisplaySize)
+{
+    TempDir dir;
+    AlbumCache cache;
+    REQUIRE(cache.Open(dir.Path()));
+
+    const ArtHash hash = cache.Store(ComputeTrackId("A", "X", ""), 0, Bytes(5, 3000));
+    const AlbumArtImage stored = Pixels(128, 9);
+    cache.StorePixels(hash, 128, stored);
+
+    AlbumArtImage out;
+    REQUIRE(cache.ReadPixels(hash, 128, out));
+    CHECK(out.width == 128);
+    CHECK(out.height == 128);
+    CHECK(out.premultiplied);
+    CHECK(out.opaque);
+    CHECK(out.rgba == stored.rgba);
+    CHECK(out.backdropSize == 64);
+    CHECK(out.backdrop == stored.backdrop);
+    CHECK(out.palette.extracted);
+    CHECK(out.palette.usable);
+    CHECK(out.palette.accent[0] == 9);
+    CHECK(out.palette.accent2[2] == 9);
+
+    // Another display size is a miss until it is stored
+    CHECK(!cache.ReadPixels(hash, 256, out));
+    CHECK(cache.GetStats().pixelBlobs == 1);
+}
+
+TEST(IndexSurvivesReopen)
+{
+    TempDir dir;
+    const TrackId track = ComputeTrackId("A", "X", "Y");
+    const uint64_t album = ComputeAlbumKey("X", "Y");
+    ArtHash hash = 0;
+    {
+        AlbumCache cache;
+        REQUIRE(cache.Open(dir.Path()));
+        hash = cache.Store(track, album, Bytes(7, 2000));
+        cache.StorePixels(hash, 128, Pixels(128, 1));
+        cache.Close();
+    }
+
+    AlbumCache cache;
+    REQUIRE(cache.Open(dir.Path()));
+    CHECK(cache.Resolve(track, album) == hash);
+
+    AlbumArtImage out;
+    CHECK(cache.ReadPixels(hash, 128, out));
+    CHECK(out.rgba == Pixels(128, 1).rgba);
+}
+
+TEST(BlobLargerThanBudgetDoesNotSpin)
+{
+    TempDir dir;
+    AlbumCache cache;
+    cache.SetBudget({ 1000, 100 });
+    REQUIRE(cache.Open(dir.Path()));
+
+    // Over budget with only the entry in use: nothing to evict, so the thread sleeps
+    const TrackId track1 = ComputeTrackId("One", "Artist", "Album 1");
+    const TrackId track2 = ComputeTrackId("Two", "Artist", "Album 2");
+    const uint64_t album1 = ComputeAlbumKey("Artist", "Album 1");
+    const uint64_t album2 = ComputeAlbumKey("Artist", "Album 2");
+    const ArtHash big1 = cache.Store(track1, album1, Bytes(1, 5000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(cache.GetStats().blobs == 1);
+    CHECK(cache.GetStats().evictionPasses <= 1);
+
+    // A second one makes the first evictable
+    const ArtHash big2 = cache.Store(track2, album2, Bytes(2, 5000));
+    for (int i = 0; i < 200 && cache.GetStats().blobs > 1; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(cache.GetStats().blobs == 1);
+    CHECK(cache.GetStats().evictionPasses <= 3);
+    CHECK(!cache.Resolve(track1, album1));
+    CHECK(cache.Resolve(track2, album2) == big2);
+    CHECK(big1 != big2);
+
+    cache.Close();
+}
+
+TEST(PackEntriesMissingFromTheIndexKeepTheirKind)
+{
+    TempDir dir;
+    ArtHash hash = 0;
+    {
+        AlbumCache cache;
+        REQUIRE(cache.Open(dir.Path()));
+        hash = cache.Store(ComputeTrackId("A", "X", "Y"), ComputeAlbumKey("X", "Y"), Bytes(3, 3000));
+        cache.StorePixels(hash, 128, Pixels(128, 2));
+        cache.Close();
+    }
+
+    // Unclean shutdown: the pack has both blobs, the index neither
+    REQUIRE(std::filesystem::remove(dir / "index.txt"));
+
+    AlbumCache cache;
+    REQUIRE(cache.Open(dir.Path()));
+    const AlbumCacheStats stats = cache.GetStats();
+    CHECK(stats.blobs == 1);
+    CHECK(stats.pixelBlobs == 1);
+
+    AlbumArtImage out;
+    CHECK(cache.ReadPixels(hash, 128, out));
+    CHECK(out.rgba == Pixels(128, 2).rgba);
+}
@@ -0,0 +1,334 @@
+// AsyncSlot / AsyncResult state machine, driven by a fake awaitable in place of WinRT,
+// for the media worker's album art and metadata fetches.
+// The fake operation runs eagerly up to its first suspension, like a WinRT coroutine, and
+// is resumed by the test as if its awaited call completed on the thread pool.
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "async_slot.h"
+#include "check.h"
+
+namespace
+{
+    // An awaited call the test completes by hand
+    struct FakeCall
+    {
+        std::coroutine_handle<> waiter;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) noexcept { waiter = h; }
+        void await_resume() const noexcept {}
+
+        bool Pending() const { return static_cast<bool>(waiter); }
+        void Complete() { std::exchange(waiter, {}).resume(); }
+    };
+
+    // The operation handle kept by the slot; Cancel() is only recorded, the body still
+    // runs to its end when its call completes (as a cancelled WinRT body unwinds)
+    struct FakeOperation
+    {
+        struct Shared
+        {
+            std::atomic<bool> cancelled{ false };
+            std::atomic<bool> finished{ false };
+        };
+
+        struct promise_type
+        {
+            std::shared_ptr<Shared> shared = std::make_shared<Shared>();
+
+            FakeOperation get_return_object() { return FakeOperation{ shared }; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() { shared->finished = true; }
+            void unhandled_exception() { shared->finished = true; }
+        };
+
+        std::shared_ptr<Shared> shared;
+
+        void Cancel() { shared->cancelled = true; }
+    };
+
+    struct Owner
+    {
+        AsyncSlot<FakeOperation> slot;
+        AsyncResult<int> result;
+        int offered = 0;
+        int dropped = 0;
+    };
+
+    // Shaped like MediaControllerGSMTC::LoadAlbumArtAsync
+    FakeOperation Load(Owner& owner, FakeCall& call, uint64_t token, int value)
+    {
+        const auto inFlight = owner.slot.Track();
+
+        co_await call;
+
+        if (owner.result.Offer(owner.slot, token, value)) ++owner.offered;
+        else ++owner.dropped;
+    }
+
+    std::shared_ptr<FakeOperation::Shared> Start(Owner& owner, FakeCall& call, int value)
+    {
+        const uint64_t token = owner.slot.Reset();
+        FakeOperation op = Load(owner, call, token, value);
+        auto shared = op.shared;
+        owner.slot.Attach(token, std::move(op));
+        return shared;
+    }
+
+    // The media worker's metadata and art fetches: a new session resets both, a new
+    // metadata fetch (track change) leaves the art alone
+    struct Metadata
+    {
+        std::string title;
+    };
+
+    struct Worker
+    {
+        Owner art;
+        AsyncSlot<FakeOperation> metadata;
+        AsyncResult<Metadata> metadataResult;
+        int metadataDropped = 0;
+
+        void AttachSession()
+        {
+            metadata.Reset();
+            art.slot.Reset();
+        }
+    };
+
+    // Shaped like MediaControllerGSMTC::FetchMetadataAsync
+    FakeOperation FetchMetadata(Worker& worker, FakeCall& call, uint64_t token, std::string title)
+    {
+        const auto inFlight = worker.metadata.Track();
+
+        co_await call;
+
+        if (!worker.metadataResult.Offer(worker.metadata, token, Metadata{ std::move(title) }))
+            ++worker.metadataDropped;
+    }
+
+    std::shared_ptr<FakeOperation::Shared> StartMetadata(Worker& worker, FakeCall& call, std::string title)
+    {
+        const uint64_t token = worker.metadata.Reset();
+        FakeOperation op = FetchMetadata(worker, call, token, std::move(title));
+        auto shared = op.shared;
+        worker.metadata.Attach(token, std::move(op));
+        return shared;
+    }
+}
+
+TEST(CurrentCompletionIsTaken)
+{
+    Owner owner;
+    FakeCall call;
+    Start(owner, call, 7);
+
+    CHECK(!owner.result.Take(owner.slot));
+    call.Complete();
+
+    const std::optional<int> taken = owner.result.Take(owner.slot);
+    REQUIRE(taken.has_value());
+    CHECK(*taken == 7);
+    CHECK(!owner.result.Take(owner.slot));
+}
+
+TEST(ResetCancelsThePreviousOperation)
+{
+    Owner owner;
+    FakeCall first, second;
+    auto a = Start(owner, first, 1);
+    auto b = Start(owner, second, 2);
+
+    CHECK(a->cancelled);
+    CHECK(!b->cancelled);
+
+    first.Complete();
+    second.Complete();
+}
+
+TEST(StaleCompletionIsDropped)
+{
+    Owner owner;
+    FakeCall first, second;
+    Start(owner, first, 1);
+    Start(owner, second, 2);
+
+    // The superseded load completes after its replacement was started
+    first.Complete();
+    CHECK(owner.dropped == 1);
+    CHECK(!owner.result.Take(owner.slot));
+
+    second.Complete();
+    const std::optional<int> taken = owner.result.Take(owner.slot);
+    REQUIRE(taken.has_value());
+    CHECK(*taken == 2);
+}
+
+TEST(StaleCompletionCannotReplaceNewerOne)
+{
+    Owner owner;
+
+    // Token 1's completion passed its check before token 2 was issued: it offers with a
+    // token that is already stale, after token 2's result was stored
+    const uint64_t stale = owner.slot.Reset();
+    const uint64_t current = owner.slot.Reset();
+
+    CHECK(owner.result.Offer(owner.slot, current, 2));
+    CHECK(!owner.result.Offer(owner.slot, stale, 1));
+
+    const std::optional<int> taken = owner.result.Take(owner.slot);
+    REQUIRE(taken.has_value());
+    CHECK(*taken == 2);
+}
+
+TEST(ResultStoredBeforeResetIsNotTaken)
+{
+    Owner owner;
+    FakeCall call;
+    Start(owner, call, 1);
+    call.Complete();
+    CHECK(owner.offered == 1);
+
+    // Track changed before the owner got to the result
+    owner.slot.Reset();
+    CHECK(!owner.result.Take(owner.slot));
+}
+
+TEST(ReleaseInvalidatesAndHandsBackTheOperation)
+{
+    Owner owner;
+    FakeCall call;
+    auto shared = Start(owner, call, 1);
+
+    std::optional<FakeOperation> op = owner.slot.Release();
+    REQUIRE(op.has_value());
+    CHECK(op->shared == shared);
+    CHECK(!owner.slot.Release());
+
+    call.Complete();
+    CHECK(owner.dropped == 1);
+}
+
+TEST(WaitIdleWaitsForSupersededOperations)
+{
+    Owner owner;
+    FakeCall first, second;
+    auto a = Start(owner, first, 1);
+    auto b = Start(owner, second, 2);
+
+    // Shutdown: only the current operation is handed back, the superseded one still runs
+    if (auto op = owner.slot.Release()) op->Cancel();
+    second.Complete();
+    CHECK(b->finished);
+    CHECK(first.Pending());
+
+    std::atomic<bool> idle{ false };
+    std::thread waiter([&] {
+        owner.slot.WaitIdle();
+        idle = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(!idle);
+
+    // Completes on another thread, as on the thread pool
+    std::thread([&] { first.Complete(); }).join();
+    waiter.join();
+
+    CHECK(idle);
+    CHECK(a->finished);
+    CHECK(owner.dropped == 2);
+}
+
+TEST(ConcurrentCompletionsKeepTheNewestCurrent)
+{
+    // Completions racing with resets never leave a stale value behind for Take
+    for (int round = 0; round < 200; ++round)
+    {
+        Owner owner;
+        const uint64_t t1 = owner.slot.Reset();
+        const uint64_t t2 = owner.slot.Reset();
+
+        std::thread late([&] { owner.result.Offer(owner.slot, t1, 1); });
+        std::thread current([&] { owner.result.Offer(owner.slot, t2, 2); });
+        late.join();
+        current.join();
+
+        const std::optional<int> taken = owner.result.Take(owner.slot);
+        REQUIRE(taken.has_value());
+        CHECK(*taken == 2);
+    }
+}
+
+TEST(StaleMetadataCompletionIsDroppedAfterSessionChange)
+{
+    Worker worker;
+    FakeCall oldSession, newSession;
+    auto a = StartMetadata(worker, oldSession, "Old");
+
+    // The session changes while the old properties call is still pending
+    worker.AttachSession();
+    CHECK(a->cancelled);
+    StartMetadata(worker, newSession, "New");
+
+    oldSession.Complete();
+    CHECK(worker.metadataDropped == 1);
+    CHECK(!worker.metadataResult.Take(worker.metadata));
+
+    newSession.Complete();
+    const std::optional<Metadata> taken = worker.metadataResult.Take(worker.metadata);
+    REQUIRE(taken.has_value());
+    CHECK(taken->title == "New");
+}
+
+TEST(MetadataCompletingAfterItsReplacementIsDropped)
+{
+    Worker worker;
+    FakeCall first, second;
+    StartMetadata(worker, first, "First");
+    StartMetadata(worker, second, "Second");
+
+    // Completions in either order leave only the newest fetch's result
+    second.Complete();
+    first.Complete();
+    CHECK(worker.metadataDropped == 1);
+
+    const std::optional<Metadata> taken = worker.metadataResult.Take(worker.metadata);
+    REQUIRE(taken.has_value());
+    CHECK(taken->title == "Second");
+}
+
+TEST(MetadataFetchLeavesArtInFlight)
+{
+    Worker worker;
+    FakeCall art, metadata;
+    auto load = Start(worker.art, art, 5);
+
+    // A track change starts a new metadata fetch; the art load of the current track goes on
+    StartMetadata(worker, metadata, "Title");
+    CHECK(!load->cancelled);
+
+    art.Complete();
+    metadata.Complete();
+    CHECK(worker.art.result.Take(worker.art.slot) == 5);
+    CHECK(worker.metadataResult.Take(worker.metadata).has_value());
+
+    // A session change drops both
+    FakeCall lateArt, lateMetadata;
+    Start(worker.art, lateArt, 6);
+    StartMetadata(worker, lateMetadata, "Late");
+    worker.AttachSession();
+    lateArt.Complete();
+    lateMetadata.Complete();
+    CHECK(!worker.art.result.Take(worker.art.slot));
+    CHECK(!worker.metadataResult.Take(worker.metadata));
+    CHECK(worker.art.dropped == 1);
+    CHECK(worker.metadataDropped == 1);
+}
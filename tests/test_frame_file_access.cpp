@@ -0,0 +1,156 @@
+// The steady-state frame does not touch the filesystem. A host frame here is what the
+// plugin runs per rendered frame on the core: the font probe (until the fonts are
+// loaded) and the overlay window, with all file access counted by CountingFileSystem.
+
+#include <chrono>
+#include <fstream>
+
+#include "check.h"
+#include "file_system.h"
+#include "font_probe.h"
+#include "null_renderer.h"
+#include "overlay_view.h"
+#include "temp_dir.h"
+#include "window_style.h"
+
+namespace
+{
+    struct Host
+    {
+        explicit Host(const TempDir& dir)
+            : counting(DefaultFileSystem())
+            , probe(dir / "fonts", "segoeui.ttf")
+            , overlay(style)
+        {
+            probe.SetFileSystem(counting);
+
+            MediaState state{};
+            state.title = "Title";
+            state.artist = "Artist";
+            state.isPlaying = true;
+            state.durationSec = 180;
+            state.durationTicks = 180 * kTicksPerSecond;
+            overlay.SetMediaState(state);
+        }
+
+        // Returns the filesystem calls the frame made
+        uint64_t Frame(double sec)
+        {
+            const auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(sec));
+            const OverlayView::Clock::time_point now(offset);
+            const uint64_t before = counting.Calls();
+
+            renderer.BeginFrame(1.0f / 60.0f);
+            if (!fontsLoaded)
+            {
+                const FontProbeResult result = probe.Poll(now);
+                if (result.startDownload) download = result.startDownload;
+                fontsLoaded = result.present;
+            }
+            overlay.BeginFrame(static_cast<uint64_t>(frames++), now,
+                std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(offset)));
+            overlay.Draw(OverlayArt{});
+            renderer.EndFrame();
+
+            return counting.Calls() - before;
+        }
+
+        NullRenderer renderer;
+        CountingFileSystem counting;
+        FontFileProbe probe;
+        WindowStyle style{};
+        OverlayView overlay;
+
+        FontDownloadFlag download;
+        bool fontsLoaded = false;
+        int frames = 0;
+    };
+
+    void WriteFile(const std::filesystem::path& path)
+    {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << "font";
+    }
+}
+
+TEST(FontPresentProbesOnce)
+{
+    TempDir dir;
+    WriteFile(dir / "fonts" / "segoeui.ttf");
+    Host host(dir);
+
+    // Directory + exists, once
+    CHECK(host.Frame(0.0) == 2);
+    CHECK(host.fontsLoaded);
+    CHECK(!host.download);
+
+    for (int i = 1; i < 600; ++i) CHECK(host.Frame(i / 60.0) == 0);
+}
+
+TEST(MissingFontPollsTheDownload)
+{
+    TempDir dir;
+    Host host(dir);
+
+    CHECK(host.Frame(0.0) == 2);
+    CHECK(!host.fontsLoaded);
+    REQUIRE(host.download != nullptr);
+    CHECK(host.download->load() == FontDownload::InFlight);
+
+    // Still downloading: nothing touches the disk
+    for (int i = 1; i < 120; ++i) CHECK(host.Frame(i / 60.0) == 0);
+
+    // The download thread finishes; the next frame takes its word for it
+    WriteFile(host.probe.FilePath());
+    host.download->store(FontDownload::Done);
+    CHECK(host.Frame(2.0) == 0);
+    CHECK(host.fontsLoaded);
+
+    for (int i = 121; i < 600; ++i) CHECK(host.Frame(i / 60.0) == 0);
+}
+
+TEST(FailedDownloadIsRetriedAfterTheDelay)
+{
+    TempDir dir;
+    Host host(dir);
+
+    CHECK(host.Frame(0.0) == 2);
+    REQUIRE(host.download != nullptr);
+    host.download->store(FontDownload::Failed);
+    host.download.reset();
+
+    // No probing (and no new download) until the retry delay passed
+    const double retrySec = std::chrono::duration<double>(FontFileProbe::kRetryDelay).count();
+    uint64_t calls = 0;
+    for (double t = 1.0 / 60.0; t < retrySec; t += 1.0 / 60.0) calls += host.Frame(t);
+    CHECK(calls == 0);
+    CHECK(!host.download);
+
+    CHECK(host.Frame(retrySec) == 2);
+    CHECK(host.download != nullptr);
+    CHECK(!host.fontsLoaded);
+}
+
+TEST(OverlayFramesNeverTouchTheDisk)
+{
+    TempDir dir;
+    WriteFile(dir / "fonts" / "segoeui.ttf");
+    Host host(dir);
+    host.Frame(0.0);
+
+    // Track changes, style edits and metric recomputes included
+    uint64_t calls = 0;
+    for (int i = 1; i < 300; ++i)
+    {
+        if (i % 100 == 0)
+        {
+            MediaState state = host.overlay.GetMediaState();
+            state.title += " (next)";
+            host.overlay.SetMediaState(state);
+            host.style.windowOpacity = 0.5f + 0.1f * static_cast<float>(i / 100);
+            host.overlay.InvalidateLayoutMetrics();
+        }
+        calls += host.Frame(i / 60.0);
+    }
+    CHECK(calls == 0);
+}
@@ -0,0 +1,248 @@
+// Every SIMD path of the image kernels produces the scalar reference's bytes, on odd
+// sizes and lane tails included, plus a few properties of the reference itself.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "image_kernels.h"
+
+using namespace ImageKernels;
+
+namespace
+{
+    struct Size
+    {
+        int w;
+        int h;
+    };
+
+    std::vector<uint8_t> Random(size_t bytes, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<uint8_t> v(bytes);
+        for (uint8_t& b : v) b = static_cast<uint8_t>(rng());
+        return v;
+    }
+
+    // Random colors, a third of the pixels opaque (covers are mostly opaque)
+    std::vector<uint8_t> RandomImage(int w, int h, uint32_t seed)
+    {
+        std::vector<uint8_t> rgba = Random(static_cast<size_t>(w) * h * 4, seed);
+        for (size_t i = 0; i < rgba.size() / 4; i += 3) rgba[i * 4 + 3] = 255;
+        return rgba;
+    }
+
+    // The SIMD paths this CPU has, each compared against Scalar
+    std::vector<Isa> SimdPaths()
+    {
+        std::vector<Isa> paths;
+        if (DetectIsa() >= Isa::Sse2) paths.push_back(Isa::Sse2);
+        if (DetectIsa() >= Isa::Avx2) paths.push_back(Isa::Avx2);
+        return paths;
+    }
+
+    // Restores the detected path when a case ends
+    struct IsaGuard
+    {
+        ~IsaGuard() { SetIsa(DetectIsa()); }
+    };
+
+    std::vector<uint8_t> Resample(Isa isa, const std::vector<uint8_t>& src, Size s, Size d)
+    {
+        SetIsa(isa);
+        std::vector<uint8_t> dst(static_cast<size_t>(d.w) * d.h * 4);
+        ResampleToPremultiplied(src.data(), s.w, s.h, dst.data(), d.w, d.h);
+        return dst;
+    }
+}
+
+TEST(ResampleMatchesScalar)
+{
+    IsaGuard guard;
+    const struct { Size src; Size dst; } cases[] = {
+        { { 640, 640 }, { 128, 128 } },
+        { { 1000, 1000 }, { 192, 192 } },
+        { { 1400, 1400 }, { 256, 256 } },
+        { { 300, 300 }, { 160, 160 } },
+        { { 1200, 800 }, { 256, 256 } },
+        { { 97, 61 }, { 33, 17 } },
+        { { 7, 5 }, { 3, 2 } },
+        { { 160, 160 }, { 160, 160 } },
+        { { 50, 50 }, { 160, 160 } },     // upscale
+        { { 640, 640 }, { 64, 64 } },     // backdrop
+    };
+
+    uint32_t seed = 1;
+    for (const auto& c : cases)
+    {
+        const std::vector<uint8_t> src = RandomImage(c.src.w, c.src.h, seed++);
+        const std::vector<uint8_t> reference = Resample(Isa::Scalar, src, c.src, c.dst);
+        for (Isa isa : SimdPaths())
+        {
+            if (Resample(isa, src, c.src, c.dst) != reference)
+            {
+                std::fprintf(stderr, "  %s %dx%d -> %dx%d\n", IsaName(isa), c.src.w, c.src.h, c.dst.w, c.dst.h);
+                CHECK(false);
+            }
+        }
+    }
+}
+
+TEST(ResampleKeepsFlatColor)
+{
+    IsaGuard guard;
+    std::vector<uint8_t> src(300 * 300 * 4);
+    for (size_t i = 0; i < src.size(); i += 4)
+    {
+        src[i] = 128;
+        src[i + 1] = 10;
+        src[i + 2] = 250;
+        src[i + 3] = 255;
+    }
+
+    const std::vector<uint8_t> dst = Resample(DetectIsa(), src, { 300, 300 }, { 160, 160 });
+    bool flat = true;
+    for (size_t i = 0; i < dst.size(); i += 4)
+        flat = flat && dst[i] == 128 && dst[i + 1] == 10 && dst[i + 2] == 250 && dst[i + 3] == 255;
+    CHECK(flat);
+}
+
+TEST(PremultiplyMatchesScalar)
+{
+    IsaGuard guard;
+    for (size_t n : { 1u, 3u, 4u, 5u, 8u, 13u, 31u, 1000u, 128u * 128u })
+    {
+        const std::vector<uint8_t> src = Random(n * 4, static_cast<uint32_t>(n));
+
+        std::vector<uint8_t> reference = src;
+        SetIsa(Isa::Scalar);
+        PremultiplyRgba8(reference.data(), n);
+
+        for (Isa isa : SimdPaths())
+        {
+            std::vector<uint8_t> out = src;
+            SetIsa(isa);
+            PremultiplyRgba8(out.data(), n);
+            CHECK(out == reference);
+        }
+    }
+}
+
+TEST(PremultiplyIsRounded)
+{
+    IsaGuard guard;
+    SetIsa(Isa::Scalar);
+    uint8_t px[8] = { 255, 128, 1, 255, 200, 100, 3, 128 };
+    PremultiplyRgba8(px, 2);
+
+    CHECK(px[0] == 255 && px[1] == 128 && px[2] == 1 && px[3] == 255);
+    CHECK(px[4] == 100 && px[5] == 50 && px[6] == 2 && px[7] == 128);
+}
+
+TEST(RoundedCornersMatchScalar)
+{
+    IsaGuard guard;
+    const struct { int size; float radius; } cases[] = { { 160, 19.3f }, { 161, 12.0f }, { 33, 100.0f }, { 128, 0.5f }, { 256, 30.0f } };
+
+    for (const auto& c : cases)
+    {
+        const std::vector<uint8_t> src = RandomImage(c.size, c.size, static_cast<uint32_t>(c.size));
+
+        std::vector<uint8_t> reference = src;
+        SetIsa(Isa::Scalar);
+        ApplyRoundedCorners(reference.data(), c.size, c.size, c.radius);
+
+        for (Isa isa : SimdPaths())
+        {
+            std::vector<uint8_t> out = src;
+            SetIsa(isa);
+            ApplyRoundedCorners(out.data(), c.size, c.size, c.radius);
+            CHECK(out == reference);
+        }
+    }
+}
+
+TEST(RoundedCornersOnlyTouchTheCorners)
+{
+    IsaGuard guard;
+    const int w = 64;
+    std::vector<uint8_t> px(static_cast<size_t>(w) * w * 4, 255);
+    ApplyRoundedCorners(px.data(), w, w, 16.0f);
+
+    auto alpha = [&](int x, int y) { return px[(static_cast<size_t>(y) * w + x) * 4 + 3]; };
+    CHECK(alpha(0, 0) == 0);
+    CHECK(alpha(w - 1, w - 1) == 0);
+    CHECK(alpha(w / 2, w / 2) == 255);
+    CHECK(alpha(w / 2, 0) == 255);
+    CHECK(alpha(0, w / 2) == 255);
+    CHECK(px[0] == 255);   // color is left alone
+}
+
+TEST(HistogramMatchesScalar)
+{
+    IsaGuard guard;
+    for (size_t n : { 1u, 7u, 16u, 33u, 4096u, 160u * 160u + 3u })
+    {
+        const std::vector<uint8_t> src = Random(n * 4, static_cast<uint32_t>(n) + 99);
+
+        std::vector<uint32_t> reference(kHistogramBins + 1, 0);
+        SetIsa(Isa::Scalar);
+        ColorHistogram(src.data(), n, reference.data());
+
+        uint64_t total = 0;
+        for (uint32_t count : reference) total += count;
+        CHECK(total == n);
+
+        for (Isa isa : SimdPaths())
+        {
+            std::vector<uint32_t> bins(kHistogramBins + 1, 0);
+            SetIsa(isa);
+            ColorHistogram(src.data(), n, bins.data());
+            CHECK(bins == reference);
+        }
+    }
+}
+
+TEST(BoxBlurMatchesScalar)
+{
+    IsaGuard guard;
+    const struct { Size size; int radius; int passes; } cases[] = {
+        { { 64, 64 }, 6, 3 },        // backdrop
+        { { 65, 37 }, 3, 1 },
+        { { 5, 9 }, 4, 2 },          // radius larger than the image
+        { { 128, 96 }, kMaxBlurRadius, 1 },
+        { { 17, 17 }, 0, 2 },
+    };
+
+    for (const auto& c : cases)
+    {
+        const std::vector<uint8_t> src = RandomImage(c.size.w, c.size.h, static_cast<uint32_t>(c.size.w * 31 + c.radius));
+
+        std::vector<uint8_t> reference = src;
+        SetIsa(Isa::Scalar);
+        BoxBlurRgba8(reference.data(), c.size.w, c.size.h, c.radius, c.passes);
+
+        for (Isa isa : SimdPaths())
+        {
+            std::vector<uint8_t> out = src;
+            SetIsa(isa);
+            BoxBlurRgba8(out.data(), c.size.w, c.size.h, c.radius, c.passes);
+            if (out != reference)
+            {
+                std::fprintf(stderr, "  %s %dx%d r%d x%d\n", IsaName(isa), c.size.w, c.size.h, c.radius, c.passes);
+                CHECK(false);
+            }
+        }
+    }
+}
+
+TEST(SetIsaIsClampedToTheCpu)
+{
+    IsaGuard guard;
+    SetIsa(Isa::Avx2);
+    CHECK(ActiveIsa() <= DetectIsa());
+    SetIsa(Isa::Scalar);
+    CHECK(ActiveIsa() == Isa::Scalar);
+}
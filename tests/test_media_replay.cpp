@@ -0,0 +1,217 @@
+// Media recordings: the .rrmr format round trip, the replay pipeline's refresh
+// counts and latencies, and the scheduler's handling of worker completions.
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "media_recording.h"
+#include "media_replay.h"
+#include "media_scheduler.h"
+#include "track_id.h"
+
+using std::chrono::milliseconds;
+
+namespace
+{
+    MediaRecord Event(int64_t ms, RefreshReason reason)
+    {
+        MediaRecord r;
+        r.kind = MediaRecord::Kind::Event;
+        r.atNs = ms * 1'000'000;
+        r.reasons = static_cast<uint32_t>(reason);
+        return r;
+    }
+
+    MediaRecord Completion(int64_t ms, RefreshReason reason)
+    {
+        MediaRecord r = Event(ms, reason);
+        r.kind = MediaRecord::Kind::Completion;
+        return r;
+    }
+
+    MediaRecord State(int64_t ms, const char* title, int positionSec)
+    {
+        MediaRecord r;
+        r.kind = MediaRecord::Kind::State;
+        r.atNs = ms * 1'000'000;
+        r.state.title = title;
+        r.state.artist = "Artist";
+        r.state.trackId = ComputeTrackId(title, "Artist", "");
+        r.state.positionSec = positionSec;
+        r.state.isPlaying = true;
+        return r;
+    }
+
+    // Initial load, a burst of 20 timeline events 5 ms apart, then a track change
+    std::vector<MediaRecord> Session()
+    {
+        std::vector<MediaRecord> records;
+        records.push_back(Event(0, RefreshReason::Initial));
+        records.push_back(State(40, "A", 0));
+        for (int i = 0; i < 20; ++i) records.push_back(Event(1000 + i * 5, RefreshReason::TimelineChanged));
+        records.push_back(State(1135, "A", 1));
+        records.push_back(Event(3000, RefreshReason::MediaChanged));
+        records.push_back(State(3040, "B", 0));
+        return records;
+    }
+
+    std::string Serialize(const std::vector<MediaRecord>& records)
+    {
+        std::ostringstream out(std::ios::binary);
+        WriteMediaRecordingHeader(out);
+        for (const MediaRecord& r : records) WriteMediaRecord(out, r);
+        return out.str();
+    }
+}
+
+TEST(RecordingRoundTrips)
+{
+    std::vector<MediaRecord> records = Session();
+    records.push_back(Completion(3100, RefreshReason::AlbumArtReady));
+    std::istringstream in(Serialize(records), std::ios::binary);
+
+    std::vector<MediaRecord> back;
+    REQUIRE(ReadMediaRecording(in, back));
+    REQUIRE(back.size() == records.size());
+    for (size_t i = 0; i < back.size(); ++i)
+    {
+        CHECK(back[i].kind == records[i].kind);
+        CHECK(back[i].atNs == records[i].atNs);
+        CHECK(back[i].reasons == records[i].reasons);
+        CHECK(back[i].state.title == records[i].state.title);
+        CHECK(back[i].state.trackId == records[i].state.trackId);
+        CHECK(back[i].state.positionSec == records[i].state.positionSec);
+    }
+}
+
+TEST(TruncatedTailIsIgnored)
+{
+    const std::vector<MediaRecord> records = Session();
+    std::string bytes = Serialize(records);
+    bytes.resize(bytes.size() - 3);
+
+    std::istringstream in(bytes, std::ios::binary);
+    std::vector<MediaRecord> back;
+    CHECK(ReadMediaRecording(in, back));
+    CHECK(back.size() == records.size() - 1);
+}
+
+TEST(ForeignStreamIsRejected)
+{
+    std::istringstream in(std::string("RIFF\x01\0\0\0", 8), std::ios::binary);
+    std::vector<MediaRecord> back;
+    CHECK(!ReadMediaRecording(in, back));
+}
+
+TEST(ReplayCoalescesBursts)
+{
+    const MediaReplayStats s = SimulateMediaReplay(Session(), milliseconds(40), milliseconds(150));
+
+    CHECK(s.events == 22);
+
+    // Initial, the timeline burst (one batch), the track change
+    CHECK(s.batches == 3);
+    CHECK(s.fullRefreshes == 2);
+    CHECK(s.timelineRefreshes == 1);
+    CHECK(s.publishes == 3);
+    CHECK(s.latencyMaxMs <= 150.0);
+}
+
+TEST(ReplayWithoutDebounceRefreshesEveryEvent)
+{
+    const MediaReplayStats s = SimulateMediaReplay(Session(), milliseconds(0), milliseconds(0));
+
+    CHECK(s.events == 22);
+    CHECK(s.batches == 22);
+    CHECK(s.latencyMaxMs == 0.0);
+
+    // A refresh reads the latest state recorded at or before its release. Released right
+    // away, each one comes before the state recorded for it (40 ms later in the original
+    // run): "A" at 0 is read by the burst, "A" at 1 s by the track change, and "B" never
+    CHECK(s.publishes == 2);
+}
+
+TEST(LiveReplayEndsInTheLastState)
+{
+    // Ten times faster than recorded: about a third of a second
+    ReplayMediaController controller(Session(), 10.0);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!controller.Finished() && std::chrono::steady_clock::now() < deadline)
+    {
+        controller.Update();
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    REQUIRE(controller.Finished());
+    controller.Update();
+
+    CHECK(controller.GetState().title == "B");
+    CHECK(controller.GetReplayStats().events == 22);
+}
+
+TEST(CompletionsAreNotEventsAndSkipTheSettleWindow)
+{
+    // Art for "A" arrives 10 ms after a timeline event, inside its settle window
+    std::vector<MediaRecord> records;
+    records.push_back(State(0, "A", 0));
+    records.push_back(Event(1000, RefreshReason::TimelineChanged));
+    MediaRecord art = State(1010, "A", 1);
+    art.state.hasAlbumArt = true;
+    records.push_back(art);
+    records.push_back(Completion(1010, RefreshReason::AlbumArtReady));
+
+    const MediaReplayStats s = SimulateMediaReplay(records, milliseconds(40), milliseconds(150));
+    CHECK(s.events == 1);
+    CHECK(s.completions == 1);
+
+    // The completion takes the pending timeline event with it at 1010 ms, not 1040 ms
+    CHECK(s.batches == 1);
+    CHECK(s.publishes == 1);
+    CHECK(s.latencyMaxMs == 10.0);
+}
+
+TEST(SchedulerReleasesCompletionsAtOnce)
+{
+    RefreshScheduler scheduler;
+    scheduler.SetWindows(milliseconds(10'000), milliseconds(10'000));
+
+    scheduler.Post(static_cast<uint32_t>(RefreshReason::TimelineChanged));
+    std::thread completer([&] {
+        std::this_thread::sleep_for(milliseconds(20));
+        scheduler.Complete(static_cast<uint32_t>(RefreshReason::AlbumArtReady));
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    const uint32_t reasons = scheduler.WaitBatch();
+    completer.join();
+
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+    CHECK(reasons == (static_cast<uint32_t>(RefreshReason::TimelineChanged) | static_cast<uint32_t>(RefreshReason::AlbumArtReady)));
+    CHECK(scheduler.EventCount() == 1);
+    CHECK(scheduler.CompletionCount() == 1);
+    CHECK(scheduler.BatchCount() == 1);
+}
+
+TEST(MetadataCompletionPublishesTheFetchedTrack)
+{
+    // A track change whose properties call comes back 100 ms after the event
+    std::vector<MediaRecord> records;
+    records.push_back(State(0, "A", 0));
+    records.push_back(Event(0, RefreshReason::Initial));
+    records.push_back(Event(1000, RefreshReason::MediaChanged));
+    records.push_back(State(1100, "B", 0));
+    records.push_back(Completion(1100, RefreshReason::MetadataReady));
+
+    const MediaReplayStats s = SimulateMediaReplay(records, milliseconds(40), milliseconds(150));
+    CHECK(s.events == 2);
+    CHECK(s.completions == 1);
+    CHECK(s.fullRefreshes == 2);
+    CHECK(s.batches == 3);
+
+    // "A" on the initial refresh; the track change only shows once its metadata arrived
+    CHECK(s.publishes == 2);
+}
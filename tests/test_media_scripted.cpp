@@ -0,0 +1,87 @@
+// ScriptedMediaController: script parsing and deterministic (manual time) stepping.
+
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+#include "check.h"
+#include "media_scripted.h"
+
+namespace
+{
+    const char* kScript =
+        "# comment\n"
+        "0\ttrack\tTitle\tArtist\tAlbum\t200\n"
+        "10\tpause\n"
+        "12\tplay\n"
+        "20\tseek\t150\n"
+        "30\tstop\n";
+
+    std::vector<ScriptedMediaEvent> Parse(const char* script)
+    {
+        std::istringstream in(script);
+        return ScriptedMediaController::ParseScript(in);
+    }
+
+    std::chrono::system_clock::time_point ScriptTime(double sec)
+    {
+        return std::chrono::system_clock::time_point{} +
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(sec));
+    }
+}
+
+TEST(ParsesEventsAndSkipsBadLines)
+{
+    const auto events = Parse("0\ttrack\tT\tA\tB\t100\textra\n"
+                              "x\tplay\n"
+                              "1\ttrack\tmissing duration\n"
+                              "2\tseek\t30\n"
+                              "3\tdance\n");
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].type == ScriptedMediaEvent::Type::Track);
+    CHECK(events[0].title == "T");
+    CHECK(events[0].durationSec == 100);
+    CHECK(events[1].type == ScriptedMediaEvent::Type::Seek);
+    CHECK(events[1].positionSec == 30);
+}
+
+TEST(AdvanceToFollowsTheScript)
+{
+    ScriptedMediaController media(Parse(kScript));
+
+    CHECK(media.AdvanceTo(0.0));
+    CHECK(media.GetState().isPlaying);
+    CHECK(media.GetState().title == "Title");
+    CHECK(!media.GetState().hasAlbumArt);
+
+    CHECK(media.AdvanceTo(5.0));
+    CHECK(media.GetState().positionSec == 5);
+
+    // Paused from 10 to 12: the position holds
+    media.AdvanceTo(11.0);
+    CHECK(!media.GetState().isPlaying);
+    CHECK(media.GetState().positionSec == 10);
+    media.AdvanceTo(15.0);
+    CHECK(media.GetState().positionSec == 13);
+
+    media.AdvanceTo(20.0);
+    CHECK(media.GetState().positionSec == 150);
+
+    media.AdvanceTo(30.0);
+    CHECK(media.GetState().title.empty());
+    CHECK(media.Finished());
+}
+
+TEST(ManualTimeAnchorsPositionsOnAFixedEpoch)
+{
+    ScriptedMediaController first(Parse(kScript));
+    first.AdvanceTo(21.0);
+
+    // Positions are anchored at script time on the system_clock epoch, not at construction
+    CHECK(first.GetState().positionUpdatedAt == ScriptTime(20.0));
+    CHECK(first.GetState().positionTicks == 150 * kTicksPerSecond);
+
+    ScriptedMediaController second(Parse(kScript));
+    second.AdvanceTo(21.0);
+    CHECK(first.GetState() == second.GetState());
+}
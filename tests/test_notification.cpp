@@ -0,0 +1,95 @@
+// Toast formatting, phases and the render loop on the null renderer.
+
+#include <chrono>
+#include <cmath>
+#include <string>
+
+#include "check.h"
+#include "notification.h"
+#include "null_renderer.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    void ClearToasts()
+    {
+        std::scoped_lock lock(ImGui::g_notification_mutex);
+        ImGui::notifications.clear();
+    }
+}
+
+TEST(FormatFillsPlaceholdersInOrder)
+{
+    CHECK(format_notification("{}: Config Saved!", { "RocketRhythm" }) == "RocketRhythm: Config Saved!");
+    CHECK(format_notification("{} of {}", { "1", "2" }) == "1 of 2");
+    CHECK(format_notification("no args", {}) == "no args");
+    CHECK(format_notification("{{literal}} {}", { "x" }) == "{literal} x");
+
+    // Missing arguments leave nothing behind, extra ones are ignored
+    CHECK(format_notification("a{}b{}c", { "1" }) == "a1bc");
+    CHECK(format_notification("{}", { "1", "2" }) == "1");
+}
+
+TEST(ToastFormatsItsArguments)
+{
+    const std::string path = "C:/cfg.json.tmp";
+    const ImGuiToast toast(Error, 1000.f, "write failed: {} ({} bytes, {})", path, 42, 0.5);
+    CHECK(toast.content == "write failed: C:/cfg.json.tmp (42 bytes, 0.5)");
+    CHECK(toast.dismiss_time == 1000.f);
+}
+
+TEST(ToastPhasesFollowItsAge)
+{
+    ImGuiToast toast(Info, 1000.f, "x");
+    const auto t0 = toast.creation_time;
+
+    CHECK(toast.get_phase(t0) == NotifyPhase::FadeIn);
+    CHECK(toast.get_phase(t0 - 1s) == NotifyPhase::FadeIn);
+    CHECK(toast.get_phase(t0 + 500ms) == NotifyPhase::Wait);
+    CHECK(toast.get_phase(t0 + 1300ms) == NotifyPhase::FadeOut);
+    CHECK(toast.get_phase(t0 + 1400ms) == NotifyPhase::Expired);
+
+    CHECK(toast.get_opacity(t0) == 0.f);
+    CHECK(std::fabs(toast.get_opacity(t0 + 100ms) - NOTIFY_OPACITY * 0.5f) < 1e-4f);
+    CHECK(toast.get_opacity(t0 + 500ms) == NOTIFY_OPACITY);
+
+    toast.repeats = 1;
+    CHECK(toast.get_phase(t0 + 100ms) == NotifyPhase::Flash);
+}
+
+TEST(RepeatedToastIsMerged)
+{
+    ClearToasts();
+
+    notify(Info, "{}: Config Saved!", "RR");
+    notify(Info, "{}: Config Saved!", "RR");
+    notify(Warning, std::chrono::milliseconds(500), "other");
+
+    std::scoped_lock lock(ImGui::g_notification_mutex);
+    REQUIRE(ImGui::notifications.size() == 2);
+    CHECK(ImGui::notifications[0].repeats == 1);
+    CHECK(ImGui::notifications[1].dismiss_time == 500.f);
+}
+
+TEST(RenderDropsExpiredToasts)
+{
+    ClearToasts();
+    NullRenderer renderer;
+
+    notify(Success, 1000.f, "a");
+    notify(Error, 3000.f, "b");
+    const auto start = NotifyClock::now();
+
+    renderer.BeginFrame(1.0f / 60.0f);
+    CHECK(ImGui::render_notifications(start + 500ms) == 2);
+    CHECK(renderer.EndFrame().drawLists >= 1);
+
+    renderer.BeginFrame(1.0f / 60.0f);
+    CHECK(ImGui::render_notifications(start + 2s) == 1);
+    renderer.EndFrame();
+
+    renderer.BeginFrame(1.0f / 60.0f);
+    CHECK(ImGui::render_notifications(start + 10s) == 0);
+    renderer.EndFrame();
+}
@@ -0,0 +1,159 @@
+// OverlayView on the null renderer: frames build, layout metrics are cached and idle
+// frames replay the recorded contents, which match what immediate mode paints.
+
+#include <chrono>
+#include <vector>
+
+#include "check.h"
+#include "null_renderer.h"
+#include "overlay_view.h"
+#include "window_style.h"
+
+namespace
+{
+    MediaState Playing(const char* title)
+    {
+        MediaState state{};
+        state.title = title;
+        state.artist = "Artist";
+        state.album = "Album";
+        state.isPlaying = true;
+        state.durationSec = 200;
+        state.durationTicks = 200 * kTicksPerSecond;
+        state.trackId = ComputeTrackId(state.title, state.artist, state.album);
+        return state;
+    }
+
+    // One host frame at `sec` on both clocks
+    const NullFrameStats& Frame(NullRenderer& renderer, OverlayView& overlay, const OverlayArt& art, int index, double sec)
+    {
+        const auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(sec));
+        renderer.BeginFrame(1.0f / 60.0f);
+        overlay.BeginFrame(static_cast<uint64_t>(index), OverlayView::Clock::time_point(offset),
+            std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(offset)));
+        overlay.Draw(art);
+        return renderer.EndFrame();
+    }
+}
+
+TEST(DrawsNoMusicAndMusicStates)
+{
+    NullRenderer renderer;
+    WindowStyle style{};
+    OverlayView overlay(style);
+    OverlayArt art{};
+
+    // A new window is hidden for its first (auto-fit) frame
+    CHECK(!overlay.HasMusic());
+    Frame(renderer, overlay, art, 0, 0.0);
+    const int idleVertices = Frame(renderer, overlay, art, 1, 1.0 / 60.0).vertices;
+    CHECK(idleVertices > 0);
+
+    overlay.SetMediaState(Playing("Title"));
+    CHECK(overlay.HasMusic());
+    const int musicVertices = Frame(renderer, overlay, art, 2, 2.0 / 60.0).vertices;
+    CHECK(musicVertices > idleVertices);
+}
+
+TEST(AlbumArtRequestFollowsScale)
+{
+    NullRenderer renderer;
+    WindowStyle style{};
+    style.showAlbumArt = true;
+    OverlayView overlay(style);
+    OverlayArt art{};
+    art.current.image = NullRenderer::FakeTexture(2);
+
+    CHECK(overlay.AlbumArtRequestPx() == 0);
+    overlay.SetMediaState(Playing("Title"));
+    Frame(renderer, overlay, art, 0, 0.0);
+
+    const int px = overlay.AlbumArtRequestPx();
+    CHECK(px > 0);
+    CHECK(px % 32 == 0);
+}
+
+TEST(LayoutMetricsCachedUntilDisplayChanges)
+{
+    NullRenderer renderer;
+    WindowStyle style{};
+    OverlayView overlay(style);
+    overlay.SetMediaState(Playing("Title"));
+
+    int dpiQueries = 0;
+    overlay.SetDpiScaleSource([&] { ++dpiQueries; return 1.0f; });
+
+    for (int i = 0; i < 30; ++i) Frame(renderer, overlay, OverlayArt{}, i, i / 60.0);
+    CHECK(overlay.MetricsComputes() == 1);
+
+    renderer.SetDisplaySize(ImVec2(2560.0f, 1440.0f));
+    Frame(renderer, overlay, OverlayArt{}, 30, 30 / 60.0);
+    CHECK(overlay.MetricsComputes() == 2);
+
+    overlay.InvalidateLayoutMetrics();
+    Frame(renderer, overlay, OverlayArt{}, 31, 31 / 60.0);
+    CHECK(overlay.MetricsComputes() == 3);
+    CHECK(dpiQueries == (style.enableAutoScaling ? 3 : 0));
+}
+
+TEST(IdleFramesReplayContents)
+{
+    NullRenderer renderer;
+    WindowStyle style{};
+    style.enablePulse = false;
+    OverlayView overlay(style);
+
+    MediaState paused = Playing("Title");
+    paused.isPlaying = false;
+    overlay.SetMediaState(paused);
+
+    // Settle the first frames (window auto-fit), then nothing changes
+    for (int i = 0; i < 10; ++i) Frame(renderer, overlay, OverlayArt{}, i, i / 60.0);
+    overlay.Layers().ResetStats();
+
+    const int vertices = Frame(renderer, overlay, OverlayArt{}, 10, 10 / 60.0).vertices;
+    for (int i = 11; i < 40; ++i)
+    {
+        CHECK(Frame(renderer, overlay, OverlayArt{}, i, i / 60.0).vertices == vertices);
+    }
+
+    const RetainedDrawStats& stats = overlay.Layers().Stats();
+    CHECK(stats.recordedLayers == 0);
+    CHECK(stats.replayedLayers >= 30);
+}
+
+TEST(ImmediateModeDrawsTheSameFrames)
+{
+    WindowStyle style{};
+    OverlayArt art{};
+    art.current.image = NullRenderer::FakeTexture(2);
+
+    // The same frames on two hosts, one after the other (each owns the current ImGui context)
+    const auto run = [&](bool retained, RetainedDrawStats& stats) {
+        NullRenderer renderer;
+        OverlayView overlay(style);
+        overlay.Layers().SetEnabled(retained);
+        CHECK(overlay.Layers().IsEnabled() == retained);
+
+        std::vector<int> vertices;
+        overlay.SetMediaState(Playing("Title"));
+        for (int i = 0; i < 120; ++i)
+        {
+            if (i == 60) overlay.SetMediaState(Playing("Another Title"));
+            vertices.push_back(Frame(renderer, overlay, art, i, i / 60.0).vertices);
+        }
+        stats = overlay.Layers().Stats();
+        return vertices;
+    };
+
+    RetainedDrawStats retainedStats;
+    RetainedDrawStats immediateStats;
+    const std::vector<int> retained = run(true, retainedStats);
+    const std::vector<int> immediate = run(false, immediateStats);
+
+    // Replays emit what painting again would
+    CHECK(retained == immediate);
+    CHECK(retainedStats.replayedLayers > 0);
+    CHECK(immediateStats.recordedLayers == 0);
+    CHECK(immediateStats.replayedLayers == 0);
+}
@@ -0,0 +1,79 @@
+// Tracer: captures start and stop while other threads record, and every written file
+// holds exactly the events the capture reported.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "check.h"
+#include "temp_dir.h"
+#include "trace_writer.h"
+
+namespace
+{
+    size_t CountEvents(const std::filesystem::path& path)
+    {
+        std::ifstream in(path);
+        const nlohmann::json trace = nlohmann::json::parse(in, nullptr, false);
+        if (trace.is_discarded()) return SIZE_MAX;
+
+        size_t events = 0;
+        for (const auto& e : trace["traceEvents"]) events += e["ph"] != "M";
+        return events;
+    }
+}
+
+TEST(CapturesWhileThreadsRecord)
+{
+    TempDir dir;
+    std::atomic<bool> stop{ false };
+    std::vector<std::thread> recorders;
+    for (int t = 0; t < 4; ++t)
+    {
+        recorders.emplace_back([&stop] {
+            Tracer::SetThreadName("recorder");
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                const auto now = Tracer::Clock::now();
+                Tracer::Complete("scope", "test", now, now);
+                Tracer::Instant("tick", "test", 1);
+            }
+        });
+    }
+
+    // Small captures so some cycles overflow and drop events
+    for (int i = 0; i < 20; ++i)
+    {
+        const std::filesystem::path path = dir / (i % 2 ? "a.json" : "b.json");
+        REQUIRE(Tracer::Start(path, 4096));
+        CHECK(Tracer::IsActive());
+        CHECK(!Tracer::Start(path));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        std::atomic<bool> done{ false };
+        size_t written = 0;
+        bool ok = false;
+        REQUIRE(Tracer::Stop([&](const std::filesystem::path&, size_t count, size_t, bool success) {
+            written = count;
+            ok = success;
+            done.store(true, std::memory_order_release);
+        }));
+        CHECK(!Tracer::IsActive());
+        CHECK(!Tracer::Stop());
+
+        while (!done.load(std::memory_order_acquire)) std::this_thread::yield();
+        CHECK(ok);
+        CHECK(written <= 4096);
+        CHECK(CountEvents(path) == written);
+    }
+
+    stop = true;
+    for (std::thread& t : recorders) t.join();
+    Tracer::Shutdown();
+}
@@ -0,0 +1,143 @@
+#include "text_cache.h"
+
+#include <algorithm>
+
+#include "IMGUI/imgui_internal.h"
+
+// ------------------------------------------------------------
+// Layout
+// ------------------------------------------------------------
+
+// Mirrors ImFont::CalcTextSizeA (width) and ImFont::RenderText (glyph placement) for
+// unwrapped text, so a cached run measures and draws exactly like the ImGui calls.
+void BuildTextRun(TextRun& run, ImFont* font, float size, std::string_view text)
+{
+    run.font = font;
+    run.size = size;
+    run.text.assign(text.data(), text.size());
+    run.width = 0.0f;
+    run.glyphs.clear();
+    run.atlasTex = font ? font->ContainerAtlas->TexID : nullptr;
+    run.glyphTable = font ? font->Glyphs.Data : nullptr;
+    run.glyphCount = font ? font->Glyphs.Size : 0;
+
+    if (!font || run.text.empty()) return;
+
+    const float scale = size / font->FontSize;
+    const char* s = run.text.data();
+    const char* end = s + run.text.size();
+
+    float x = 0.0f;
+    float y = 0.0f;
+    float lineWidth = 0.0f;
+    float width = 0.0f;
+
+    while (s < end)
+    {
+        unsigned int c = static_cast<unsigned char>(*s);
+        if (c < 0x80)
+        {
+            s += 1;
+        }
+        else
+        {
+            s += ImTextCharFromUtf8(&c, s, end);
+            if (c == 0) break;   // malformed UTF-8
+        }
+
+        if (c < 32)
+        {
+            if (c == '\n')
+            {
+                width = std::max(width, lineWidth);
+                lineWidth = 0.0f;
+                x = 0.0f;
+                y += size;
+                continue;
+            }
+            if (c == '\r') continue;
+        }
+
+        lineWidth += (static_cast<int>(c) < font->IndexAdvanceX.Size ? font->IndexAdvanceX.Data[c] : font->FallbackAdvanceX) * scale;
+
+        const ImFontGlyph* glyph = font->FindGlyph(static_cast<ImWchar>(c));
+        if (!glyph) continue;
+
+        if (c != ' ' && c != '\t')
+        {
+            run.glyphs.push_back(TextRun::Glyph{ x, y,
+                ImVec2(x + glyph->X0 * scale, y + glyph->Y0 * scale), ImVec2(x + glyph->X1 * scale, y + glyph->Y1 * scale),
+                ImVec2(glyph->U0, glyph->V0), ImVec2(glyph->U1, glyph->V1) });
+        }
+        x += glyph->AdvanceX * scale;
+    }
+
+    // ImGui::CalcTextSize rounding
+    run.width = IM_FLOOR(std::max(width, lineWidth) + 0.95f);
+}
+
+// ------------------------------------------------------------
+// Drawing
+// ------------------------------------------------------------
+
+bool TextRun::MatchesAtlas() const
+{
+    return !font || (font->ContainerAtlas->TexID == atlasTex && font->Glyphs.Data == glyphTable && font->Glyphs.Size == glyphCount);
+}
+
+void DrawTextRun(ImDrawList* dl, const TextRun& run, ImVec2 pos, ImU32 col)
+{
+    if ((col & IM_COL32_A_MASK) == 0 || !run.font || run.glyphs.empty()) return;
+
+    // Pixel aligned, like ImFont::RenderText; the clip rect moves into run space
+    const ImVec2 origin(IM_FLOOR(pos.x + run.font->DisplayOffset.x), IM_FLOOR(pos.y + run.font->DisplayOffset.y));
+    ImVec4 clip = dl->_ClipRectStack.back();
+    clip.x -= origin.x;
+    clip.y -= origin.y;
+    clip.z -= origin.x;
+    clip.w -= origin.y;
+
+    // Horizontally per glyph, vertically per line (as RenderText culls)
+    const auto visible = [&](const TextRun::Glyph& g) {
+        return g.p0.x <= clip.z && g.p1.x >= clip.x && g.y <= clip.w && g.y + run.size >= clip.y;
+    };
+
+    // Reserve exactly what is drawn; a scrolled marquee clips most of a long title
+    const int count = static_cast<int>(std::count_if(run.glyphs.begin(), run.glyphs.end(), visible));
+    if (count == 0) return;
+
+    dl->PrimReserve(count * 6, count * 4);
+    for (const TextRun::Glyph& g : run.glyphs)
+    {
+        if (visible(g))
+            dl->PrimRectUV(ImVec2(origin.x + g.p0.x, origin.y + g.p0.y), ImVec2(origin.x + g.p1.x, origin.y + g.p1.y), g.uv0, g.uv1, col);
+    }
+}
+
+// ------------------------------------------------------------
+// TextRunCache
+// ------------------------------------------------------------
+
+const TextRun& TextRunCache::Get(TextSlot slot, std::string_view text)
+{
+    return Get(slot, text, ImGui::GetFont(), ImGui::GetFontSize());
+}
+
+const TextRun& TextRunCache::Get(TextSlot slot, std::string_view text, ImFont* font, float size)
+{
+    TextRun& run = mRuns[static_cast<size_t>(slot)];
+    if (run.font == font && run.size == size && run.text == text && run.MatchesAtlas())
+    {
+        ++mHits;
+        return run;
+    }
+
+    ++mMisses;
+    BuildTextRun(run, font, size, text);
+    return run;
+}
+
+void TextRunCache::Clear()
+{
+    for (TextRun& run : mRuns) run = TextRun{};
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "IMGUI/imgui.h"
+
+// ------------------------------------------------------------
+// Measured text runs for the overlay's text lines.
+//
+// ImGui::CalcTextSize and ImDrawList::AddText decode the UTF-8 and look up every
+// glyph on each call, although title, artist and album change once per track. A
+// TextRun does that once: it keeps the pen position and the scaled quad of every
+// visible glyph plus the measured width, so drawing only writes quads and the
+// marquee only shifts the run. TextRunCache holds one run per slot and rebuilds it
+// when the text, font or font size (window scale) changes, or when the font atlas
+// was rebuilt under it (any plugin can add fonts).
+// ------------------------------------------------------------
+
+struct TextRun
+{
+    struct Glyph
+    {
+        float x = 0.0f;   // pen position (sum of the advances before it)
+        float y = 0.0f;   // top of its line
+        ImVec2 p0, p1;    // quad relative to the run origin, scaled
+        ImVec2 uv0, uv1;
+    };
+
+    ImFont* font = nullptr;
+    float size = 0.0f;
+    std::string text;
+    float width = 0.0f;           // same as ImGui::CalcTextSize(text).x at this font and size
+    std::vector<Glyph> glyphs;    // visible glyphs only (no blanks, no control characters)
+
+    // Font atlas the quads were taken from
+    ImTextureID atlasTex = nullptr;
+    const ImFontGlyph* glyphTable = nullptr;
+    int glyphCount = 0;
+
+    // False once the atlas was rebuilt (the UVs are stale)
+    bool MatchesAtlas() const;
+};
+
+// Lays out `text` in `font` at `size` (pixels), replacing the contents of `run`
+void BuildTextRun(TextRun& run, ImFont* font, float size, std::string_view text);
+
+// Same quads as ImDrawList::AddText at `pos`, minus the UTF-8 decode and glyph lookup.
+// Glyphs outside the draw list's current clip rect are skipped. The run's font must
+// be the current ImGui font (its atlas texture bound).
+void DrawTextRun(ImDrawList* dl, const TextRun& run, ImVec2 pos, ImU32 col);
+
+enum class TextSlot : uint8_t
+{
+    Title,
+    Artist,
+    Album,
+    TimeLeft,
+    TimeRight,
+    TimeCenter,
+
+    Count
+};
+
+class TextRunCache
+{
+public:
+    // Run of `text` in the current ImGui font and font size
+    const TextRun& Get(TextSlot slot, std::string_view text);
+    const TextRun& Get(TextSlot slot, std::string_view text, ImFont* font, float size);
+
+    // Drops every run (font reload); the next Get rebuilds
+    void Clear();
+
+    uint64_t Hits() const { return mHits; }
+    uint64_t Misses() const { return mMisses; }
+
+private:
+    std::array<TextRun, static_cast<size_t>(TextSlot::Count)> mRuns;
+    uint64_t mHits = 0;
+    uint64_t mMisses = 0;
+};
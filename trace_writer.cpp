@@ -0,0 +1,225 @@
+#include "trace_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char* name;
+		const char* category;
+		int64_t tsNs;     // relative to capture start
+		int64_t durNs;    // -1: instant
+		uint64_t value;
+		uint32_t tid;
+	};
+
+	constexpr size_t kMaxNamedThreads = 32;
+
+	std::atomic<bool> gActive{false};
+	std::atomic<uint32_t> gInFlight{0};
+	std::atomic<size_t> gNext{0};
+
+	std::vector<TraceEvent> gEvents;
+	Tracer::Clock::time_point gStart;
+	std::filesystem::path gOutFile;
+
+	std::atomic<uint32_t> gNextTid{1};
+	std::array<std::atomic<const char*>, kMaxNamedThreads> gThreadNames{};
+
+	// Guards Start/Stop/Shutdown (not the recording path)
+	std::mutex gControlMutex;
+	std::thread gWriter;
+
+	uint32_t LocalTid()
+	{
+		thread_local const uint32_t tid = gNextTid.fetch_add(1, std::memory_order_relaxed);
+		return tid;
+	}
+
+	// Recording side: claim a slot while the capture is active. With Stop() this is a
+	// store-then-load handshake (each side writes one atomic and reads the other); it
+	// needs seq_cst, or a recorder could see the capture active while Stop() sees it
+	// not in flight.
+	TraceEvent* Claim()
+	{
+		gInFlight.fetch_add(1, std::memory_order_seq_cst);
+		if (!gActive.load(std::memory_order_seq_cst))
+		{
+			gInFlight.fetch_sub(1, std::memory_order_release);
+			return nullptr;
+		}
+
+		const size_t index = gNext.fetch_add(1, std::memory_order_relaxed);
+		if (index >= gEvents.size())
+		{
+			gInFlight.fetch_sub(1, std::memory_order_release);
+			return nullptr;
+		}
+
+		return &gEvents[index];
+	}
+
+	void Release()
+	{
+		gInFlight.fetch_sub(1, std::memory_order_release);
+	}
+
+	void AppendEscaped(std::string& out, const char* s)
+	{
+		for (; s && *s; ++s)
+		{
+			const char c = *s;
+			if (c == '"' || c == '\\') { out += '\\'; out += c; }
+			else if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+			else out += c;
+		}
+	}
+
+	bool WriteJson(const std::filesystem::path& path, const std::vector<TraceEvent>& events, size_t count)
+	{
+		std::string out;
+		out.reserve(count * 96 + 4096);
+		out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		char buf[160];
+		bool first = true;
+		auto sep = [&] { if (!first) out += ",\n"; first = false; };
+
+		for (size_t i = 0; i < kMaxNamedThreads; ++i)
+		{
+			const char* name = gThreadNames[i].load(std::memory_order_relaxed);
+			if (!name) continue;
+
+			sep();
+			snprintf(buf, sizeof(buf), "{\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"name\":\"thread_name\",\"args\":{\"name\":\"", i);
+			out += buf;
+			AppendEscaped(out, name);
+			out += "\"}}";
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const TraceEvent& e = events[i];
+			sep();
+
+			out += "{\"name\":\"";
+			AppendEscaped(out, e.name);
+			out += "\",\"cat\":\"";
+			AppendEscaped(out, e.category);
+
+			if (e.durNs >= 0)
+			{
+				snprintf(buf, sizeof(buf), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					e.tid, static_cast<double>(e.tsNs) / 1000.0, static_cast<double>(e.durNs) / 1000.0);
+			}
+			else
+			{
+				snprintf(buf, sizeof(buf), "\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%llu}}",
+					e.tid, static_cast<double>(e.tsNs) / 1000.0, static_cast<unsigned long long>(e.value));
+			}
+			out += buf;
+		}
+
+		out += "\n]}\n";
+
+		std::error_code ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) return false;
+		file.write(out.data(), static_cast<std::streamsize>(out.size()));
+		return static_cast<bool>(file);
+	}
+}
+
+namespace Tracer
+{
+	bool Start(std::filesystem::path outFile, size_t capacity)
+	{
+		std::lock_guard lk(gControlMutex);
+
+		if (gActive.load(std::memory_order_relaxed)) return false;
+		if (gWriter.joinable()) gWriter.join();
+
+		// Preallocate and touch every slot up front so recording never faults in pages
+		gEvents.assign(capacity, TraceEvent{});
+		gNext.store(0, std::memory_order_relaxed);
+		gOutFile = std::move(outFile);
+		gStart = Clock::now();
+
+		gActive.store(true, std::memory_order_release);
+		return true;
+	}
+
+	bool Stop(WrittenCallback onWritten)
+	{
+		std::lock_guard lk(gControlMutex);
+
+		if (!gActive.exchange(false, std::memory_order_seq_cst)) return false;
+
+		// Wait for recorders that claimed a slot before the flag flipped (see Claim)
+		while (gInFlight.load(std::memory_order_seq_cst) != 0)
+			std::this_thread::yield();
+
+		const size_t claimed = gNext.load(std::memory_order_relaxed);
+		const size_t count = std::min(claimed, gEvents.size());
+		const size_t dropped = claimed - count;
+
+		gWriter = std::thread([path = gOutFile, count, dropped, onWritten = std::move(onWritten)]
+		{
+			const bool ok = WriteJson(path, gEvents, count);
+			if (onWritten) onWritten(path, count, dropped, ok);
+		});
+		return true;
+	}
+
+	void Shutdown()
+	{
+		std::lock_guard lk(gControlMutex);
+		gActive.store(false, std::memory_order_seq_cst);
+		while (gInFlight.load(std::memory_order_seq_cst) != 0)
+			std::this_thread::yield();
+		if (gWriter.joinable()) gWriter.join();
+	}
+
+	bool IsActive()
+	{
+		return gActive.load(std::memory_order_relaxed);
+	}
+
+	void SetThreadName(const char* name)
+	{
+		const uint32_t tid = LocalTid();
+		if (tid < kMaxNamedThreads) gThreadNames[tid].store(name, std::memory_order_relaxed);
+	}
+
+	void Complete(const char* name, const char* category, Clock::time_point start, Clock::time_point end)
+	{
+		TraceEvent* e = Claim();
+		if (!e) return;
+
+		using std::chrono::nanoseconds;
+		const int64_t tsNs = std::chrono::duration_cast<nanoseconds>(start - gStart).count();
+		const int64_t durNs = std::chrono::duration_cast<nanoseconds>(end - start).count();
+
+		*e = TraceEvent{ name, category, std::max<int64_t>(0, tsNs), std::max<int64_t>(0, durNs), 0, LocalTid() };
+		Release();
+	}
+
+	void Instant(const char* name, const char* category, uint64_t value)
+	{
+		TraceEvent* e = Claim();
+		if (!e) return;
+
+		*e = TraceEvent{ name, category, std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - gStart).count(), -1, value, LocalTid() };
+		Release();
+	}
+}
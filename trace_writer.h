@@ -0,0 +1,46 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+// ------------------------------------------------------------
+// Chrome trace-event capture (chrome://tracing, Perfetto)
+//
+// Start() preallocates a fixed event buffer; recording claims a slot with one
+// atomic increment and never allocates, locks or touches the disk. Stop() hands
+// the buffer to a background thread that writes the JSON file.
+//
+// Event names/categories must be string literals (only the pointer is stored).
+// ------------------------------------------------------------
+
+namespace Tracer
+{
+    using Clock = std::chrono::steady_clock;
+
+    inline constexpr size_t kDefaultCapacity = 1u << 19;
+
+    // Returns false if a capture is already running or the previous file is still being written.
+    bool Start(std::filesystem::path outFile, size_t capacity = kDefaultCapacity);
+
+    // Stops capturing and writes the file in the background. `onWritten` runs on the
+    // writer thread with (path, eventsWritten, eventsDropped, ok).
+    using WrittenCallback = std::function<void(const std::filesystem::path&, size_t, size_t, bool)>;
+    bool Stop(WrittenCallback onWritten = {});
+
+    // Joins a pending write (plugin unload)
+    void Shutdown();
+
+    bool IsActive();
+
+    // Names the calling thread in the trace
+    void SetThreadName(const char* name);
+
+    // "X" event
+    void Complete(const char* name, const char* category, Clock::time_point start, Clock::time_point end);
+
+    // "i" event with one numeric argument
+    void Instant(const char* name, const char* category, uint64_t value = 0);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// Compact track identity: FNV-1a 64 over "title\nartist\nalbum".
+// Computed once per metadata change by the media worker; everything downstream
+// (art cache, position anchoring) compares the integer.
+using TrackId = uint64_t;
+
+inline constexpr TrackId kNoTrack = 0;
+
+inline constexpr uint64_t kFnv1a64Offset = 14695981039346656037ull;
+inline constexpr uint64_t kFnv1a64Prime  = 1099511628211ull;
+
+constexpr uint64_t Fnv1a64Append(uint64_t h, std::string_view s) noexcept
+{
+    for (unsigned char c : s)
+    {
+        h ^= static_cast<uint64_t>(c);
+        h *= kFnv1a64Prime;
+    }
+    return h;
+}
+
+constexpr uint64_t Fnv1a64(std::string_view s) noexcept
+{
+    return Fnv1a64Append(kFnv1a64Offset, s);
+}
+
+// Streams the fields through the hash without building a combined string.
+// Same value as Fnv1a64(title + '\n' + artist + '\n' + album), which keeps
+// existing album_cache file names valid.
+constexpr TrackId ComputeTrackId(std::string_view title, std::string_view artist, std::string_view album) noexcept
+{
+    if (title.empty() && artist.empty() && album.empty()) return kNoTrack;
+
+    uint64_t h = Fnv1a64Append(kFnv1a64Offset, title);
+    h = Fnv1a64Append(h, "\n");
+    h = Fnv1a64Append(h, artist);
+    h = Fnv1a64Append(h, "\n");
+    h = Fnv1a64Append(h, album);
+    return h == kNoTrack ? 1 : h;
+}
+
+// Album-level art key: FNV-1a 64 over "artist\nalbum". kNoTrack when the album is
+// unknown, so singles never share art by accident.
+constexpr uint64_t ComputeAlbumKey(std::string_view artist, std::string_view album) noexcept
+{
+    if (album.empty()) return kNoTrack;
+
+    uint64_t h = Fnv1a64Append(kFnv1a64Offset, artist);
+    h = Fnv1a64Append(h, "\n");
+    h = Fnv1a64Append(h, album);
+    return h == kNoTrack ? 1 : h;
+}
+
+inline std::string TrackIdToHex(TrackId id)
+{
+    char buf[17]{};
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(id));
+    return std::string(buf);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Single-producer / single-consumer triple buffer.
+// The writer fills WriteBuffer() and calls Publish(); the reader calls Acquire() and
+// then reads ReadBuffer(). Neither side ever blocks or waits on the other, and a
+// buffer is never touched by both threads at the same time.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer thread
+    T& WriteBuffer() noexcept { return buffers_[writeIndex_]; }
+
+    void Publish() noexcept
+    {
+        const uint8_t prev = shared_.exchange(static_cast<uint8_t>(writeIndex_ | kFreshBit), std::memory_order_acq_rel);
+        writeIndex_ = static_cast<uint8_t>(prev & kIndexMask);
+    }
+
+    // Reader thread: swaps in the newest published buffer. Returns false (and does
+    // nothing) when nothing was published since the last call.
+    bool Acquire() noexcept
+    {
+        if ((shared_.load(std::memory_order_relaxed) & kFreshBit) == 0) return false;
+
+        const uint8_t prev = shared_.exchange(readIndex_, std::memory_order_acq_rel);
+        readIndex_ = static_cast<uint8_t>(prev & kIndexMask);
+        return true;
+    }
+
+    const T& ReadBuffer() const noexcept { return buffers_[readIndex_]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFreshBit  = 0x4;
+
+    T buffers_[3]{};
+    std::atomic<uint8_t> shared_{1};   // index of the middle buffer (+ fresh bit)
+    uint8_t writeIndex_ = 0;           // writer-owned
+    uint8_t readIndex_  = 2;           // reader-owned
+};
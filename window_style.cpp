@@ -0,0 +1,163 @@
+#include "window_style.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include <nlohmann/json.hpp>
+
+// ------------------------------------------------------------
+// Helpers
+// ------------------------------------------------------------
+
+static nlohmann::json ImVec4ToJson(const ImVec4& c)
+{
+    return nlohmann::json::array({ c.x, c.y, c.z, c.w });
+}
+
+static bool JsonToImVec4(const nlohmann::json& j, ImVec4& out)
+{
+    if (!j.is_array() || j.size() != 4) return false;
+    for (int i = 0; i < 4; ++i)
+        if (!j[i].is_number()) return false;
+
+    out.x = j[0].get<float>();
+    out.y = j[1].get<float>();
+    out.z = j[2].get<float>();
+    out.w = j[3].get<float>();
+    return true;
+}
+
+template <typename T>
+static void AssignIfNumberOrBool(const nlohmann::json& obj, const char* key, T& target)
+{
+    auto it = obj.find(key);
+    if (it == obj.end()) return;
+
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        if (it->is_boolean()) target = it->get<bool>();
+    }
+    else
+    {
+        if (it->is_number())
+        {
+            const double v = it->get<double>();
+            target = static_cast<T>(v);
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// JSON (WindowStyle)
+// ------------------------------------------------------------
+
+void to_json(nlohmann::json& j, const WindowStyle& s)
+{
+    j = nlohmann::json{
+        {"background_color", ImVec4ToJson(s.backgroundColor)},
+        {"accent_color",     ImVec4ToJson(s.accentColor)},
+        {"accent_color2",    ImVec4ToJson(s.accentColor2)},
+        {"accent_from_album_art", s.accentFromAlbumArt},
+        {"text_color",       ImVec4ToJson(s.textColor)},
+        {"text_color_dim",   ImVec4ToJson(s.textColorDim)},
+        {"text_color_faint", ImVec4ToJson(s.textColorFaint)},
+
+        {"window_rounding",       s.windowRounding},
+        {"album_art_rounding",    s.albumArtRounding},
+        {"progress_bar_height",   s.progressBarHeight},
+        {"progress_bar_rounding", s.progressBarRounding},
+        {"album_art_size",        s.albumArtSize},
+        {"album_art_fade_sec",    s.albumArtFadeSec},
+
+        {"enable_pulse",     s.enablePulse},
+        {"show_album_art",   s.showAlbumArt},
+        {"show_progress_bar",s.showProgressBar},
+        {"show_album_info",  s.showAlbumInfo},
+        {"album_art_backdrop", s.albumArtBackdrop},
+        {"window_opacity",   s.windowOpacity},
+
+        {"ui_scale",            s.uiScale},
+        {"enable_auto_scaling", s.enableAutoScaling},
+        {"min_scale",           s.minScale},
+        {"max_scale",           s.maxScale},
+
+        {"enable_marquee",   s.enableMarquee},
+        {"marquee_speed_px", s.marqueeSpeedPx},
+        {"marquee_wait_sec", s.marqueeWaitSec},
+        {"time_display_mode", static_cast<int>(s.timeDisplayMode)},
+
+    };
+}
+
+void from_json(const nlohmann::json& j, WindowStyle& s)
+{
+    const WindowStyle def{};
+    s = def;
+
+    if (!j.is_object()) return;
+
+    auto loadColor = [&](const char* key, ImVec4& target, const ImVec4& fallback)
+    {
+        auto it = j.find(key);
+        if (it == j.end()) { target = fallback; return; }
+        ImVec4 tmp;
+        if (JsonToImVec4(*it, tmp)) target = tmp;
+        else target = fallback;
+    };
+
+    loadColor("background_color", s.backgroundColor, def.backgroundColor);
+    loadColor("accent_color",     s.accentColor,     def.accentColor);
+    loadColor("accent_color2",    s.accentColor2,    def.accentColor2);
+    loadColor("text_color",       s.textColor,       def.textColor);
+    loadColor("text_color_dim",   s.textColorDim,    def.textColorDim);
+    loadColor("text_color_faint", s.textColorFaint,  def.textColorFaint);
+
+    int tdm = static_cast<int>(def.timeDisplayMode);
+    tdm = std::clamp(tdm, 0, 1);
+
+    AssignIfNumberOrBool(j, "accent_from_album_art", s.accentFromAlbumArt);
+
+    AssignIfNumberOrBool(j, "window_rounding",       s.windowRounding);
+    AssignIfNumberOrBool(j, "album_art_rounding",    s.albumArtRounding);
+    AssignIfNumberOrBool(j, "progress_bar_height",   s.progressBarHeight);
+    AssignIfNumberOrBool(j, "progress_bar_rounding", s.progressBarRounding);
+    AssignIfNumberOrBool(j, "album_art_size",        s.albumArtSize);
+    AssignIfNumberOrBool(j, "album_art_fade_sec",    s.albumArtFadeSec);
+
+    AssignIfNumberOrBool(j, "enable_pulse",          s.enablePulse);
+    AssignIfNumberOrBool(j, "show_album_art",        s.showAlbumArt);
+    AssignIfNumberOrBool(j, "show_progress_bar",     s.showProgressBar);
+    AssignIfNumberOrBool(j, "show_album_info",       s.showAlbumInfo);
+    AssignIfNumberOrBool(j, "album_art_backdrop",    s.albumArtBackdrop);
+    AssignIfNumberOrBool(j, "window_opacity",        s.windowOpacity);
+
+    AssignIfNumberOrBool(j, "ui_scale",              s.uiScale);
+    AssignIfNumberOrBool(j, "enable_auto_scaling",   s.enableAutoScaling);
+    AssignIfNumberOrBool(j, "min_scale",             s.minScale);
+    AssignIfNumberOrBool(j, "max_scale",             s.maxScale);
+
+    AssignIfNumberOrBool(j, "enable_marquee",   s.enableMarquee);
+    AssignIfNumberOrBool(j, "marquee_speed_px", s.marqueeSpeedPx);
+    AssignIfNumberOrBool(j, "marquee_wait_sec", s.marqueeWaitSec);
+    AssignIfNumberOrBool(j, "time_display_mode", tdm);
+
+    auto clampf = [](float v, float lo, float hi) { return v < lo ? lo : v > hi ? hi : v; };
+
+    s.windowOpacity = clampf(s.windowOpacity, 0.0f, 1.0f);
+
+    s.uiScale   = clampf(s.uiScale, 0.5f, 2.0f);
+    s.minScale  = clampf(s.minScale, 0.1f, 10.0f);
+    s.maxScale  = clampf(s.maxScale, 0.1f, 10.0f);
+    if (s.minScale > s.maxScale) std::swap(s.minScale, s.maxScale);
+
+    s.windowRounding      = clampf(s.windowRounding, 0.0f, 50.0f);
+    s.albumArtRounding    = clampf(s.albumArtRounding, 0.0f, 50.0f);
+    s.progressBarHeight   = clampf(s.progressBarHeight, 0.0f, 50.0f);
+    s.progressBarRounding = clampf(s.progressBarRounding, 0.0f, 50.0f);
+    s.albumArtSize        = clampf(s.albumArtSize, 16.0f, 512.0f);
+    s.albumArtFadeSec     = clampf(s.albumArtFadeSec, 0.0f, 3.0f);
+
+    s.marqueeSpeedPx = clampf(s.marqueeSpeedPx, 0.0f, 1000.0f);
+    s.marqueeWaitSec = clampf(s.marqueeWaitSec, 0.0f, 10.0f);
+    s.timeDisplayMode = static_cast<WindowStyle::TimeDisplayMode>(tdm);
+}
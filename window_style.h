@@ -0,0 +1,58 @@
+#pragma once
+#include <nlohmann/json_fwd.hpp>
+
+#include "IMGUI/imgui.h"
+
+// Range of the "Album Art Size" slider (px before scaling)
+inline constexpr float kAlbumArtSizeMin = 80.0f;
+inline constexpr float kAlbumArtSizeMax = 150.0f;
+
+// ---------------------------
+// Configurable style/settings
+// ---------------------------
+struct WindowStyle
+{
+    ImVec4 backgroundColor = ImVec4(0.0f, 0.0f, 0.0f, 1.0f);
+    ImVec4 accentColor     = ImVec4(0.0f, 0.9884f, 1.0f, 1.0f);
+    ImVec4 accentColor2    = ImVec4(0.2f, 0.68f, 1.0f, 1.0f);
+    bool   accentFromAlbumArt = false;   // accents follow the current cover's palette when it has one
+    ImVec4 textColor       = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+    ImVec4 textColorDim    = ImVec4(0.75f, 0.75f, 0.75f, 1.0f);
+    ImVec4 textColorFaint  = ImVec4(0.55f, 0.55f, 0.55f, 1.0f);
+
+    float windowRounding      = 5.0f;
+    float albumArtRounding    = 14.0f;
+    float progressBarHeight   = 8.0f;
+    float progressBarRounding = 4.0f;
+    float albumArtSize        = 118.0f;
+    float albumArtFadeSec     = 0.35f;   // crossfade between covers, 0 = cut
+
+    bool  enablePulse      = true;
+    bool  showAlbumArt     = true;
+    bool  showProgressBar  = true;
+    bool  showAlbumInfo    = true;
+    bool  albumArtBackdrop = false;   // blurred cover instead of backgroundColor
+    float windowOpacity    = 1.0f;
+
+    // Scaling
+    float uiScale           = 1.0f;
+    bool  enableAutoScaling = false;
+    float minScale          = 0.8f;
+    float maxScale          = 2.0f;
+
+    // Marquee
+    bool  enableMarquee     = true;
+    float marqueeSpeedPx    = 40.0f;
+    float marqueeWaitSec    = 0.80f;
+
+    enum class TimeDisplayMode : int
+    {
+        CenterSlash = 0,    // "0:10 / 3:45" centered
+        Corners = 1         // "0:10" left, "3:45" right
+    };
+
+    TimeDisplayMode timeDisplayMode = TimeDisplayMode::Corners;
+};
+
+void to_json(nlohmann::json& j, const WindowStyle& s);
+void from_json(const nlohmann::json& j, WindowStyle& s);